@@ -0,0 +1,591 @@
+/*  Description:
+ *      Implementation of the benchmark. The in-memory phases are repeated
+ *      'iterations' times to get stable numbers on small archives, the
+ *      file_write phase runs once on the decoded files.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Bench.h"
+#include "DTAFormat.h"
+#include "Container.h"
+#include "CipherCheck.h"
+#include "NativeCheck.h"
+#include "CacheCheck.h"
+#include "DecodeCheck.h"
+#include "Decode.h"
+
+/*
+ * Location of an entry inside the archive, collected by the entry_parse phase.
+ */
+typedef struct t_benchentry {
+    DWORD           nameOffset;
+    unsigned char   nameLength;
+    DWORD           dataOffset;
+    DWORD           fileSize;
+    DWORD           numOfBlocks;
+    BOOL            encrypted;
+} BENCH_ENTRY;
+
+/*----------------------------------------------------------------------------
+ * Main entry point. Returns 0 upon success, -1 otherwise and a message is
+ * printed to stderr.
+ *--------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+    BENCH_OPTIONS   options;
+    char            error[ERROR_LENGTH];
+    HANDLE          hFile;
+    LARGE_INTEGER   fileSize;
+    char            *archive;
+    DWORD           read;
+    BOOL            result;
+
+    if(!ParseBenchOptions(&options, argc, argv)) {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+
+    if(options.checkKernels) {
+        if(!CheckCipherKernels(error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    if(options.checkTrials > 0) {
+        if(!CheckCipher(options.checkTrials, options.gen.seed, error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        printf("cipher_check,%u,ok\n", options.checkTrials);
+        return 0;
+    }
+
+    if(options.checkDecode) {
+        if(!CheckDecoder(error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        printf("decode_check,%u,ok\n", CHECK_DECODE_FIXTURES);
+        return 0;
+    }
+
+    if(options.checkNative) {
+        if(options.archive[0] == '\0')
+            strncpy_s(options.archive, sizeof(options.archive), "bench.dta", sizeof(options.archive));
+
+        if(!CheckNativeReader(options.archive, &options.gen, error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        printf("native_check,%u,ok\n", options.gen.numOfFiles);
+        return 0;
+    }
+
+    if(options.cacheTrials > 0) {
+        if(options.archive[0] == '\0')
+            strncpy_s(options.archive, sizeof(options.archive), "bench.dta", sizeof(options.archive));
+
+        if(!CheckBlockCache(options.archive, &options.gen, options.cacheTrials, error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        printf("cache_check,%u,ok\n", options.cacheTrials);
+        return 0;
+    }
+
+    if(options.archive[0] == '\0' || options.generateOnly) {
+        if(options.archive[0] == '\0')
+            strncpy_s(options.archive, sizeof(options.archive), "bench.dta", sizeof(options.archive));
+
+        if(!GenerateArchive(options.archive, &options.gen, error)) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+    }
+
+    if(options.generateOnly)
+        return 0;
+
+    /* Load the whole archive, so that only the phases themselves are measured */
+    hFile = CreateFile(options.archive, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart > 0xFFFFFFFF) {
+        fprintf(stderr, "Error occured: Could not open %s\nExiting...\n", options.archive);
+        return -1;
+    }
+
+    if((archive = (char *)malloc((size_t)fileSize.QuadPart + 1)) == NULL ||
+       !ReadFile(hFile, archive, (DWORD)fileSize.QuadPart, &read, NULL) || read != (DWORD)fileSize.QuadPart) {
+        fprintf(stderr, "Error occured: Could not read %s\nExiting...\n", options.archive);
+        CloseHandle(hFile);
+        free(archive);
+        return -1;
+    }
+
+    CloseHandle(hFile);
+
+    result = RunBenchmark(&options, archive, (DWORD)fileSize.QuadPart, error);
+    free(archive);
+
+    if(!result) {
+        fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Prints program usage to stderr.
+ *
+ *  Arguments:          name            Program name
+ *--------------------------------------------------------------------------*/
+void PrintUsage(char *name) {
+    fprintf(stderr, "\nUsage: %s [OPTIONS]\n", name);
+    fprintf(stderr, "Generates a synthetic ISD0 archive and times each extraction phase.\n\n");
+    fprintf(stderr, "-n COUNT\tNumber of files (10000)\n");
+    fprintf(stderr, "-min BYTES\tSmallest file size (0)\n");
+    fprintf(stderr, "-max BYTES\tLargest file size (262144)\n");
+    fprintf(stderr, "-dist NAME\tSize distribution: fixed, uniform or log (log)\n");
+    fprintf(stderr, "-depth N\tMaximum number of directories in a path (3)\n");
+    fprintf(stderr, "-dirs N\t\tDirectory names per level (8)\n");
+    fprintf(stderr, "-k1 KEY\t\tFirst key in hex (0x8D2965CA)\n");
+    fprintf(stderr, "-k2 KEY\t\tSecond key in hex (0x4FE85106)\n");
+    fprintf(stderr, "-seed N\t\tRandom seed (1)\n");
+    fprintf(stderr, "-i N\t\tRepetitions of the in-memory phases (5)\n");
+    fprintf(stderr, "-a FILE\t\tBenchmark an existing archive instead of generating one\n");
+    fprintf(stderr, "-g FILE\t\tOnly generate an archive and exit\n");
+    fprintf(stderr, "-o DIR\t\tOutput directory of the file_write phase (bench_out)\n");
+    fprintf(stderr, "-nowrite\tSkip the file_write phase\n");
+    fprintf(stderr, "-check N\tDecrypt N random buffers in pieces and compare them, then exit\n");
+    fprintf(stderr, "-native\t\tGenerate an archive, read every file back through the native backend, then exit\n");
+    fprintf(stderr, "-cache N\tGenerate an archive, compare N random range reads through the block cache, then exit\n");
+    fprintf(stderr, "-decode\t\tDecode the fixture archive and compare it to what the game returns, then exit\n");
+    fprintf(stderr, "-kernels\tCheck every kernel at every length up to %d and alignment, then exit\n", CHECK_KERNEL_LENGTH);
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the command line into 'options'. Returns FALSE if an argument is
+ * unknown or missing its value.
+ *
+ *  Arguments:          options         Options to fill
+ *                      argc            Argument count
+ *                      argv            Arguments
+ *--------------------------------------------------------------------------*/
+BOOL ParseBenchOptions(BENCH_OPTIONS *options, int argc, char *argv[]) {
+    int i;
+
+    memset(options, 0, sizeof(BENCH_OPTIONS));
+    DefaultGenOptions(&options->gen);
+    strncpy_s(options->outputDir, sizeof(options->outputDir), "bench_out", sizeof(options->outputDir));
+    options->iterations = 5;
+
+    for(i = 1; i < argc; ++i) {
+        char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if(strcmp(argv[i], "-nowrite") == 0) {
+            options->skipWrite = TRUE;
+            continue;
+        }
+
+        if(strcmp(argv[i], "-kernels") == 0) {
+            options->checkKernels = TRUE;
+            continue;
+        }
+
+        if(strcmp(argv[i], "-native") == 0) {
+            options->checkNative = TRUE;
+            continue;
+        }
+
+        if(strcmp(argv[i], "-decode") == 0) {
+            options->checkDecode = TRUE;
+            continue;
+        }
+
+        /* Everything else takes a value */
+        if(value == NULL)
+            return FALSE;
+
+        if(strcmp(argv[i], "-n") == 0)
+            options->gen.numOfFiles = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-min") == 0)
+            options->gen.minSize = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-max") == 0)
+            options->gen.maxSize = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-depth") == 0)
+            options->gen.pathDepth = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-dirs") == 0)
+            options->gen.dirsPerLevel = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-k1") == 0)
+            options->gen.key1 = strtoul(value, NULL, 16);
+        else if(strcmp(argv[i], "-k2") == 0)
+            options->gen.key2 = strtoul(value, NULL, 16);
+        else if(strcmp(argv[i], "-seed") == 0)
+            options->gen.seed = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-check") == 0)
+            options->checkTrials = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-cache") == 0)
+            options->cacheTrials = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-i") == 0)
+            options->iterations = strtoul(value, NULL, 10);
+        else if(strcmp(argv[i], "-a") == 0)
+            strncpy_s(options->archive, sizeof(options->archive), value, sizeof(options->archive));
+        else if(strcmp(argv[i], "-o") == 0)
+            strncpy_s(options->outputDir, sizeof(options->outputDir), value, sizeof(options->outputDir));
+        else if(strcmp(argv[i], "-g") == 0) {
+            strncpy_s(options->archive, sizeof(options->archive), value, sizeof(options->archive));
+            options->generateOnly = TRUE;
+        } else if(strcmp(argv[i], "-dist") == 0) {
+            if(strcmp(value, "fixed") == 0)
+                options->gen.sizeDistribution = GEN_SIZE_FIXED;
+            else if(strcmp(value, "uniform") == 0)
+                options->gen.sizeDistribution = GEN_SIZE_UNIFORM;
+            else if(strcmp(value, "log") == 0)
+                options->gen.sizeDistribution = GEN_SIZE_LOG;
+            else
+                return FALSE;
+        } else
+            return FALSE;
+
+        ++i;
+    }
+
+    /* An existing archive can't be generated over */
+    if(options->generateOnly && options->archive[0] == '\0')
+        return FALSE;
+
+    /* The round trip and the cache check always generate their archive, so they can't take an existing one */
+    if((options->checkNative || options->cacheTrials > 0) && options->archive[0] != '\0' && !options->generateOnly)
+        return FALSE;
+
+    if(options->iterations == 0)
+        options->iterations = 1;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the number of seconds since 'start'.
+ *--------------------------------------------------------------------------*/
+static double Elapsed(LARGE_INTEGER start) {
+    LARGE_INTEGER now;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+
+    return (double)(now.QuadPart - start.QuadPart) / (double)frequency.QuadPart;
+}
+
+/*----------------------------------------------------------------------------
+ * Prints a single CSV row.
+ *--------------------------------------------------------------------------*/
+static void PrintResult(const BENCH_RESULT *result) {
+    double seconds = result->seconds > 0.0 ? result->seconds : 1e-9;
+
+    printf("%s,%u,%I64u,%.6f,%.2f,%.0f\n", result->phase, result->entries, result->bytes, result->seconds,
+           (double)(__int64)result->bytes / (1024.0 * 1024.0) / seconds, result->entries / seconds);
+}
+
+/*----------------------------------------------------------------------------
+ * Decrypts the blocks of 'entry' in place, the block headers are not
+ * encrypted. Returns the number of stored bytes, a block that runs past the
+ * end of the archive ends the walk.
+ *--------------------------------------------------------------------------*/
+static DWORD DecryptBlocks(char *work, DWORD size, const BENCH_ENTRY *entry, unsigned int key1, unsigned int key2) {
+    DWORD   pos     = entry->dataOffset;
+    DWORD   bytes   = 0;
+    DWORD   block;
+
+    for(block = 0; block < entry->numOfBlocks; ++block) {
+        DTA_BLOCK_HEADER blockHeader;
+
+        if(pos > size || size - pos < sizeof(DTA_BLOCK_HEADER))
+            break;
+
+        memcpy(&blockHeader, work + pos, sizeof(DTA_BLOCK_HEADER));
+        pos += sizeof(DTA_BLOCK_HEADER);
+
+        if(size - pos < blockHeader.storedSize)
+            break;
+
+        if(entry->encrypted)
+            Decrypt((void *)(work + pos), blockHeader.storedSize, key1, key2);
+        else if(block == 0)
+            UnmaskWavHeader((unsigned char *)work + pos, blockHeader.storedSize, key1, key2);
+
+        pos += blockHeader.storedSize;
+        bytes += blockHeader.storedSize;
+    }
+
+    return bytes;
+}
+
+/*----------------------------------------------------------------------------
+ * Decodes the blocks of 'entry', already decrypted by DecryptBlocks, into
+ * 'out', which holds the file size. Returns the number of bytes decoded, a
+ * corrupt block ends the walk.
+ *--------------------------------------------------------------------------*/
+static DWORD DecodeBlocks(const char *work, DWORD size, const BENCH_ENTRY *entry, unsigned char *out) {
+    const unsigned char *wavHeader  = NULL;
+    DWORD               pos         = entry->dataOffset;
+    DWORD               decoded     = 0;
+    DWORD               block;
+
+    for(block = 0; block < entry->numOfBlocks && decoded < entry->fileSize; ++block) {
+        DTA_BLOCK_HEADER    blockHeader;
+        const unsigned char *stored;
+        DWORD               n;
+
+        if(pos > size || size - pos < sizeof(DTA_BLOCK_HEADER))
+            break;
+
+        memcpy(&blockHeader, work + pos, sizeof(DTA_BLOCK_HEADER));
+        pos += sizeof(DTA_BLOCK_HEADER);
+
+        if(size - pos < blockHeader.storedSize)
+            break;
+
+        stored = (const unsigned char *)work + pos;
+
+        if(block == 0 && blockHeader.storedSize >= 1 + DTA_WAV_HEADER_SIZE && stored[0] >= DTA_BLOCK_AUDIO)
+            wavHeader = stored + 1;
+
+        if(!DecodeBlock(stored, blockHeader.storedSize, wavHeader, out + decoded, entry->fileSize - decoded, &n))
+            break;
+
+        pos += blockHeader.storedSize;
+        decoded += n;
+    }
+
+    return decoded;
+}
+
+/*----------------------------------------------------------------------------
+ * Runs every phase on the archive in 'archive' and prints the results. If
+ * any errors occur, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          options         Benchmark settings
+ *                      archive         Contents of the whole archive
+ *                      size            Size of the archive
+ *                      error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL RunBenchmark(const BENCH_OPTIONS *options, const char *archive, DWORD size, char error[ERROR_LENGTH]) {
+    unsigned int        key1    = options->gen.key1;
+    unsigned int        key2    = options->gen.key2;
+    DTA_HEADER          header;
+    DTA_CONTENT_HEADER  *contentHeaders;
+    BENCH_ENTRY         *entries;
+    BENCH_RESULT        result;
+    BUF_CONTAINER       buffer;
+    DIR_CACHE           dirs;
+    LARGE_INTEGER       start;
+    char                *work;
+    unsigned char       *decoded;
+    DWORD               largestFile = 0;
+    DWORD               numOfEntries = 0;
+    DWORD               it;
+    DWORD               i;
+
+    if(size < sizeof(int) + sizeof(DTA_HEADER) || *(const int *)archive != TRUE_DTA_IDENTIFIER) {
+        strncpy_s(error, ERROR_LENGTH, "File did not begin with \"ISD0\"", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    memcpy(&header, archive + sizeof(int), sizeof(DTA_HEADER));
+    Decrypt((void *)&header, sizeof(DTA_HEADER), key1, key2);
+
+    if(header.contentOffset > size ||
+       header.numOfFiles > (size - header.contentOffset) / sizeof(DTA_CONTENT_HEADER)) {
+        strncpy_s(error, ERROR_LENGTH, "The content table lies outside of the archive, are the keys right?", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    contentHeaders  = (DTA_CONTENT_HEADER *)malloc(sizeof(DTA_CONTENT_HEADER) * header.numOfFiles + 1);
+    entries         = (BENCH_ENTRY *)malloc(sizeof(BENCH_ENTRY) * header.numOfFiles + 1);
+    work            = (char *)malloc(size);
+
+    if(contentHeaders == NULL || entries == NULL || work == NULL || !InitBuffer(&buffer, 1024)) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the benchmark", ERROR_LENGTH);
+        free(contentHeaders);
+        free(entries);
+        free(work);
+        return FALSE;
+    }
+
+    printf("# decrypt_kernel=%s archive_bytes=%u entries=%u iterations=%u\n",
+           GetDecryptKernelName(), size, header.numOfFiles, options->iterations);
+    printf("phase,entries,bytes,seconds,mb_per_s,entries_per_s\n");
+
+    /* header_decrypt */
+    QueryPerformanceCounter(&start);
+
+    for(it = 0; it < options->iterations; ++it) {
+        memcpy(&header, archive + sizeof(int), sizeof(DTA_HEADER));
+        Decrypt((void *)&header, sizeof(DTA_HEADER), key1, key2);
+
+        memcpy(contentHeaders, archive + header.contentOffset, sizeof(DTA_CONTENT_HEADER) * header.numOfFiles);
+        Decrypt((void *)contentHeaders, sizeof(DTA_CONTENT_HEADER) * header.numOfFiles, key1, key2);
+    }
+
+    result.phase    = "header_decrypt";
+    result.seconds  = Elapsed(start);
+    result.entries  = header.numOfFiles * options->iterations;
+    result.bytes    = (unsigned __int64)(sizeof(DTA_HEADER) + sizeof(DTA_CONTENT_HEADER) * header.numOfFiles) * options->iterations;
+    PrintResult(&result);
+
+    /* entry_parse */
+    result.bytes = 0;
+    QueryPerformanceCounter(&start);
+
+    for(it = 0; it < options->iterations; ++it) {
+        numOfEntries = 0;
+
+        for(i = 0; i < header.numOfFiles; ++i) {
+            DTA_FILE_HEADER fileHeader;
+            char            filename[256 + 1];
+            DWORD           pos = contentHeaders[i].fileOffset;
+            DWORD           nameLength;
+
+            if(pos > size || size - pos < sizeof(DTA_FILE_HEADER))
+                continue;
+
+            memcpy(&fileHeader, archive + pos, sizeof(DTA_FILE_HEADER));
+            Decrypt((void *)&fileHeader, sizeof(DTA_FILE_HEADER), key1, key2);
+            pos += sizeof(DTA_FILE_HEADER);
+
+            nameLength = DTA_FILENAME_LENGTH(&fileHeader);
+
+            /* The stored size of the blocks is only known while walking them, see DecryptBlocks */
+            if(nameLength >= sizeof(filename) || size - pos < nameLength)
+                continue;
+
+            memcpy(filename, archive + pos, nameLength);
+            Decrypt((void *)filename, nameLength, key1, key2);
+
+            entries[numOfEntries].nameOffset    = pos;
+            entries[numOfEntries].nameLength    = (unsigned char)nameLength;
+            entries[numOfEntries].dataOffset    = pos + nameLength;
+            entries[numOfEntries].fileSize      = fileHeader.fileSize;
+            entries[numOfEntries].numOfBlocks   = fileHeader.numOfBlocks;
+            entries[numOfEntries].encrypted     = (fileHeader.filenameLength & DTA_FILE_ENCRYPTED) != 0;
+            ++numOfEntries;
+
+            result.bytes += sizeof(DTA_FILE_HEADER) + nameLength;
+        }
+    }
+
+    result.phase    = "entry_parse";
+    result.seconds  = Elapsed(start);
+    result.entries  = numOfEntries * options->iterations;
+    PrintResult(&result);
+
+    /* payload_decrypt, in place on a copy of the archive */
+    memcpy(work, archive, size);
+    result.bytes = 0;
+    QueryPerformanceCounter(&start);
+
+    for(it = 0; it < options->iterations; ++it) {
+        for(i = 0; i < numOfEntries; ++i)
+            result.bytes += DecryptBlocks(work, size, &entries[i], key1, key2);
+    }
+
+    result.phase    = "payload_decrypt";
+    result.seconds  = Elapsed(start);
+    result.entries  = numOfEntries * options->iterations;
+    PrintResult(&result);
+
+    /* payload_decode, on a copy that is decrypted exactly once */
+    memcpy(work, archive, size);
+
+    for(i = 0; i < numOfEntries; ++i) {
+        DecryptBlocks(work, size, &entries[i], key1, key2);
+        largestFile = max(largestFile, entries[i].fileSize);
+    }
+
+    if((decoded = (unsigned char *)malloc(largestFile + 1)) == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the benchmark", ERROR_LENGTH);
+        ReleaseBuffer(&buffer);
+        free(contentHeaders);
+        free(entries);
+        free(work);
+        return FALSE;
+    }
+
+    result.bytes = 0;
+    QueryPerformanceCounter(&start);
+
+    for(it = 0; it < options->iterations; ++it) {
+        for(i = 0; i < numOfEntries; ++i)
+            result.bytes += DecodeBlocks(work, size, &entries[i], decoded);
+    }
+
+    result.phase    = "payload_decode";
+    result.seconds  = Elapsed(start);
+    result.entries  = numOfEntries * options->iterations;
+    PrintResult(&result);
+
+    /* file_write, only the WriteToFile() calls are timed */
+    if(!options->skipWrite && !InitDirCache(&dirs)) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for the directory cache failed", ERROR_LENGTH);
+        i = 0;
+    } else if(!options->skipWrite) {
+        CreateDirectory(options->outputDir, NULL);
+
+        result.bytes    = 0;
+        result.seconds  = 0.0;
+
+        for(i = 0; i < numOfEntries; ++i) {
+            char    filename[256 + 1];
+            int     length;
+            DWORD   fileSize;
+
+            length = _snprintf(filename, sizeof(filename) - 1, "%s\\", options->outputDir);
+
+            if(length < 0 || length + entries[i].nameLength >= (int)sizeof(filename))
+                continue;
+
+            memcpy(filename + length, archive + entries[i].nameOffset, entries[i].nameLength);
+            Decrypt((void *)(filename + length), entries[i].nameLength, key1, key2);
+            filename[length + entries[i].nameLength] = '\0';
+
+            if(!ReserveBuffer(&buffer, entries[i].fileSize)) {
+                strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+                break;
+            }
+
+            fileSize = DecodeBlocks(work, size, &entries[i], (unsigned char *)buffer.buf);
+
+            QueryPerformanceCounter(&start);
+            WriteToFile(&buffer, fileSize, filename, &dirs);
+            result.seconds += Elapsed(start);
+            result.bytes += fileSize;
+        }
+
+        result.phase    = "file_write";
+        result.entries  = i;
+        PrintResult(&result);
+        ReleaseDirCache(&dirs);
+    }
+
+    ReleaseBuffer(&buffer);
+    free(contentHeaders);
+    free(entries);
+    free(work);
+    free(decoded);
+
+    return i == numOfEntries || options->skipWrite;
+}
@@ -0,0 +1,82 @@
+/*  Description:
+ *      Benchmark for the extraction phases. A synthetic archive is generated
+ *      (or an existing one is loaded), read into memory, and every phase of the
+ *      extraction is timed on its own:
+ *
+ *          header_decrypt      DTA_HEADER and the content table
+ *          entry_parse         DTA_FILE_HEADER and filename of every entry
+ *          payload_decrypt     Blocks of every entry
+ *          payload_decode      Decoding of the decrypted blocks, see Decode.h
+ *          file_write          WriteToFile() of every decoded entry
+ *
+ *      Results are printed to stdout as CSV, so runs can be diffed between
+ *      commits. With -check the cipher self check of CipherCheck.h is run
+ *      instead, with -kernels the check of every kernel, with -native the
+ *      round trip of NativeCheck.h, with -cache the block cache check of
+ *      CacheCheck.h, and with -decode the decoder fixtures of DecodeCheck.h.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "Generator.h"
+
+/*
+ * Settings of a benchmark run.
+ */
+typedef struct t_benchoptions {
+    GEN_OPTIONS     gen;
+    char            archive[256];       /* Archive to load instead of generating one */
+    char            outputDir[64];      /* Where file_write puts its files */
+    DWORD           iterations;         /* Repetitions of the in-memory phases */
+    BOOL            generateOnly;
+    BOOL            skipWrite;
+    DWORD           checkTrials;        /* Run the cipher self check instead */
+    BOOL            checkKernels;       /* Check every kernel at every length instead */
+    BOOL            checkNative;        /* Read the archive back through the native backend instead */
+    BOOL            checkDecode;        /* Decode the fixture archive instead */
+    DWORD           cacheTrials;        /* Check the block cache with this many reads instead */
+} BENCH_OPTIONS;
+
+/*
+ * Measurement of a single phase.
+ */
+typedef struct t_benchresult {
+    const char          *phase;
+    DWORD               entries;
+    unsigned __int64    bytes;
+    double              seconds;
+} BENCH_RESULT;
+
+/*----------------------------------------------------------------------------
+ * Prints program usage to stderr.
+ *
+ *  Arguments:          name            Program name
+ *--------------------------------------------------------------------------*/
+void PrintUsage(char *name);
+
+/*----------------------------------------------------------------------------
+ * Reads the command line into 'options'. Returns FALSE if an argument is
+ * unknown or missing its value.
+ *
+ *  Arguments:          options         Options to fill
+ *                      argc            Argument count
+ *                      argv            Arguments
+ *--------------------------------------------------------------------------*/
+BOOL ParseBenchOptions(BENCH_OPTIONS *options, int argc, char *argv[]);
+
+/*----------------------------------------------------------------------------
+ * Runs every phase on the archive in 'archive' and prints the results. If
+ * any errors occur, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          options         Benchmark settings
+ *                      archive         Contents of the whole archive
+ *                      size            Size of the archive
+ *                      error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL RunBenchmark(const BENCH_OPTIONS *options, const char *archive, DWORD size, char error[ERROR_LENGTH]);
+
+#endif
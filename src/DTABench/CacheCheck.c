@@ -0,0 +1,229 @@
+/*  Description:
+ *      Implementation of the block cache check. Reads favour a few entries
+ *      and repeat the previous range now and then, so that the cache sees
+ *      hits as well as replacements.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CacheCheck.h"
+#include "BlockCache.h"
+
+/* Largest range a read asks for */
+#define CHECK_MAX_RANGE     (4 * CHECK_CACHE_BLOCK_SIZE)
+
+/*
+ * Model of the cache: the blocks it should hold, the one used last first.
+ */
+typedef struct t_cachemodel {
+    DWORD               dataOffsets[CHECK_CACHE_BLOCKS];
+    DWORD               indexes[CHECK_CACHE_BLOCKS];
+    DWORD               count;
+    unsigned __int64    hits;
+    unsigned __int64    misses;
+} CACHE_MODEL;
+
+/*----------------------------------------------------------------------------
+ * Returns the next number of a xorshift sequence.
+ *--------------------------------------------------------------------------*/
+static unsigned int NextRandom(unsigned int *state) {
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return *state = x;
+}
+
+/*----------------------------------------------------------------------------
+ * Uses the block 'index' of the entry at 'dataOffset' in the model.
+ *--------------------------------------------------------------------------*/
+static void UseBlock(CACHE_MODEL *model, DWORD dataOffset, DWORD index) {
+    DWORD i;
+
+    for(i = 0; i < model->count; ++i) {
+        if(model->dataOffsets[i] == dataOffset && model->indexes[i] == index)
+            break;
+    }
+
+    if(i < model->count) {
+        ++model->hits;
+    } else {
+        ++model->misses;
+
+        /* A full cache drops the block at the end */
+        if(model->count < CHECK_CACHE_BLOCKS)
+            ++model->count;
+
+        i = model->count - 1;
+    }
+
+    memmove(model->dataOffsets + 1, model->dataOffsets, i * sizeof(DWORD));
+    memmove(model->indexes + 1, model->indexes, i * sizeof(DWORD));
+
+    model->dataOffsets[0]   = dataOffset;
+    model->indexes[0]       = index;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads 'size' bytes at 'offset' of 'info' through the cache and directly,
+ * then compares the data and the counters. Returns FALSE and sets 'error'
+ * if anything differs.
+ *--------------------------------------------------------------------------*/
+static BOOL CheckRange(const DTA_ARCHIVE *archive, DTA_BLOCK_CACHE *cache, CACHE_MODEL *model, const DTA_ENTRY_INFO *info,
+                       DWORD offset, DWORD size, char *expected, char *actual, char error[ERROR_LENGTH]) {
+    DTA_CACHE_STATS stats;
+    DWORD           expectedSize    = DtaReadEntry(archive, info, offset, expected, size);
+    DWORD           actualSize      = DtaReadRange(cache, info, offset, actual, size);
+    DWORD           index;
+
+    if(actualSize != expectedSize || memcmp(actual, expected, expectedSize) != 0) {
+        _snprintf(error, ERROR_LENGTH - 1, "Range %u+%u of %s read back wrong (%u bytes instead of %u)",
+                  offset, size, info->name, actualSize, expectedSize);
+        error[ERROR_LENGTH - 1] = '\0';
+        return FALSE;
+    }
+
+    /* Every block the range touches is used once */
+    if(expectedSize > 0) {
+        for(index = offset / CHECK_CACHE_BLOCK_SIZE; index <= (offset + expectedSize - 1) / CHECK_CACHE_BLOCK_SIZE; ++index)
+            UseBlock(model, info->dataOffset, index);
+    }
+
+    DtaGetCacheStats(cache, &stats);
+
+    if(stats.hits != model->hits || stats.misses != model->misses || stats.usedBlocks != model->count) {
+        _snprintf(error, ERROR_LENGTH - 1, "Cache counters are %u hits, %u misses, %u blocks instead of %u, %u, %u",
+                  (DWORD)stats.hits, (DWORD)stats.misses, stats.usedBlocks, (DWORD)model->hits, (DWORD)model->misses, model->count);
+        error[ERROR_LENGTH - 1] = '\0';
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads across a broken block, made by cutting the stored bytes of the
+ * first entry with two blocks short inside of its second block, the way
+ * the end of a truncated archive would. DtaReadEntry comes back short at
+ * the end of the first block, and so has to DtaReadRange. A cache of its
+ * own is used, the shared one may hold the real blocks of the entry.
+ * Returns FALSE and sets 'error' if the reads differ.
+ *--------------------------------------------------------------------------*/
+static BOOL CheckShortEntry(const DTA_ARCHIVE *archive, char *expected, char *actual, char error[ERROR_LENGTH]) {
+    DTA_BLOCK_CACHE *cache;
+    DTA_ENTRY_INFO  info;
+    DWORD           expectedSize;
+    DWORD           actualSize;
+    DWORD           offset = DTA_BLOCK_SIZE - 100;
+    DWORD           i;
+
+    for(i = 0; DtaGetEntry(archive, i, &info) && info.numOfBlocks < 2; ++i)
+        ;
+
+    if(i == DtaGetEntryCount(archive) || info.fileSize < offset + CHECK_MAX_RANGE)
+        return TRUE;
+
+    if((cache = DtaCreateBlockCache(archive, CHECK_CACHE_BLOCK_SIZE, CHECK_CACHE_BLOCKS, error)) == NULL)
+        return FALSE;
+
+    /* The first block and a piece of the header of the second one are left */
+    DtaReadRaw(archive, info.dataOffset, expected, sizeof(DTA_BLOCK_HEADER));
+    info.storedSize = sizeof(DTA_BLOCK_HEADER) + ((DTA_BLOCK_HEADER *)expected)->storedSize + 2;
+
+    expectedSize    = DtaReadEntry(archive, &info, offset, expected, CHECK_MAX_RANGE);
+    actualSize      = DtaReadRange(cache, &info, offset, actual, CHECK_MAX_RANGE);
+
+    DtaReleaseBlockCache(cache);
+
+    if(expectedSize != 100 || actualSize != expectedSize || memcmp(actual, expected, expectedSize) != 0) {
+        _snprintf(error, ERROR_LENGTH - 1, "Reading across a broken block gave %u and %u bytes instead of 100",
+                  actualSize, expectedSize);
+        error[ERROR_LENGTH - 1] = '\0';
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Generates the archive 'options' describes into 'archive' and does
+ * 'trials' random range reads through a block cache. If a read or a
+ * counter differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:      archive         Archive to create
+ *                  options         Description of the archive
+ *                  trials          Number of reads
+ *                  error           Error string
+ *
+ *  Returns TRUE if every read and counter matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckBlockCache(char *archive, const GEN_OPTIONS *options, DWORD trials, char error[ERROR_LENGTH]) {
+    DTA_ARCHIVE     *dta;
+    DTA_BLOCK_CACHE *cache;
+    DTA_ENTRY_INFO  info;
+    CACHE_MODEL     model           = { 0 };
+    unsigned int    state           = options->seed ? options->seed : 1;
+    char            *expected       = (char *)malloc(CHECK_MAX_RANGE);
+    char            *actual         = (char *)malloc(CHECK_MAX_RANGE);
+    DWORD           numOfEntries;
+    DWORD           offset          = 0;
+    DWORD           size            = 0;
+    DWORD           i;
+    BOOL            result          = TRUE;
+
+    if(expected == NULL || actual == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the cache check", ERROR_LENGTH);
+        free(expected);
+        free(actual);
+        return FALSE;
+    }
+
+    if(!GenerateArchive(archive, options, error) || (dta = DtaOpenArchive(archive, options->key1, options->key2, error)) == NULL) {
+        free(expected);
+        free(actual);
+        return FALSE;
+    }
+
+    if((numOfEntries = DtaGetEntryCount(dta)) == 0 ||
+       (cache = DtaCreateBlockCache(dta, CHECK_CACHE_BLOCK_SIZE, CHECK_CACHE_BLOCKS, error)) == NULL) {
+        if(numOfEntries == 0)
+            strncpy_s(error, ERROR_LENGTH, "The cache check needs an archive with files", ERROR_LENGTH);
+
+        DtaCloseArchive(dta);
+        free(expected);
+        free(actual);
+        return FALSE;
+    }
+
+    DtaGetEntry(dta, 0, &info);
+
+    for(i = 0; result && i < trials; ++i) {
+        /* Every fourth read repeats the last one, which has to hit */
+        if(i % 4 != 3) {
+            DWORD entry = NextRandom(&state) % 2 ? NextRandom(&state) % min(numOfEntries, 8) : NextRandom(&state) % numOfEntries;
+
+            DtaGetEntry(dta, entry, &info);
+
+            /* Ranges may start past the end of the entry */
+            offset  = NextRandom(&state) % (info.fileSize + CHECK_CACHE_BLOCK_SIZE);
+            size    = NextRandom(&state) % (CHECK_MAX_RANGE + 1);
+        }
+
+        result = CheckRange(dta, cache, &model, &info, offset, size, expected, actual, error);
+    }
+
+    if(result)
+        result = CheckShortEntry(dta, expected, actual, error);
+
+    DtaReleaseBlockCache(cache);
+    DtaCloseArchive(dta);
+    free(expected);
+    free(actual);
+
+    return result;
+}
@@ -0,0 +1,36 @@
+/*  Description:
+ *      Check of the libdta block cache. An archive is generated and random
+ *      ranges of its entries are read through DtaReadRange() and compared
+ *      with DtaReadEntry(). The hit and miss counters are compared after
+ *      every read with a model of the cache that replaces the block used
+ *      longest ago, and a range that runs into a block cut short, like the
+ *      end of a truncated archive, has to come back short.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef CACHE_CHECK_H_
+#define CACHE_CHECK_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "Generator.h"
+
+/* Block size and number of blocks of the checked cache, small so that blocks are replaced often */
+#define CHECK_CACHE_BLOCK_SIZE  4096
+#define CHECK_CACHE_BLOCKS      16
+
+/*----------------------------------------------------------------------------
+ * Generates the archive 'options' describes into 'archive' and does
+ * 'trials' random range reads through a block cache. If a read or a
+ * counter differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:      archive         Archive to create
+ *                  options         Description of the archive
+ *                  trials          Number of reads
+ *                  error           Error string
+ *
+ *  Returns TRUE if every read and counter matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckBlockCache(char *archive, const GEN_OPTIONS *options, DWORD trials, char error[ERROR_LENGTH]);
+
+#endif
@@ -0,0 +1,288 @@
+/*  Description:
+ *      Implementation of the cipher self check. Buffers are placed at every
+ *      misalignment up to 64 bytes, so the heads and tails of the vector
+ *      kernels are all covered. The copying kernels get a source that is
+ *      misaligned differently from the destination.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CipherCheck.h"
+
+/* Largest buffer a trial uses */
+#define CHECK_MAX_LENGTH    65536
+
+/* Largest number of pieces a buffer is split into */
+#define CHECK_MAX_PIECES    8
+
+/* Misalignments tried by CheckCipherKernels, and the guard bytes around a buffer */
+#define CHECK_ALIGNMENTS    64
+
+/* Value of the guard bytes, a kernel that writes past its buffer changes them */
+#define CHECK_GUARD         0xA5
+
+/*----------------------------------------------------------------------------
+ * Returns the next number of a xorshift sequence.
+ *--------------------------------------------------------------------------*/
+static unsigned int NextRandom(unsigned int *state) {
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return *state = x;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'cuts' with 'count' sorted positions between 0 and 'length'. The
+ * pieces run from one cut to the next.
+ *--------------------------------------------------------------------------*/
+static void PickCuts(DWORD cuts[CHECK_MAX_PIECES + 1], DWORD count, DWORD length, unsigned int *state) {
+    DWORD i;
+    DWORD j;
+
+    cuts[0]     = 0;
+    cuts[count] = length;
+
+    for(i = 1; i < count; ++i)
+        cuts[i] = length ? NextRandom(state) % (length + 1) : 0;
+
+    /* Insertion sort, there are only a few */
+    for(i = 2; i < count; ++i) {
+        DWORD cut = cuts[i];
+
+        for(j = i; j > 1 && cuts[j - 1] > cut; --j)
+            cuts[j] = cuts[j - 1];
+
+        cuts[j] = cut;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Runs 'trials' random splits with the kernel Decrypt() picked for this
+ * CPU. If a result differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          trials          Number of buffers to check
+ *                      seed            Random seed, must not be 0
+ *                      error           Error string
+ *
+ *  Returns TRUE if every split matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckCipher(DWORD trials, unsigned int seed, char error[ERROR_LENGTH]) {
+    unsigned char   *plain      = (unsigned char *)malloc(CHECK_MAX_LENGTH);
+    unsigned char   *expected   = (unsigned char *)malloc(CHECK_MAX_LENGTH);
+    unsigned char   *work       = (unsigned char *)malloc(CHECK_MAX_LENGTH + 64);
+    unsigned char   *copy       = (unsigned char *)malloc(CHECK_MAX_LENGTH + 64);
+    unsigned int    state       = seed ? seed : 1;
+    BOOL            result      = TRUE;
+    DWORD           trial;
+
+    if(plain == NULL || expected == NULL || work == NULL || copy == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the cipher check", ERROR_LENGTH);
+        free(plain);
+        free(expected);
+        free(work);
+        free(copy);
+        return FALSE;
+    }
+
+    for(trial = 0; trial < trials && result; ++trial) {
+        unsigned int    key1    = NextRandom(&state);
+        unsigned int    key2    = NextRandom(&state);
+        DWORD           length  = NextRandom(&state) % (CHECK_MAX_LENGTH + 1);
+        unsigned char   *buffer = work + trial % 64;
+        unsigned char   *source = copy + (trial * 7 + 3) % 64;
+        DWORD           cuts[CHECK_MAX_PIECES + 1];
+        DWORD           count;
+        DWORD           i;
+        CIPHER_CONTEXT  context;
+
+        /* Short buffers are where the heads and tails go wrong, so favour them */
+        if(trial % 2)
+            length %= 256;
+
+        for(i = 0; i < length; ++i)
+            plain[i] = (unsigned char)NextRandom(&state);
+
+        memcpy(expected, plain, length);
+        DecryptScalar(expected, length, key1, key2, 0);
+
+        /* Pieces decrypted with DecryptAt */
+        count = 1 + NextRandom(&state) % CHECK_MAX_PIECES;
+        PickCuts(cuts, count, length, &state);
+        memcpy(buffer, plain, length);
+
+        for(i = 0; i < count; ++i)
+            DecryptAt(buffer + cuts[i], cuts[i + 1] - cuts[i], key1, key2, cuts[i]);
+
+        if(memcmp(buffer, expected, length) != 0) {
+            _snprintf(error, ERROR_LENGTH - 1, "DecryptAt differs in trial %u (%u bytes, %u pieces)", trial, length, count);
+            error[ERROR_LENGTH - 1] = '\0';
+            result = FALSE;
+            break;
+        }
+
+        /* The same through a context, with other cuts */
+        count = 1 + NextRandom(&state) % CHECK_MAX_PIECES;
+        PickCuts(cuts, count, length, &state);
+        memcpy(buffer, plain, length);
+        InitCipher(&context, key1, key2, 0);
+
+        for(i = 0; i < count; ++i)
+            DecryptStream(&context, buffer + cuts[i], cuts[i + 1] - cuts[i]);
+
+        if(memcmp(buffer, expected, length) != 0) {
+            _snprintf(error, ERROR_LENGTH - 1, "DecryptStream differs in trial %u (%u bytes, %u pieces)", trial, length, count);
+            error[ERROR_LENGTH - 1] = '\0';
+            result = FALSE;
+            break;
+        }
+
+        /* Pieces copied out of another buffer, every other one with streaming stores */
+        count = 1 + NextRandom(&state) % CHECK_MAX_PIECES;
+        PickCuts(cuts, count, length, &state);
+        memcpy(source, plain, length);
+        memset(buffer, 0, length);
+
+        for(i = 0; i < count; ++i) {
+            if(i % 2)
+                DecryptCopyStreaming(buffer + cuts[i], source + cuts[i], cuts[i + 1] - cuts[i], key1, key2, cuts[i]);
+            else
+                DecryptCopy(buffer + cuts[i], source + cuts[i], cuts[i + 1] - cuts[i], key1, key2, cuts[i]);
+        }
+
+        if(memcmp(buffer, expected, length) != 0 || memcmp(source, plain, length) != 0) {
+            _snprintf(error, ERROR_LENGTH - 1, "DecryptCopy differs in trial %u (%u bytes, %u pieces)", trial, length, count);
+            error[ERROR_LENGTH - 1] = '\0';
+            result = FALSE;
+        }
+    }
+
+    free(plain);
+    free(expected);
+    free(work);
+    free(copy);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if the CHECK_ALIGNMENTS bytes before and after the 'length'
+ * bytes at 'buffer' still hold CHECK_GUARD.
+ *--------------------------------------------------------------------------*/
+static BOOL CheckGuards(const unsigned char *buffer, DWORD length) {
+    DWORD i;
+
+    for(i = 1; i <= CHECK_ALIGNMENTS; ++i) {
+        if(buffer[-(int)i] != CHECK_GUARD || buffer[length + i - 1] != CHECK_GUARD)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Runs every kernel the CPU supports, in place and copying, at every length
+ * up to CHECK_KERNEL_LENGTH and every misalignment up to 63 bytes, and
+ * compares the results with DecryptScalar(). Nothing is random, so a
+ * failure always comes back the same. The name and the result of each
+ * kernel are printed to stdout as CSV. If a result differs, 'error' is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:          error           Error string
+ *
+ *  Returns TRUE if every kernel matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckCipherKernels(char error[ERROR_LENGTH]) {
+    DWORD           bufferSize  = CHECK_KERNEL_LENGTH + 3 * CHECK_ALIGNMENTS;
+    unsigned char   *plain      = (unsigned char *)malloc(CHECK_KERNEL_LENGTH);
+    unsigned char   *expected   = (unsigned char *)malloc(CHECK_KERNEL_LENGTH);
+    unsigned char   *work       = (unsigned char *)malloc(bufferSize + CHECK_ALIGNMENTS);
+    unsigned char   *copy       = (unsigned char *)malloc(bufferSize + CHECK_ALIGNMENTS);
+    unsigned char   *workBase;
+    unsigned char   *copyBase;
+    unsigned int    key1        = 0x8D2965CA;
+    unsigned int    key2        = 0x4FE85106;
+    unsigned int    state       = 1;
+    DECRYPT_KERNEL  kernels[DECRYPT_MAX_KERNELS];
+    unsigned int    numOfKernels;
+    unsigned int    k;
+    BOOL            result      = TRUE;
+
+    if(plain == NULL || expected == NULL || work == NULL || copy == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the cipher check", ERROR_LENGTH);
+        free(plain);
+        free(expected);
+        free(work);
+        free(copy);
+        return FALSE;
+    }
+
+    /* Misalignments are counted from a 64-byte boundary */
+    workBase = (unsigned char *)(((size_t)work + CHECK_ALIGNMENTS - 1) & ~(size_t)(CHECK_ALIGNMENTS - 1));
+    copyBase = (unsigned char *)(((size_t)copy + CHECK_ALIGNMENTS - 1) & ~(size_t)(CHECK_ALIGNMENTS - 1));
+
+    for(k = 0; k < CHECK_KERNEL_LENGTH; ++k)
+        plain[k] = (unsigned char)NextRandom(&state);
+
+    numOfKernels = GetDecryptKernels(kernels);
+
+    for(k = 0; k < numOfKernels && result; ++k) {
+        DECRYPT_KERNEL  *kernel = &kernels[k];
+        DWORD           length;
+        DWORD           misalignment;
+
+        for(length = 0; length <= CHECK_KERNEL_LENGTH && result; ++length) {
+            for(misalignment = 0; misalignment < CHECK_ALIGNMENTS && result; ++misalignment) {
+                /* The guards come first, the buffer after them */
+                unsigned char   *buffer     = workBase + CHECK_ALIGNMENTS + misalignment;
+                unsigned char   *source     = copyBase + CHECK_ALIGNMENTS + (misalignment * 7 + 3) % CHECK_ALIGNMENTS;
+                unsigned int    offset      = (length + misalignment) % 8;
+                const char      *failed     = NULL;
+                int             streaming;
+
+                memcpy(expected, plain, length);
+                DecryptScalar(expected, length, key1, key2, offset);
+
+                memset(workBase, CHECK_GUARD, bufferSize);
+                memcpy(buffer, plain, length);
+                kernel->decrypt(buffer, length, key1, key2, offset);
+
+                if(memcmp(buffer, expected, length) != 0 || !CheckGuards(buffer, length))
+                    failed = "in place";
+
+                /* Copies into another buffer, with and without streaming stores */
+                for(streaming = 0; streaming < 2 && failed == NULL; ++streaming) {
+                    memset(workBase, CHECK_GUARD, bufferSize);
+                    memcpy(source, plain, length);
+                    kernel->decryptCopy(buffer, source, length, key1, key2, offset, streaming);
+
+                    if(memcmp(buffer, expected, length) != 0 || !CheckGuards(buffer, length) ||
+                       memcmp(source, plain, length) != 0)
+                        failed = streaming ? "streaming copy" : "copy";
+                }
+
+                if(failed != NULL) {
+                    _snprintf(error, ERROR_LENGTH - 1, "The %s kernel differs (%s, %u bytes, misaligned by %u, offset %u)",
+                              kernel->name, failed, length, misalignment, offset);
+                    error[ERROR_LENGTH - 1] = '\0';
+                    result = FALSE;
+                }
+            }
+        }
+
+        if(result)
+            printf("kernel_check,%s,ok\n", kernel->name);
+    }
+
+    free(plain);
+    free(expected);
+    free(work);
+    free(copy);
+
+    return result;
+}
@@ -0,0 +1,48 @@
+/*  Description:
+ *      Self check of the position-aware cipher. Random buffers are decrypted
+ *      in random pieces, through DecryptAt(), a CIPHER_CONTEXT and the copying
+ *      DecryptCopy() and DecryptCopyStreaming(), and every result has to
+ *      equal DecryptScalar() run over the whole buffer.
+ *
+ *      CheckCipherKernels() covers what random trials may miss: every kernel
+ *      the CPU supports is run at every length and alignment of a range, and
+ *      has to leave the bytes around the buffer alone.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef CIPHER_CHECK_H_
+#define CIPHER_CHECK_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/* Longest buffer CheckCipherKernels tries */
+#define CHECK_KERNEL_LENGTH     4096
+
+/*----------------------------------------------------------------------------
+ * Runs 'trials' random splits with the kernel Decrypt() picked for this
+ * CPU. If a result differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          trials          Number of buffers to check
+ *                      seed            Random seed, must not be 0
+ *                      error           Error string
+ *
+ *  Returns TRUE if every split matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckCipher(DWORD trials, unsigned int seed, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Runs every kernel the CPU supports, in place and copying, at every length
+ * up to CHECK_KERNEL_LENGTH and every misalignment up to 63 bytes, and
+ * compares the results with DecryptScalar(). Nothing is random, so a
+ * failure always comes back the same. The name and the result of each
+ * kernel are printed to stdout as CSV. If a result differs, 'error' is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:          error           Error string
+ *
+ *  Returns TRUE if every kernel matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckCipherKernels(char error[ERROR_LENGTH]);
+
+#endif
@@ -0,0 +1,685 @@
+/*  Description:
+ *      Implementation of the decoder check. The fixture archive was built
+ *      block by block, and every file of it was then read through tmp.dll,
+ *      so the expected sizes and hashes are what the game itself returns.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DecodeCheck.h"
+#include "Dta.h"
+#include "Hash.h"
+
+/* Keys of the fixture archive, the ones of Sounds.dta */
+#define CHECK_DECODE_KEY1       0x8D2965CA
+#define CHECK_DECODE_KEY2       0x4FE85106
+
+/* Window of the second pass, the smallest the archive can be mapped in */
+#define CHECK_DECODE_VIEW_SIZE  (64 * 1024)
+
+/*
+ * A file of the fixture archive and what tmp.dll returned for it.
+ */
+typedef struct t_decodefixture {
+    const char          *name;
+    DWORD               fileSize;
+    unsigned __int64    hash;           /* XXH64 with seed 0 */
+} DECODE_FIXTURE;
+
+static const DECODE_FIXTURE fixtures[CHECK_DECODE_FIXTURES] = {
+    { "fixtures\\stored.bin",   200,    (unsigned __int64)0xEC767732BECC6CC4 },   /* Stored, encrypted */
+    { "fixtures\\text.txt",     3000,   (unsigned __int64)0x8B5B3A26AA2E8C54 },   /* LZ77, encrypted */
+    { "fixtures\\runs.bin",     70000,  (unsigned __int64)0x96214CCFE57580C8 },   /* LZ77 runs in 3 blocks */
+    { "sounds\\mono16.wav",     646,    (unsigned __int64)0x7D8D722ADB157A60 },   /* 16-bit mono, masked header */
+    { "sounds\\stereo16.wav",   848,    (unsigned __int64)0x926EBCCD33EE22AB },   /* 16-bit stereo, encrypted */
+    { "sounds\\mono8.wav",      544,    (unsigned __int64)0x31C6798862A067ED },   /* 8-bit stored, encrypted */
+    { "sounds\\silence8.wav",   80000,  (unsigned __int64)0xA2E465FF8FBFEA5A }    /* 8-bit LZ77 in 3 blocks */
+};
+
+/* Sizes of the pieces a file is read in, taken in turn */
+static const DWORD pieceSizes[] = { 1, 13, 4093, 32773 };
+
+#define NUM_OF_PIECE_SIZES  (sizeof(pieceSizes) / sizeof(pieceSizes[0]))
+
+/*
+ * The fixture archive as it is stored.
+ */
+static const unsigned char fixtureArchive[] = {
+    0x49, 0x53, 0x44, 0x30, 0x01, 0x51, 0xE8, 0x4F, 0x20, 0x78, 0x29, 0x8D, 0xC2, 0x51, 0xE8, 0x4F,
+    0xCA, 0x65, 0x29, 0x8D, 0x17, 0x51, 0xE8, 0x4F, 0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F,
+    0x8E, 0x65, 0x29, 0x8D, 0xCE, 0x51, 0xE8, 0x4F, 0xCB, 0x65, 0x29, 0x8D, 0x15, 0xD1, 0xE8, 0x4F,
+    0xCA, 0x65, 0x29, 0x8D, 0x60, 0x38, 0x90, 0x3B, 0xBF, 0x17, 0x4C, 0xFE, 0x5A, 0x22, 0x9C, 0x20,
+    0xB8, 0x00, 0x4D, 0xA3, 0x64, 0x38, 0x86, 0xC9, 0x00, 0x00, 0x00, 0x03, 0xB6, 0x51, 0xE0, 0x03,
+    0xA1, 0xC8, 0x6A, 0x20, 0x13, 0x44, 0xED, 0x13, 0x82, 0x30, 0x52, 0x55, 0xC3, 0x0F, 0x64, 0xCC,
+    0x0C, 0x41, 0x73, 0x15, 0x4B, 0xC8, 0x1E, 0xB3, 0x96, 0xBD, 0xFE, 0x6F, 0x64, 0xDB, 0x1E, 0x6A,
+    0x8D, 0x87, 0xD8, 0x52, 0x3C, 0xFF, 0xEF, 0x4E, 0xAB, 0xFE, 0xF0, 0x61, 0x45, 0xDC, 0xDD, 0xF4,
+    0x6D, 0x1A, 0x95, 0x13, 0x61, 0xA8, 0xFE, 0x09, 0x2D, 0x67, 0x3D, 0x47, 0x78, 0x77, 0x51, 0x2D,
+    0x60, 0x6D, 0x39, 0x3D, 0x8A, 0x3F, 0x77, 0x58, 0x59, 0x27, 0x8E, 0xCA, 0xF4, 0x76, 0x03, 0x8D,
+    0x46, 0x98, 0x28, 0x53, 0xC8, 0x50, 0x3D, 0x22, 0x42, 0xC5, 0x2E, 0x40, 0xDF, 0x3D, 0x21, 0xE2,
+    0x4F, 0x4E, 0x60, 0xB2, 0x8D, 0xF6, 0xFF, 0xEA, 0x9B, 0xEE, 0x19, 0x6B, 0x09, 0xD1, 0x52, 0x22,
+    0xFE, 0x24, 0x09, 0x37, 0x3E, 0xC4, 0xB1, 0xE6, 0xB3, 0x3D, 0x90, 0xCE, 0xB3, 0xA3, 0x4F, 0x05,
+    0xC3, 0xE5, 0xDD, 0xAA, 0xEB, 0x8E, 0xBC, 0xBF, 0xE2, 0xE8, 0x4E, 0xBF, 0x5C, 0x3D, 0xE5, 0xE0,
+    0x7B, 0xD9, 0xF9, 0x88, 0x04, 0xEB, 0x5D, 0x58, 0xDA, 0x32, 0x9A, 0x53, 0x10, 0x4C, 0x5A, 0x3E,
+    0xCC, 0xEE, 0xC0, 0xAF, 0x5A, 0x21, 0x49, 0xFB, 0x5D, 0xAA, 0x0C, 0xB5, 0x52, 0xC0, 0x49, 0x26,
+    0xCF, 0x97, 0x0B, 0xE3, 0x73, 0x0C, 0x00, 0x15, 0x45, 0x42, 0xCB, 0x1D, 0x32, 0xF1, 0x78, 0xF7,
+    0x57, 0xF2, 0xB4, 0x1E, 0x17, 0x51, 0xE8, 0x4F, 0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F,
+    0x8E, 0x65, 0x29, 0x8D, 0xBE, 0x5A, 0xE8, 0x4F, 0xCB, 0x65, 0x29, 0x8D, 0x17, 0xD1, 0xE8, 0x4F,
+    0xCA, 0x65, 0x29, 0x8D, 0x60, 0x38, 0x90, 0x3B, 0xBF, 0x17, 0x4C, 0xFE, 0x5A, 0x25, 0x8D, 0x37,
+    0xBE, 0x4B, 0x5D, 0xF5, 0x72, 0xD3, 0x01, 0x00, 0x00, 0x07, 0x51, 0xE8, 0x28, 0xAB, 0x08, 0x44,
+    0xEC, 0x26, 0x33, 0x8D, 0x3B, 0xAB, 0x45, 0x4C, 0xFD, 0x75, 0x38, 0x84, 0x4F, 0xFA, 0x0A, 0x47,
+    0xAD, 0x62, 0x34, 0x84, 0x3B, 0xAB, 0x68, 0x23, 0x8C, 0x44, 0x51, 0xE8, 0x47, 0xCA, 0x04, 0x45,
+    0xFD, 0x6E, 0x2E, 0x17, 0x2E, 0xC8, 0xC0, 0x29, 0xF9, 0x07, 0x12, 0xEB, 0x3D, 0xC9, 0xAA, 0x29,
+    0x95, 0x01, 0x62, 0xEB, 0x15, 0xC2, 0x0D, 0x29, 0x3E, 0x0E, 0x94, 0xE9, 0xD7, 0xCA, 0x65, 0x09,
+    0x8D, 0x03, 0xF2, 0xEE, 0x46, 0x35, 0x9A, 0x22, 0xD7, 0x07, 0x62, 0xE8, 0x4F, 0xC2, 0x65, 0x23,
+    0xC7, 0x0C, 0xEB, 0xE8, 0x2C, 0xD8, 0xAA, 0x28, 0x28, 0x06, 0x51, 0xC8, 0x4F, 0xCE, 0xC0, 0x2C,
+    0x06, 0x16, 0x5A, 0xE8, 0x4F, 0xC2, 0x65, 0x3E, 0xA5, 0x04, 0xC2, 0xFB, 0x94, 0x39, 0x9A, 0x22,
+    0x94, 0x04, 0xE9, 0xE8, 0x4F, 0xC2, 0x65, 0x09, 0xD2, 0x0B, 0x5B, 0xE8, 0x4F, 0xC2, 0x65, 0x22,
+    0xE2, 0x0C, 0xB6, 0xF6, 0x40, 0xCD, 0x5A, 0x2E, 0xB2, 0x01, 0x67, 0xE8, 0xB3, 0xD0, 0x9F, 0x35,
+    0xA7, 0xF9, 0xBE, 0xF0, 0xE0, 0xC8, 0xE3, 0x01, 0xDA, 0x0E, 0x8B, 0xE8, 0x95, 0xCD, 0xAF, 0x01,
+    0xF3, 0x0D, 0xDE, 0xC9, 0xB0, 0xDF, 0xCC, 0x2C, 0xD2, 0x68, 0x59, 0xF1, 0x4F, 0xCA, 0x6D, 0x29,
+    0x94, 0x79, 0x51, 0xE8, 0x4E, 0xCA, 0x9A, 0xD6, 0x90, 0xA9, 0x54, 0x4C, 0x4C, 0x02, 0x76, 0x96,
+    0x85, 0xD0, 0x45, 0x93, 0x4F, 0xCA, 0x6D, 0x29, 0x8E, 0xA3, 0x51, 0xE8, 0x47, 0xCA, 0x62, 0xD2,
+    0x8F, 0xE9, 0x51, 0xE8, 0x59, 0xCA, 0x4C, 0xD6, 0x82, 0x79, 0x51, 0xFD, 0x54, 0xF0, 0x9A, 0xD6,
+    0x99, 0x59, 0x75, 0x86, 0x41, 0xD5, 0x65, 0x29, 0x98, 0x06, 0x52, 0x21, 0x7B, 0x54, 0x65, 0x29,
+    0x85, 0x06, 0x49, 0x92, 0x4F, 0xCA, 0xE5, 0x29, 0x98, 0xF9, 0x51, 0xE8, 0x4B, 0xCA, 0x6B, 0x36,
+    0xA4, 0x79, 0x7D, 0x67, 0x61, 0xB5, 0x45, 0xC6, 0x72, 0xF9, 0x51, 0xE8, 0x4E, 0xCA, 0x66, 0x83,
+    0x8D, 0x06, 0x59, 0xE8, 0x74, 0xED, 0x63, 0xC1, 0x85, 0x7D, 0x51, 0xE8, 0x47, 0xCA, 0x35, 0x46,
+    0xEE, 0x59, 0x51, 0xE8, 0x4F, 0xCA, 0x63, 0x20, 0x8E, 0xA8, 0x50, 0x96, 0x08, 0xB5, 0x49, 0x75,
+    0xBB, 0x5D, 0xAE, 0x17, 0x41, 0x75, 0x7F, 0x36, 0x80, 0x09, 0x51, 0xE8, 0x5E, 0xCA, 0x78, 0x36,
+    0x99, 0x18, 0x51, 0xE8, 0x47, 0xCA, 0x5E, 0xD6, 0xCF, 0x79, 0x5A, 0x57, 0x4F, 0xCA, 0x67, 0x29,
+    0x8E, 0xA9, 0x4A, 0xB1, 0x5C, 0xE4, 0x60, 0x86, 0xF9, 0xCD, 0xAE, 0x17, 0x67, 0x95, 0x63, 0xF6,
+    0x9B, 0x33, 0x5F, 0xE7, 0x40, 0x15, 0x65, 0x29, 0x8B, 0x06, 0xDF, 0xD7, 0x63, 0x11, 0x6C, 0x16,
+    0xA2, 0xAD, 0x51, 0xE8, 0x47, 0xCA, 0x55, 0x76, 0xFD, 0x3A, 0x0B, 0x80, 0x7C, 0x25, 0x63, 0xB2,
+    0x72, 0xF9, 0x51, 0xE8, 0x47, 0xCA, 0x0F, 0x76, 0x81, 0x9D, 0x51, 0x65, 0xC0, 0x95, 0x04, 0x95,
+    0xB0, 0xA9, 0x59, 0xA7, 0x17, 0x65, 0x79, 0x36, 0x8D, 0x06, 0x59, 0xE8, 0x65, 0x95, 0x65, 0x29,
+    0x99, 0x06, 0x72, 0x1F, 0x7A, 0xC0, 0x65, 0x29, 0x85, 0x06, 0xAE, 0x10, 0x08, 0x65, 0x65, 0x29,
+    0x93, 0x06, 0xD3, 0xB7, 0x55, 0x36, 0x22, 0xB6, 0x8D, 0x06, 0x55, 0xE8, 0x7A, 0xC5, 0xEE, 0x06,
+    0x9B, 0x29, 0x51, 0xE8, 0x4C, 0xCA, 0x7B, 0x46, 0xCB, 0xD9, 0xDB, 0x84, 0x17, 0x51, 0xE8, 0x4F,
+    0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F, 0x8E, 0x65, 0x29, 0x8D, 0x76, 0x40, 0xE9, 0x4F,
+    0xC9, 0x65, 0x29, 0x8D, 0x17, 0x51, 0xE8, 0x4F, 0xCA, 0x65, 0x29, 0x8D, 0x60, 0x38, 0x90, 0x3B,
+    0xBF, 0x17, 0x4C, 0xFE, 0x5A, 0x23, 0x9D, 0x21, 0xB9, 0x4B, 0x4B, 0xE4, 0x68, 0xB9, 0x00, 0x00,
+    0x00, 0x01, 0x91, 0xC1, 0x00, 0x04, 0x18, 0x07, 0x43, 0xEF, 0x00, 0x08, 0x8C, 0x4E, 0xA2, 0xE9,
+    0xE6, 0x00, 0x0A, 0xE1, 0xDD, 0x00, 0x05, 0xD5, 0xAD, 0x00, 0x09, 0x42, 0x0F, 0xC5, 0xD9, 0x2D,
+    0x28, 0x3A, 0x00, 0x01, 0x28, 0xA3, 0x04, 0x60, 0x70, 0x6B, 0xD5, 0x0A, 0x00, 0x00, 0x03, 0x80,
+    0x9A, 0x8A, 0xEF, 0xF3, 0x00, 0x07, 0x69, 0x8F, 0x00, 0x07, 0x71, 0x49, 0xDB, 0xA9, 0xC7, 0xD1,
+    0x86, 0xD0, 0x58, 0x00, 0x05, 0x45, 0x4B, 0x00, 0x03, 0x09, 0x72, 0x9F, 0x00, 0x01, 0xEB, 0xA2,
+    0x08, 0xDB, 0x5A, 0x2F, 0xA9, 0x00, 0x02, 0xE7, 0x33, 0x4A, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03,
+    0x9A, 0xFA, 0xFC, 0x81, 0xA2, 0x82, 0xC2, 0x00, 0x06, 0x12, 0x9B, 0x46, 0x9C, 0x57, 0xA4, 0xC7,
+    0x00, 0x08, 0xB6, 0x99, 0x51, 0x00, 0x00, 0xDF, 0xE2, 0x00, 0x01, 0x7F, 0xDB, 0x81, 0x86, 0x79,
+    0x2D, 0x00, 0x02, 0x63, 0xD3, 0x8C, 0xB3, 0x12, 0x00, 0x05, 0x98, 0xFB, 0x25, 0x00, 0x04, 0xAD,
+    0xE2, 0x00, 0x08, 0xDD, 0x2B, 0xD0, 0x77, 0x00, 0x01, 0x5E, 0x34, 0x00, 0x00, 0x74, 0x27, 0x82,
+    0xC0, 0xF2, 0x00, 0x04, 0xF1, 0x5A, 0xF4, 0xBF, 0x00, 0x00, 0x63, 0xD6, 0xB7, 0x48, 0x00, 0x06,
+    0x00, 0x00, 0x0A, 0x72, 0xC9, 0x49, 0x00, 0x03, 0x45, 0xB3, 0x90, 0x00, 0xB9, 0x00, 0x01, 0x8C,
+    0x91, 0x00, 0x04, 0x34, 0xB3, 0xC8, 0x4F, 0x0D, 0x00, 0x00, 0x8D, 0x06, 0x00, 0x08, 0x2A, 0x05,
+    0x6B, 0x47, 0x00, 0x0A, 0x00, 0x75, 0x15, 0xD0, 0x00, 0x0A, 0x4D, 0xD1, 0xDD, 0xB4, 0x12, 0x00,
+    0x06, 0x51, 0x06, 0x82, 0x70, 0x00, 0x00, 0x43, 0x42, 0x86, 0x96, 0xD0, 0x11, 0xAD, 0x00, 0x00,
+    0x1A, 0xF5, 0xB8, 0x1A, 0x00, 0x06, 0xE6, 0x7E, 0x00, 0x08, 0x45, 0x55, 0x00, 0x00, 0x35, 0xBB,
+    0x1E, 0xE9, 0x90, 0xFE, 0x69, 0xA1, 0xD6, 0x00, 0x0A, 0x3C, 0xA8, 0x00, 0x09, 0xFE, 0xE0, 0x73,
+    0x00, 0x05, 0x95, 0x3F, 0x8F, 0x11, 0x00, 0x08, 0x60, 0xB5, 0x00, 0x01, 0x0E, 0xB7, 0xD7, 0x00,
+    0x04, 0x07, 0xD3, 0x73, 0xD6, 0x76, 0x7F, 0x00, 0x00, 0xA7, 0x0B, 0x04, 0x21, 0x76, 0x15, 0x2E,
+    0xE6, 0x28, 0x00, 0x08, 0x5F, 0x94, 0x37, 0x8F, 0x9F, 0xCB, 0x00, 0x09, 0xB0, 0xFD, 0x3E, 0x33,
+    0x3D, 0x49, 0x00, 0x02, 0x1C, 0x0A, 0x20, 0x00, 0xF7, 0x94, 0x00, 0x0B, 0x17, 0xD4, 0x1B, 0x00,
+    0x90, 0x00, 0x01, 0x86, 0x10, 0x00, 0x00, 0x7C, 0xD4, 0x74, 0xEB, 0xBB, 0x50, 0x00, 0x07, 0xE5,
+    0x70, 0x00, 0x04, 0xCD, 0xEB, 0x1E, 0x5C, 0xBC, 0x32, 0x00, 0x03, 0xFA, 0xDA, 0x17, 0x51, 0xE8,
+    0x4F, 0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F, 0x8E, 0x65, 0x29, 0x8D, 0x80, 0x53, 0xE8,
+    0x4F, 0xCB, 0x65, 0x29, 0x8D, 0x17, 0x51, 0xE8, 0x4F, 0xCA, 0x65, 0x29, 0x8D, 0x75, 0x3E, 0x9D,
+    0x21, 0xAE, 0x16, 0x75, 0xE0, 0x69, 0x3F, 0x87, 0x7E, 0xFC, 0x4B, 0x5E, 0xEC, 0x70, 0x5B, 0x01,
+    0x00, 0x00, 0x14, 0x54, 0x18, 0xAE, 0x09, 0xB4, 0x67, 0x29, 0x8D, 0x51, 0x10, 0xBE, 0x0A, 0xAC,
+    0x08, 0x5D, 0xAD, 0x16, 0x51, 0xE8, 0x4F, 0xCB, 0x65, 0x28, 0x8D, 0x24, 0x07, 0xE8, 0x4F, 0x8E,
+    0xC9, 0x29, 0x8D, 0x04, 0x51, 0xF8, 0x4F, 0xAE, 0x04, 0x5D, 0xEC, 0x5C, 0x53, 0xE8, 0x4F, 0x95,
+    0xB6, 0xD3, 0xD8, 0x92, 0xBB, 0xFB, 0x87, 0x2D, 0x0F, 0xDD, 0xC9, 0xDF, 0x3B, 0x41, 0x2D, 0x84,
+    0x08, 0xC6, 0x80, 0x02, 0xA1, 0xC1, 0x1B, 0x30, 0x1B, 0x79, 0x75, 0xF1, 0x84, 0x45, 0x3A, 0xFD,
+    0xE7, 0x0F, 0x6F, 0xF5, 0x3F, 0x48, 0xCC, 0xFA, 0xC7, 0x54, 0x4F, 0x3E, 0x59, 0x7D, 0x6D, 0xAB,
+    0x10, 0xE8, 0xE6, 0x34, 0x34, 0xE2, 0x37, 0xF4, 0xB8, 0x7F, 0x77, 0xD5, 0xA7, 0x53, 0x26, 0x74,
+    0xA9, 0x89, 0xF5, 0x66, 0xF8, 0x10, 0x06, 0xC1, 0x24, 0x79, 0x37, 0x91, 0x95, 0xBD, 0x82, 0x0C,
+    0x7B, 0xB7, 0x41, 0x00, 0x1B, 0x83, 0x76, 0x0A, 0x39, 0x1E, 0xA9, 0xC9, 0xFA, 0x04, 0x22, 0xEC,
+    0xE5, 0x12, 0xEE, 0x39, 0x63, 0x86, 0x07, 0x8C, 0x57, 0x34, 0x41, 0xA4, 0xB9, 0x8E, 0xFA, 0x47,
+    0xF6, 0x50, 0x37, 0xB4, 0x3A, 0xE0, 0x6A, 0x0C, 0x40, 0xF4, 0xA7, 0x8A, 0x9D, 0xBE, 0x02, 0x86,
+    0x3C, 0xB1, 0x70, 0x56, 0x6B, 0x53, 0xBE, 0x5E, 0x14, 0xF8, 0x16, 0x9F, 0x65, 0x79, 0x2D, 0x44,
+    0x20, 0x13, 0xF8, 0xF6, 0xB0, 0x26, 0x0B, 0x22, 0xBF, 0x3A, 0x1E, 0x97, 0xF0, 0x06, 0x36, 0x17,
+    0x54, 0x3D, 0x0B, 0x7C, 0x3A, 0xEB, 0x23, 0xFA, 0xB7, 0xD7, 0xF2, 0x64, 0x1B, 0x75, 0x40, 0xCE,
+    0xD5, 0xE0, 0x8F, 0x34, 0xD6, 0x0C, 0x51, 0x64, 0x12, 0x6D, 0x71, 0x6C, 0x6A, 0x8C, 0x1F, 0xED,
+    0xA1, 0xD0, 0xBC, 0x38, 0x91, 0xD5, 0xB0, 0xA2, 0xBC, 0x80, 0xDE, 0x9A, 0xB4, 0x3E, 0x50, 0x18,
+    0xE1, 0xE3, 0xE1, 0x8A, 0xD9, 0x05, 0xEB, 0x30, 0x01, 0xE3, 0xDD, 0x80, 0xD7, 0x0A, 0x56, 0xE9,
+    0x2B, 0xDE, 0xC9, 0xD3, 0xDD, 0xAB, 0x6B, 0x57, 0x0C, 0x3B, 0x26, 0x42, 0x4D, 0x79, 0xA9, 0x9E,
+    0xC8, 0x48, 0x1A, 0x53, 0x12, 0x3A, 0xA1, 0x95, 0x74, 0x9A, 0x82, 0x38, 0xEB, 0x49, 0x03, 0xAB,
+    0xA7, 0x37, 0x61, 0xD6, 0x8E, 0x1E, 0x35, 0x17, 0xD1, 0x70, 0x67, 0xE5, 0x7B, 0xD2, 0x9F, 0x80,
+    0x6A, 0x35, 0x22, 0x16, 0x84, 0xF2, 0x22, 0x64, 0x7B, 0xFB, 0xAF, 0x95, 0xE1, 0xD5, 0x84, 0x82,
+    0x88, 0xB7, 0x8B, 0x0E, 0x90, 0x74, 0x3F, 0x17, 0x62, 0x52, 0x11, 0xE2, 0x15, 0x17, 0x51, 0xE8,
+    0x4F, 0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F, 0x8E, 0x65, 0x29, 0x8D, 0x56, 0x52, 0xE8,
+    0x4F, 0xCB, 0x65, 0x29, 0x8D, 0x15, 0xD1, 0xE8, 0x4F, 0xCA, 0x65, 0x29, 0x8D, 0x75, 0x3E, 0x9D,
+    0x21, 0xAE, 0x16, 0x75, 0xFE, 0x72, 0x34, 0x9A, 0x2A, 0xA5, 0x54, 0x1F, 0xA3, 0x71, 0x30, 0x9E,
+    0xC1, 0x01, 0x00, 0x00, 0x22, 0x03, 0xA1, 0x09, 0x8C, 0x2D, 0x2A, 0x8D, 0x06, 0x06, 0xA9, 0x19,
+    0x8F, 0x03, 0x44, 0xF9, 0x26, 0x41, 0xE8, 0x4F, 0xCA, 0x64, 0x29, 0x8F, 0x06, 0x73, 0xBE, 0x4F,
+    0xCA, 0xED, 0x71, 0x8C, 0x06, 0x55, 0xE8, 0x5F, 0xCA, 0x01, 0x48, 0xF9, 0x67, 0x75, 0xEB, 0x4F,
+    0xCA, 0xF9, 0xE1, 0xD2, 0x27, 0x66, 0xE2, 0x45, 0x33, 0x5A, 0x08, 0x8A, 0x1D, 0xFE, 0xC8, 0x0D,
+    0xB3, 0x0B, 0xA7, 0x1D, 0x47, 0x7A, 0x2F, 0x90, 0x0C, 0x9C, 0x5E, 0x4B, 0x29, 0xB9, 0xCB, 0xA9,
+    0x2B, 0x6E, 0x18, 0x91, 0xEF, 0xD5, 0xB2, 0x38, 0x3D, 0x1D, 0x7A, 0x5C, 0xBF, 0x8A, 0xE4, 0x1E,
+    0x9E, 0xB1, 0xE8, 0xEF, 0xE3, 0x4B, 0x0B, 0x81, 0x26, 0x61, 0xDA, 0x69, 0xB6, 0x91, 0x98, 0xBB,
+    0xE4, 0x74, 0x8B, 0x0B, 0xC0, 0x20, 0x67, 0x6F, 0xF8, 0x34, 0xB4, 0x33, 0xA4, 0xF9, 0x86, 0xD0,
+    0xFA, 0xDA, 0x97, 0x20, 0x2F, 0x08, 0xE3, 0xAC, 0x64, 0xEA, 0xBA, 0xA8, 0xFF, 0xF7, 0xA5, 0xF9,
+    0x93, 0x9B, 0xF1, 0x3A, 0x9C, 0x12, 0x37, 0x5E, 0x1A, 0x90, 0x8D, 0x03, 0x3B, 0x32, 0x97, 0x42,
+    0x33, 0xFC, 0x2B, 0x88, 0xAF, 0xA9, 0x0F, 0x9E, 0x7F, 0xD5, 0x53, 0x15, 0xA5, 0x98, 0x68, 0xC5,
+    0x96, 0x9B, 0xD1, 0x07, 0xEE, 0xFA, 0xD3, 0x2B, 0xDE, 0xD3, 0xE3, 0x0D, 0x7E, 0x01, 0x79, 0xB7,
+    0xFE, 0xC9, 0xD0, 0x0C, 0xED, 0x21, 0x41, 0x56, 0x3C, 0x03, 0x3F, 0x6E, 0x9C, 0xE0, 0xF3, 0x86,
+    0x11, 0xF1, 0xA4, 0x53, 0xC6, 0x7E, 0x85, 0x2A, 0xEF, 0xD9, 0x65, 0xAE, 0x94, 0xC4, 0x5B, 0xF6,
+    0x25, 0x2C, 0xE5, 0x27, 0xCE, 0x1B, 0x33, 0x91, 0x97, 0x9B, 0xBA, 0x29, 0x2B, 0x3F, 0xB6, 0x18,
+    0x1B, 0xCA, 0x6F, 0x55, 0x30, 0x6C, 0xBD, 0x52, 0xCB, 0xBE, 0x61, 0xF1, 0x24, 0x07, 0x90, 0xA4,
+    0xFD, 0xF6, 0xFD, 0x34, 0x8B, 0x0F, 0x57, 0xDC, 0x86, 0x5D, 0xBB, 0xD8, 0xF8, 0x1A, 0x01, 0x83,
+    0xBB, 0x9E, 0x8D, 0x1B, 0xA6, 0x45, 0xCF, 0x0D, 0x15, 0x7C, 0x60, 0xB8, 0x7B, 0x85, 0xFC, 0xFF,
+    0x72, 0xB7, 0x84, 0x79, 0xF3, 0xA1, 0xAE, 0x34, 0xE9, 0x04, 0x3C, 0x61, 0x0D, 0x59, 0x26, 0xD0,
+    0x86, 0x23, 0x0E, 0x85, 0x82, 0x7B, 0xBD, 0xEE, 0x20, 0xCB, 0x21, 0x2C, 0xD2, 0x11, 0x47, 0xBA,
+    0x25, 0x63, 0x69, 0xE0, 0xAB, 0x2F, 0xE3, 0xEF, 0x71, 0x6A, 0x0B, 0x28, 0x0F, 0xAC, 0x65, 0xB9,
+    0x2C, 0x46, 0x91, 0x23, 0xCF, 0x7B, 0x5D, 0xA6, 0x65, 0x82, 0xFD, 0x78, 0x02, 0x33, 0xAE, 0xEF,
+    0xD6, 0x5E, 0x27, 0x7D, 0xEC, 0x7A, 0xE6, 0x56, 0x3F, 0x22, 0x61, 0xA8, 0x85, 0x4F, 0xA7, 0xD7,
+    0x56, 0xEF, 0x41, 0x93, 0x3F, 0x4B, 0xF8, 0x67, 0x17, 0xDA, 0x21, 0xE5, 0xB3, 0xE3, 0x3D, 0x2C,
+    0xCD, 0xD6, 0x24, 0xE8, 0x5C, 0x37, 0x54, 0xBC, 0xE6, 0xF2, 0x08, 0x4E, 0xA9, 0x56, 0x34, 0x82,
+    0x8A, 0x97, 0xDF, 0xDE, 0x07, 0x1F, 0x94, 0xE2, 0xB8, 0xA3, 0xFC, 0x59, 0xFC, 0x11, 0x66, 0xD1,
+    0x0A, 0x2A, 0xB6, 0xB2, 0x18, 0xE9, 0x3E, 0xB4, 0xD7, 0x4C, 0x6C, 0x9A, 0xEB, 0x6A, 0x04, 0x09,
+    0x7E, 0x88, 0x5C, 0x2A, 0x4A, 0xFF, 0xA7, 0x71, 0xDE, 0x20, 0x20, 0xC4, 0x13, 0x1C, 0x78, 0x67,
+    0x5F, 0x12, 0xC6, 0xCA, 0xDA, 0x17, 0x51, 0xE8, 0x4F, 0xE8, 0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8,
+    0x4F, 0x8E, 0x65, 0x29, 0x8D, 0x26, 0x53, 0xE8, 0x4F, 0xCB, 0x65, 0x29, 0x8D, 0x16, 0xD1, 0xE8,
+    0x4F, 0xCA, 0x65, 0x29, 0x8D, 0x75, 0x3E, 0x9D, 0x21, 0xAE, 0x16, 0x75, 0xE0, 0x69, 0x3F, 0x87,
+    0x77, 0xE4, 0x12, 0x48, 0xFB, 0x22, 0x02, 0x00, 0x00, 0x0E, 0x03, 0xA1, 0x09, 0x8C, 0x7D, 0x2B,
+    0x8D, 0x06, 0x06, 0xA9, 0x19, 0x8F, 0x03, 0x44, 0xF9, 0x26, 0x41, 0xE8, 0x4F, 0xCA, 0x64, 0x29,
+    0x8C, 0x06, 0x73, 0xBE, 0x4F, 0xCA, 0x47, 0x7F, 0x8D, 0x06, 0x50, 0xE8, 0x47, 0xCA, 0x01, 0x48,
+    0xF9, 0x67, 0xA5, 0xE9, 0x4F, 0xCA, 0x65, 0xFA, 0xE1, 0x16, 0x45, 0x33, 0xE7, 0x95, 0xAD, 0x51,
+    0xB6, 0x15, 0x70, 0x1A, 0xB3, 0xB0, 0xC9, 0x61, 0xD7, 0xFF, 0xEE, 0x55, 0x5E, 0x7B, 0x27, 0x4F,
+    0x65, 0x31, 0x22, 0x84, 0xFA, 0x75, 0xA4, 0x78, 0x26, 0x4A, 0x31, 0xEA, 0x14, 0x5D, 0x1C, 0x01,
+    0x31, 0x5A, 0xD1, 0x0A, 0x49, 0xBE, 0x14, 0xA0, 0xF6, 0x9B, 0xC4, 0x16, 0x3E, 0xBB, 0x1A, 0x78,
+    0x42, 0x5C, 0xEE, 0x24, 0x01, 0x59, 0x6A, 0x33, 0x43, 0xA1, 0xC4, 0xBC, 0x4C, 0xDD, 0x1F, 0xA8,
+    0x2C, 0xF4, 0xAC, 0x58, 0x16, 0x2E, 0x44, 0xA2, 0xFC, 0x2B, 0x75, 0x12, 0x9B, 0x2D, 0x44, 0xBC,
+    0x72, 0x1B, 0x54, 0x95, 0xEE, 0x8A, 0x9B, 0x62, 0xCD, 0xA6, 0x1A, 0xCF, 0x6D, 0xFD, 0xFE, 0x56,
+    0x2D, 0xAE, 0x00, 0x0C, 0xE6, 0x6F, 0xE8, 0x01, 0x12, 0x13, 0x86, 0x96, 0x23, 0xA2, 0xC9, 0xE4,
+    0x40, 0x3B, 0x3C, 0xEB, 0xC2, 0x7E, 0x9D, 0x22, 0xC8, 0xDE, 0x31, 0x7A, 0xF6, 0x65, 0x9A, 0xA6,
+    0xD6, 0x0B, 0x9E, 0x2C, 0x5B, 0xB8, 0x48, 0x30, 0xFC, 0x46, 0x1F, 0x17, 0x1C, 0xF9, 0xC3, 0xE2,
+    0x49, 0x0C, 0xCB, 0x08, 0xDA, 0x79, 0x64, 0x1E, 0x54, 0xD4, 0xEB, 0xBE, 0x58, 0xC0, 0x18, 0x7D,
+    0xAB, 0xDC, 0x57, 0x18, 0xC0, 0xF4, 0xC5, 0x5C, 0x56, 0x7E, 0x3B, 0xEF, 0x5A, 0x23, 0x29, 0x5C,
+    0xE9, 0x80, 0x45, 0x53, 0xBD, 0x4E, 0x2B, 0x1E, 0x57, 0xB2, 0x07, 0xD3, 0x87, 0x11, 0x11, 0x30,
+    0xC3, 0xFA, 0xFF, 0x58, 0x17, 0x82, 0x06, 0x6A, 0x65, 0x6C, 0xD9, 0x9C, 0x98, 0x40, 0xAA, 0x74,
+    0x45, 0x09, 0xB0, 0x0E, 0xBE, 0x9F, 0x74, 0x3F, 0xF2, 0x62, 0xCD, 0x13, 0xD7, 0x9B, 0x48, 0x88,
+    0x0E, 0xC7, 0xAB, 0xB6, 0x23, 0x86, 0x20, 0x46, 0x21, 0x70, 0x92, 0x8C, 0xD2, 0xF8, 0xBB, 0x27,
+    0x66, 0x0E, 0x39, 0x14, 0x86, 0xC4, 0x8D, 0xBD, 0xCA, 0x80, 0x5E, 0x7D, 0x8A, 0x4F, 0xAA, 0xF5,
+    0xA6, 0xD9, 0xE8, 0xF4, 0xCC, 0x1F, 0x5E, 0x0C, 0x89, 0x76, 0x4C, 0xEF, 0x9D, 0x04, 0x45, 0x71,
+    0x5B, 0x80, 0x79, 0x7B, 0x7A, 0xC6, 0xB0, 0xAC, 0xCF, 0xEB, 0x21, 0xAB, 0xE7, 0x2E, 0x66, 0x4E,
+    0x96, 0x71, 0xD2, 0xC9, 0x21, 0x17, 0x3A, 0xA8, 0x51, 0x29, 0x4A, 0x2E, 0x13, 0x95, 0xE1, 0x9A,
+    0x74, 0x4B, 0x91, 0xB5, 0x38, 0x58, 0x98, 0x63, 0x61, 0xDA, 0x9F, 0x94, 0x9A, 0x7E, 0xB0, 0xE2,
+    0xB7, 0x6A, 0x2E, 0x22, 0x24, 0x3C, 0x2C, 0x3E, 0x99, 0xFD, 0x57, 0x18, 0x64, 0x42, 0x70, 0x72,
+    0x57, 0x6B, 0x82, 0x4D, 0xEB, 0x2F, 0xF8, 0x8B, 0xD3, 0x0B, 0x4F, 0xDD, 0xA0, 0x6B, 0xAD, 0x4E,
+    0xA7, 0x6A, 0xF3, 0xF4, 0x0D, 0x09, 0x41, 0x6A, 0xD5, 0x1B, 0xFF, 0xD5, 0xE7, 0x87, 0xCF, 0xB5,
+    0x57, 0xCB, 0xA0, 0xDE, 0xC0, 0x6A, 0x9B, 0x9E, 0xB8, 0x85, 0xB6, 0x09, 0x2A, 0x68, 0x1A, 0x9B,
+    0x10, 0x85, 0x2A, 0x3E, 0x24, 0x3E, 0x09, 0x24, 0xA0, 0x70, 0x4F, 0xE5, 0x95, 0xFB, 0x59, 0x1D,
+    0x3C, 0x93, 0x35, 0x4F, 0xEF, 0xF7, 0xD5, 0x03, 0x18, 0xF0, 0xA2, 0x44, 0xF4, 0x36, 0xC1, 0xA8,
+    0xA5, 0x38, 0x37, 0x30, 0x83, 0xDE, 0xF6, 0x88, 0x4A, 0x31, 0x19, 0xE8, 0xE1, 0x2D, 0x5C, 0x35,
+    0xC3, 0xA0, 0x2E, 0xCE, 0x19, 0x76, 0x4A, 0xFB, 0xE2, 0x25, 0x5B, 0x7F, 0xF2, 0xCD, 0x32, 0xE6,
+    0x3A, 0xCF, 0xEF, 0x55, 0xD7, 0x6A, 0x18, 0x75, 0x6E, 0x2B, 0x2D, 0x41, 0x5C, 0xA6, 0xD0, 0x80,
+    0xD3, 0x06, 0x9E, 0xF5, 0x89, 0x18, 0xCC, 0x93, 0x1A, 0x17, 0x13, 0x6B, 0xD1, 0x44, 0x7E, 0x60,
+    0x67, 0x36, 0x67, 0xA2, 0x42, 0xCD, 0x5C, 0x01, 0x62, 0x3E, 0xE9, 0x17, 0x51, 0xE8, 0x4F, 0xE8,
+    0x65, 0x29, 0x8D, 0x35, 0x51, 0xE8, 0x4F, 0x8E, 0x65, 0x29, 0x8D, 0x86, 0x69, 0xE9, 0x4F, 0xC9,
+    0x65, 0x29, 0x8D, 0x15, 0x51, 0xE8, 0x4F, 0xCA, 0x65, 0x29, 0x8D, 0x75, 0x3E, 0x9D, 0x21, 0xAE,
+    0x16, 0x75, 0xFE, 0x6F, 0x3D, 0x8D, 0x21, 0xA9, 0x00, 0x11, 0xA3, 0x71, 0x30, 0x9E, 0xBA, 0x07,
+    0x00, 0x00, 0x0C, 0x54, 0x18, 0xAE, 0x09, 0xB2, 0x5D, 0x28, 0x8D, 0x51, 0x10, 0xBE, 0x0A, 0xAC,
+    0x08, 0x5D, 0xAD, 0x16, 0x51, 0xE8, 0x4F, 0xCB, 0x65, 0x28, 0x8D, 0x24, 0x07, 0xE8, 0x4F, 0xE8,
+    0x33, 0x29, 0x8D, 0x07, 0x51, 0xE0, 0x4F, 0xAE, 0x04, 0x5D, 0xEC, 0x52, 0x69, 0xE9, 0x4F, 0x01,
+    0x80, 0x00, 0x00, 0x0F, 0x90, 0x80, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, 0x80, 0x81,
+    0x82, 0x83, 0x84, 0x85, 0x86, 0x7F, 0xFF, 0x87, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x03, 0x00, 0x0F,
+    0x90, 0x80, 0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x0F, 0x90, 0x80,
+    0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x0F, 0x90, 0x80, 0xFF, 0xFF,
+    0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x02, 0xC4, 0x80, 0x8E, 0x07, 0xBA, 0x07,
+    0x0C, 0x01, 0x80, 0x00, 0x00, 0x0C, 0xBC, 0x80, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x7F, 0xFF, 0x87, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x03,
+    0x00, 0x0F, 0x90, 0x80, 0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x0F,
+    0x90, 0x80, 0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x0F, 0x90, 0x80,
+    0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x01, 0x00, 0x05, 0xC4, 0x80, 0xC8, 0x03,
+    0x8E, 0x07, 0x0C, 0x01, 0x80, 0x00, 0x00, 0x09, 0xBC, 0x80, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D,
+    0x7E, 0x7F, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x7F, 0xFF, 0x87, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x03, 0x00, 0x0F, 0x90, 0x80, 0xFF, 0xFF, 0xFC, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0xFF, 0xFF,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0xFF, 0xF0, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F,
+    0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0F, 0x01, 0x0B, 0xC3, 0x55, 0xF8, 0x4F, 0x8F, 0x6D,
+    0x29, 0x8D, 0x73, 0x59, 0xE8, 0x4F, 0x99, 0x2A, 0x7C, 0xC3, 0x42, 0x02, 0xB4, 0x02, 0x85, 0x2B,
+    0x66, 0xB5, 0x28, 0x06, 0xA9, 0x19, 0x3E, 0x61, 0x38, 0x8D, 0xBB, 0x55, 0xE8, 0x4F, 0x24, 0x61,
+    0x29, 0x8D, 0x49, 0x04, 0xA6, 0x0B, 0x99, 0x39, 0x64, 0xC2, 0x48, 0x1E, 0xD9, 0x79, 0xE4, 0x32,
+    0x68, 0xDB, 0x23, 0x54, 0xF9, 0x4F, 0xD6, 0x66, 0x29, 0x8D, 0x4B, 0x52, 0xE8, 0x4F, 0x83, 0x3D,
+    0x7D, 0xD8, 0x54, 0x14, 0xBB, 0x13, 0x98, 0x30, 0x67, 0xDE, 0x28, 0x13, 0xA1, 0x01, 0x83, 0x60,
+    0x38, 0x8D, 0x12, 0x50, 0xE8, 0x4F, 0x8F, 0x64, 0x29, 0x8D, 0x4F, 0x09, 0xBC, 0x1A, 0x98, 0x20,
+    0x7A, 0xD1, 0x52, 0x14, 0xB0, 0x1B, 0xE4, 0x31, 0x71, 0xD9, 0x8B, 0x54, 0xFB, 0x4F, 0x87, 0x63,
+    0x29, 0x8D, 0x86, 0x57, 0xE8, 0x4F, 0x84, 0x21, 0x7A, 0xD1, 0x55, 0x05, 0xAD, 0x1D, 0x8F, 0x2A,
+    0x18, 0xBB, 0x28, 0x06, 0xA9, 0x19, 0x45, 0x60, 0x3A, 0x8D, 0x9D, 0x5B, 0xE8, 0x4F, 0x04, 0x6F,
+    0x29, 0x8D, 0x48, 0x15, 0xBB, 0x13, 0x99, 0x2C, 0x65, 0xC8, 0x48, 0x12, 0xAD, 0x77, 0xE4, 0x32,
+    0x68, 0xDB, 0xA8, 0x54, 0xFB, 0x4F, 0xDE, 0x65, 0x29, 0x8D, 0x41, 0x51, 0xE8, 0x4F, 0x9E, 0x30,
+    0x7B, 0xC8, 0x55, 0x0D, 0xBB, 0x1B, 0x85, 0x37, 0x6C, 0xC9, 0x28, 0x13, 0xA1, 0x01
+};
+
+/*----------------------------------------------------------------------------
+ * Sets 'error' to 'what' went wrong with 'fixture'.
+ *--------------------------------------------------------------------------*/
+static void SetFixtureError(char error[ERROR_LENGTH], const char *what, const DECODE_FIXTURE *fixture, DWORD viewSize) {
+    _snprintf(error, ERROR_LENGTH - 1, "%s %s (window %u)", what, fixture->name, viewSize);
+    error[ERROR_LENGTH - 1] = '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * Reads through 'reader' from its current position to the end into
+ * 'buffer', which holds 'size' bytes and one more. Returns the number of
+ * bytes read.
+ *--------------------------------------------------------------------------*/
+static DWORD ReadToEnd(DTA_READER *reader, char *buffer, DWORD size) {
+    DWORD total = 0;
+    DWORD piece = 0;
+
+    for(;;) {
+        DWORD n     = pieceSizes[piece++ % NUM_OF_PIECE_SIZES];
+        DWORD read  = DtaRead(reader, buffer + total, min(n, size - total + 1));
+
+        if(read == 0 || (total += read) > size)
+            return total;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Opens the fixture archive, mapped whole if 'viewSize' is 0 and in windows
+ * otherwise, and reads every fixture back. 'whole' and 'pieces' hold the
+ * largest fixture and one byte more.
+ *--------------------------------------------------------------------------*/
+static BOOL CheckFixtures(DWORD viewSize, char *whole, char *pieces, char error[ERROR_LENGTH]) {
+    DTA_OPEN_OPTIONS    openOptions = { 0 };
+    DTA_ARCHIVE         *dta;
+    DWORD               i;
+    BOOL                result      = TRUE;
+
+    openOptions.viewSize = viewSize;
+
+    if((dta = DtaOpenArchiveEx(CHECK_DECODE_ARCHIVE, CHECK_DECODE_KEY1, CHECK_DECODE_KEY2, &openOptions, error)) == NULL)
+        return FALSE;
+
+    for(i = 0; result && i < CHECK_DECODE_FIXTURES; ++i) {
+        const DECODE_FIXTURE    *fixture    = &fixtures[i];
+        DWORD                   middle      = fixture->fileSize / 2;
+        DTA_ENTRY_INFO          info;
+        DTA_READER              reader;
+
+        if(!DtaFindEntry(dta, fixture->name, &info)) {
+            SetFixtureError(error, "Could not find", fixture, viewSize);
+            result = FALSE;
+            break;
+        }
+
+        if(info.fileSize != fixture->fileSize ||
+           DtaReadEntry(dta, &info, 0, whole, fixture->fileSize + 1) != fixture->fileSize ||
+           Hash64(whole, fixture->fileSize, 0) != fixture->hash) {
+            SetFixtureError(error, "Decoded wrong", fixture, viewSize);
+            result = FALSE;
+            break;
+        }
+
+        DtaOpenReader(dta, &info, &reader);
+
+        if(ReadToEnd(&reader, pieces, fixture->fileSize) != fixture->fileSize ||
+           memcmp(pieces, whole, fixture->fileSize) != 0) {
+            SetFixtureError(error, "Decoded wrong in pieces", fixture, viewSize);
+            result = FALSE;
+        }
+
+        /* The reader has to pick up in the middle of a block */
+        DtaSeek(&reader, middle, SEEK_SET);
+
+        if(result && (ReadToEnd(&reader, pieces, fixture->fileSize - middle) != fixture->fileSize - middle ||
+                      memcmp(pieces, whole + middle, fixture->fileSize - middle) != 0)) {
+            SetFixtureError(error, "Decoded wrong after a seek in", fixture, viewSize);
+            result = FALSE;
+        }
+
+        DtaCloseReader(&reader);
+    }
+
+    DtaCloseArchive(dta);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the fixture archive to CHECK_DECODE_ARCHIVE and decodes every file
+ * of it through libdta. If a file can't be found or differs from what
+ * tmp.dll returned, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          error           Error string
+ *
+ *  Returns TRUE if every file matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckDecoder(char error[ERROR_LENGTH]) {
+    HANDLE  hFile;
+    DWORD   written;
+    DWORD   largest = 0;
+    DWORD   i;
+    char    *whole;
+    char    *pieces;
+    BOOL    result;
+
+    hFile = CreateFile(CHECK_DECODE_ARCHIVE, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE) {
+        strncpy_s(error, ERROR_LENGTH, "Could not create " CHECK_DECODE_ARCHIVE, ERROR_LENGTH);
+        return FALSE;
+    }
+
+    result = WriteFile(hFile, fixtureArchive, sizeof(fixtureArchive), &written, NULL) && written == sizeof(fixtureArchive);
+    CloseHandle(hFile);
+
+    if(!result) {
+        strncpy_s(error, ERROR_LENGTH, "Could not write " CHECK_DECODE_ARCHIVE, ERROR_LENGTH);
+        DeleteFile(CHECK_DECODE_ARCHIVE);
+        return FALSE;
+    }
+
+    for(i = 0; i < CHECK_DECODE_FIXTURES; ++i)
+        largest = max(largest, fixtures[i].fileSize);
+
+    /* One byte more, so that a read returning too much is caught */
+    whole   = (char *)malloc(largest + 1);
+    pieces  = (char *)malloc(largest + 1);
+
+    if(whole == NULL || pieces == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the decoder check", ERROR_LENGTH);
+        result = FALSE;
+    }
+    else
+        result = CheckFixtures(0, whole, pieces, error) && CheckFixtures(CHECK_DECODE_VIEW_SIZE, whole, pieces, error);
+
+    DeleteFile(CHECK_DECODE_ARCHIVE);
+
+    free(whole);
+    free(pieces);
+
+    return result;
+}
@@ -0,0 +1,38 @@
+/*  Description:
+ *      Check of the block decoder against fixtures. A small archive is kept in
+ *      DecodeCheck.c as it is, with one file of every kind of block the game
+ *      stores: stored, LZ77 in one and in several blocks, 16-bit sounds in
+ *      mono and stereo, and 8-bit sounds stored and with LZ77. Some of the
+ *      files are encrypted and some are not. The size and the XXH64 of every
+ *      file are what tmp.dll returned for it.
+ *
+ *      Every file is read through DtaReadEntry() and through a DTA_READER in
+ *      pieces of changing sizes and after a seek, once with the archive mapped
+ *      whole and once mapped in windows, which decode along different paths.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DECODE_CHECK_H_
+#define DECODE_CHECK_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/* Number of files in the fixture archive */
+#define CHECK_DECODE_FIXTURES   7
+
+/* Where the fixture archive is written while it is checked */
+#define CHECK_DECODE_ARCHIVE    "decode_check.dta"
+
+/*----------------------------------------------------------------------------
+ * Writes the fixture archive to CHECK_DECODE_ARCHIVE and decodes every file
+ * of it through libdta. If a file can't be found or differs from what
+ * tmp.dll returned, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          error           Error string
+ *
+ *  Returns TRUE if every file matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckDecoder(char error[ERROR_LENGTH]);
+
+#endif
@@ -0,0 +1,397 @@
+/*  Description:
+ *      Implementation of the synthetic archive generator. File contents are
+ *      pseudo-random so that runs with the same seed produce identical archives,
+ *      with runs and repeats in between for LZ77 to find. The LZ77 encoder is
+ *      greedy and only looks at the last position of every 3-byte hash.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Generator.h"
+#include "DTAFormat.h"
+
+/* Largest stored size of a generated block, LZ77 of data it can't shorten */
+#define GEN_MAX_STORED      (1 + DTA_BLOCK_SIZE + DTA_BLOCK_SIZE / 8 + 2)
+
+/* Entries of the hash table of the LZ77 encoder */
+#define GEN_LZ_HASH_SIZE    4096
+
+/* No position for a hash yet */
+#define GEN_LZ_NONE         0xFFFFFFFF
+
+/*
+ * Buffers of the block encoder.
+ */
+typedef struct t_genblocks {
+    unsigned char   *stored;            /* GEN_MAX_STORED bytes */
+    DWORD           *heads;             /* GEN_LZ_HASH_SIZE positions */
+} GEN_BLOCKS;
+
+/*----------------------------------------------------------------------------
+ * Returns the next number of a xorshift sequence.
+ *
+ *  Arguments:      state           Generator state, must not be 0
+ *--------------------------------------------------------------------------*/
+static unsigned int NextRandom(unsigned int *state) {
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return *state = x;
+}
+
+/*----------------------------------------------------------------------------
+ * Picks the size of the next file according to 'options'.
+ *--------------------------------------------------------------------------*/
+static DWORD NextFileSize(const GEN_OPTIONS *options, unsigned int *state) {
+    double u;
+
+    switch(options->sizeDistribution) {
+    case GEN_SIZE_UNIFORM:
+        return options->minSize + NextRandom(state) % (options->maxSize - options->minSize + 1);
+
+    case GEN_SIZE_LOG:
+        u = (double)NextRandom(state) / 4294967295.0;
+        return (DWORD)((options->minSize + 1) * pow((double)(options->maxSize + 1) / (options->minSize + 1), u)) - 1;
+
+    default:
+        return options->maxSize;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Builds the path of file number 'index', using backslashes like the game
+ * archives do.
+ *--------------------------------------------------------------------------*/
+static void NextFilename(const GEN_OPTIONS *options, unsigned int *state, DWORD index, char filename[256]) {
+    DWORD depth = options->pathDepth ? NextRandom(state) % (options->pathDepth + 1) : 0;
+    int   length = 0;
+
+    while(depth--)
+        length += _snprintf(filename + length, 256 - length, "dir%02u\\", NextRandom(state) % options->dirsPerLevel);
+
+    _snprintf(filename + length, 256 - length, "file%05u.bin", index);
+    filename[255] = '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * Sets the flag of token 'token' in the flags word at 'flags', highest bit
+ * first.
+ *--------------------------------------------------------------------------*/
+static void SetLzFlag(unsigned char *flags, DWORD token) {
+    flags[token / 8] |= (unsigned char)(0x80 >> (token % 8));
+}
+
+/*----------------------------------------------------------------------------
+ * Encodes 'size' bytes of 'in' as an LZ77 block into 'out', see Decode.c for
+ * the format. Returns the stored size of the block.
+ *--------------------------------------------------------------------------*/
+static DWORD EncodeLz(const unsigned char *in, DWORD size, unsigned char *out, DWORD *heads) {
+    DWORD flags     = 1;
+    DWORD tokens    = 0;
+    DWORD o         = 3;
+    DWORD i         = 0;
+
+    out[0] = DTA_BLOCK_LZ;
+    out[1] = out[2] = 0;
+
+    memset(heads, 0xFF, GEN_LZ_HASH_SIZE * sizeof(DWORD));
+
+    while(i < size) {
+        DWORD run;
+        DWORD length = 0;
+
+        if(tokens == 16) {
+            flags   = o;
+            tokens  = 0;
+            out[o++] = 0;
+            out[o++] = 0;
+        }
+
+        for(run = 1; i + run < size && in[i + run] == in[i] && run < 4111; ++run)
+            ;
+
+        if(run >= 16) {
+            SetLzFlag(out + flags, tokens);
+            out[o++] = 0;
+            out[o++] = (unsigned char)((run - 16) >> 8);
+            out[o++] = (unsigned char)(run - 16);
+            out[o++] = in[i];
+            i += run;
+        } else {
+            DWORD candidate = GEN_LZ_NONE;
+
+            if(size - i >= 3) {
+                DWORD hash = ((in[i] << 8) ^ (in[i + 1] << 4) ^ in[i + 2]) % GEN_LZ_HASH_SIZE;
+
+                candidate   = heads[hash];
+                heads[hash] = i;
+            }
+
+            if(candidate != GEN_LZ_NONE && i - candidate < 4096) {
+                while(length < 18 && i + length < size && in[candidate + length] == in[i + length])
+                    ++length;
+            }
+
+            if(length >= 3) {
+                DWORD distance = i - candidate;
+
+                SetLzFlag(out + flags, tokens);
+                out[o++] = (unsigned char)(distance >> 4);
+                out[o++] = (unsigned char)(((distance & 0x0F) << 4) | (length - 3));
+                i += length;
+            } else {
+                out[o++] = in[i++];
+            }
+        }
+
+        ++tokens;
+    }
+
+    return o;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes 'fileSize' bytes of 'data' to 'hFile' as the blocks of file number
+ * 'index', and adds their size to 'offset'. Returns FALSE if writing fails
+ * or the archive would grow past 4 GB, leaving room for 'reserved' bytes.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteBlocks(HANDLE hFile, const GEN_OPTIONS *options, GEN_BLOCKS *blocks, DWORD index, const char *data,
+                        DWORD fileSize, DWORD *offset, unsigned __int64 reserved) {
+    DTA_BLOCK_HEADER    header = { 0 };
+    DWORD               pos;
+
+    for(pos = 0; pos < fileSize; pos += DTA_BLOCK_SIZE) {
+        const unsigned char *in     = (const unsigned char *)data + pos;
+        DWORD               size    = min(fileSize - pos, DTA_BLOCK_SIZE);
+        DWORD               written;
+
+        if(index % 3 == 1) {
+            header.storedSize = (WORD)EncodeLz(in, size, blocks->stored, blocks->heads);
+        } else {
+            blocks->stored[0] = (unsigned char)(index % 3 == 0 ? 0 : 2 + index / 3 % 6);
+            memcpy(blocks->stored + 1, in, size);
+            header.storedSize = (WORD)(1 + size);
+        }
+
+        if(*offset + sizeof(DTA_BLOCK_HEADER) + (unsigned __int64)header.storedSize + reserved > 0xFFFFFFFF)
+            return FALSE;
+
+        if(GEN_FILE_ENCRYPTED(index))
+            Decrypt(blocks->stored, header.storedSize, options->key1, options->key2);
+
+        if(!WriteFile(hFile, &header, sizeof(DTA_BLOCK_HEADER), &written, NULL) ||
+           !WriteFile(hFile, blocks->stored, header.storedSize, &written, NULL) || written != header.storedSize)
+            return FALSE;
+
+        *offset += sizeof(DTA_BLOCK_HEADER) + header.storedSize;
+        header.previousSize = header.storedSize;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Encrypts 'n' bytes of 'buffer' and writes them to 'hFile'.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteEncrypted(HANDLE hFile, void *buffer, DWORD n, const GEN_OPTIONS *options) {
+    DWORD written;
+
+    /* XOR is its own inverse */
+    Decrypt(buffer, n, options->key1, options->key2);
+
+    return WriteFile(hFile, buffer, n, &written, NULL) && written == n;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the contents of the archive to 'hFile'. 'contentHeaders' must have
+ * room for every file, and 'data' for the largest file.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteArchive(HANDLE hFile, const GEN_OPTIONS *options, DTA_CONTENT_HEADER *contentHeaders, char *data, GEN_BLOCKS *blocks,
+                         char error[ERROR_LENGTH]) {
+    DTA_HEADER      header      = { 0 };
+    LARGE_INTEGER   headerPos;
+    GEN_STATE       state;
+    DWORD           identifier  = TRUE_DTA_IDENTIFIER;
+    DWORD           offset      = sizeof(DWORD) + sizeof(DTA_HEADER);
+    DWORD           written;
+    DWORD           fileSize;
+    DWORD           i;
+    char            name[256];
+
+    /* The header is rewritten once the content table offset is known */
+    if(!WriteFile(hFile, &identifier, sizeof(DWORD), &written, NULL) ||
+       !WriteFile(hFile, &header, sizeof(DTA_HEADER), &written, NULL)) {
+        strncpy_s(error, ERROR_LENGTH, "Writing the archive failed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    InitGenerator(&state, options);
+
+    for(i = 0; NextGeneratedFile(&state, name, data, &fileSize); ++i) {
+        DTA_FILE_HEADER fileHeader  = { 0 };
+        char            *baseName;
+        DWORD           nameLength  = (DWORD)strlen(name);
+
+        fileHeader.fileSize         = fileSize;
+        fileHeader.numOfBlocks      = (fileSize + DTA_BLOCK_SIZE - 1) / DTA_BLOCK_SIZE;
+        fileHeader.filenameLength   = (WORD)(nameLength | (GEN_FILE_ENCRYPTED(i) ? DTA_FILE_ENCRYPTED : 0));
+
+        /* The hint holds the start of the file's own name */
+        baseName = strrchr(name, '\\') ? strrchr(name, '\\') + 1 : name;
+        memcpy(contentHeaders[i].filename, baseName, min(strlen(baseName), sizeof(contentHeaders[i].filename)));
+        contentHeaders[i].fileOffset = offset;
+
+        offset += sizeof(DTA_FILE_HEADER) + nameLength;
+
+        /* Offsets inside of an archive are 32-bit, WriteBlocks stops short of 4 GB */
+        if(!WriteEncrypted(hFile, &fileHeader, sizeof(DTA_FILE_HEADER), options) ||
+           !WriteEncrypted(hFile, name, nameLength, options) ||
+           !WriteBlocks(hFile, options, blocks, i, data, fileSize, &offset,
+                        sizeof(DTA_CONTENT_HEADER) * (unsigned __int64)options->numOfFiles)) {
+            strncpy_s(error, ERROR_LENGTH, "Writing the archive failed, or it would be larger than 4 GB", ERROR_LENGTH);
+            return FALSE;
+        }
+    }
+
+    header.numOfFiles       = options->numOfFiles;
+    header.contentOffset    = offset;
+    header.contentSize      = sizeof(DTA_CONTENT_HEADER) * options->numOfFiles;
+    headerPos.QuadPart      = sizeof(DWORD);
+
+    /* Write the table, then go back and fill in the header */
+    if(!WriteEncrypted(hFile, contentHeaders, sizeof(DTA_CONTENT_HEADER) * options->numOfFiles, options) ||
+       !SetFilePointerEx(hFile, headerPos, NULL, FILE_BEGIN) ||
+       !WriteEncrypted(hFile, &header, sizeof(DTA_HEADER), options)) {
+        strncpy_s(error, ERROR_LENGTH, "Writing the archive failed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'options' with a small archive of mixed file sizes, encrypted with
+ * the Sounds.dta keys.
+ *
+ *  Arguments:      options         Options to fill
+ *--------------------------------------------------------------------------*/
+void DefaultGenOptions(GEN_OPTIONS *options) {
+    options->numOfFiles         = 10000;
+    options->minSize            = 0;
+    options->maxSize            = 256 * 1024;
+    options->sizeDistribution   = GEN_SIZE_LOG;
+    options->pathDepth          = 3;
+    options->dirsPerLevel       = 8;
+    options->key1               = 0x8D2965CA;
+    options->key2               = 0x4FE85106;
+    options->seed               = 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes a synthetic archive to 'filename'. If any errors occur, 'error' is
+ * set and the function returns FALSE.
+ *
+ *  Arguments:      filename        Archive to create
+ *                  options         Description of the archive
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL GenerateArchive(char *filename, const GEN_OPTIONS *options, char error[ERROR_LENGTH]) {
+    HANDLE              hFile;
+    DTA_CONTENT_HEADER  *contentHeaders;
+    GEN_BLOCKS          blocks;
+    char                *data;
+    BOOL                result;
+
+    if(options->minSize > options->maxSize || options->dirsPerLevel == 0) {
+        strncpy_s(error, ERROR_LENGTH, "Invalid generator options", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    contentHeaders  = (DTA_CONTENT_HEADER *)calloc(options->numOfFiles + 1, sizeof(DTA_CONTENT_HEADER));
+    data            = (char *)malloc(options->maxSize + 1);
+    blocks.stored   = (unsigned char *)malloc(GEN_MAX_STORED);
+    blocks.heads    = (DWORD *)malloc(GEN_LZ_HASH_SIZE * sizeof(DWORD));
+
+    if(contentHeaders == NULL || data == NULL || blocks.stored == NULL || blocks.heads == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the generator", ERROR_LENGTH);
+        result = FALSE;
+    } else if((hFile = CreateFile(filename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE) {
+        strncpy_s(error, ERROR_LENGTH, "Could not create the archive", ERROR_LENGTH);
+        result = FALSE;
+    } else {
+        result = WriteArchive(hFile, options, contentHeaders, data, &blocks, error);
+        CloseHandle(hFile);
+    }
+
+    free(contentHeaders);
+    free(data);
+    free(blocks.stored);
+    free(blocks.heads);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Starts a walk over the files of the archive 'options' describes. The
+ * walk produces the same names and contents GenerateArchive writes, so a
+ * generated archive can be checked without keeping its files in memory.
+ *
+ *  Arguments:      state           State to initialize
+ *                  options         Description of the archive
+ *--------------------------------------------------------------------------*/
+void InitGenerator(GEN_STATE *state, const GEN_OPTIONS *options) {
+    state->options  = options;
+    state->random   = options->seed ? options->seed : 1;
+    state->next     = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Produces the next file of a walk. Returns FALSE once every file was
+ * produced.
+ *
+ *  Arguments:      state           State from InitGenerator
+ *                  filename        Receives the name of the file
+ *                  data            Receives the plain contents, must hold
+ *                                  'maxSize' bytes
+ *                  fileSize        Receives the size of the file
+ *--------------------------------------------------------------------------*/
+BOOL NextGeneratedFile(GEN_STATE *state, char filename[256], char *data, DWORD *fileSize) {
+    DWORD i;
+
+    if(state->next >= state->options->numOfFiles)
+        return FALSE;
+
+    NextFilename(state->options, &state->random, state->next++, filename);
+    *fileSize = NextFileSize(state->options, &state->random);
+
+    for(i = 0; i < *fileSize; ) {
+        unsigned int    r = NextRandom(&state->random);
+        DWORD           n;
+
+        if((r & 63) == 0) {
+            /* A run of the same byte */
+            n = min(16 + (r >> 8) % 100, *fileSize - i);
+            memset(data + i, (char)(r >> 24), n);
+            i += n;
+        } else if((r & 63) == 1 && i > 0) {
+            /* A repeat of earlier bytes */
+            DWORD distance = 1 + (r >> 8) % min(i, 4095);
+
+            for(n = min(3 + (r >> 20) % 16, *fileSize - i); n > 0; --n, ++i)
+                data[i] = data[i - distance];
+        } else {
+            data[i++] = (char)(r >> 8);
+        }
+    }
+
+    return TRUE;
+}
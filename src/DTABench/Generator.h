@@ -0,0 +1,95 @@
+/*  Description:
+ *      Generator for synthetic ISD0 archives. The archives are laid out the same
+ *      way the game archives are: the magic identifier and DTA_HEADER, then
+ *      every file (file header, filename and blocks), then the content table.
+ *      Everything except the identifier and the block headers is encrypted
+ *      with the given keys, except the blocks of every fourth file.
+ *
+ *      The blocks of a file are stored as they are (type 0, or types 2 to 7)
+ *      or with LZ77, taking turns from one file to the next, so that every
+ *      decoder but the one for sounds is used. Sounds can't be generated;
+ *      DecodeCheck.h has fixtures of them.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/* How file sizes are picked between 'minSize' and 'maxSize' */
+#define GEN_SIZE_FIXED          0       /* Every file is 'maxSize' bytes */
+#define GEN_SIZE_UNIFORM        1       /* Evenly spread */
+#define GEN_SIZE_LOG            2       /* Mostly small files, a few large ones */
+
+/* The blocks of every fourth file are not encrypted */
+#define GEN_FILE_ENCRYPTED(index)   ((index) % 4 != 3)
+
+/*
+ * Describes the archive to generate.
+ */
+typedef struct t_genoptions {
+    DWORD           numOfFiles;
+    DWORD           minSize;
+    DWORD           maxSize;
+    int             sizeDistribution;
+    DWORD           pathDepth;          /* Maximum number of directories in a path */
+    DWORD           dirsPerLevel;       /* Different directory names per level */
+    unsigned int    key1;
+    unsigned int    key2;
+    unsigned int    seed;
+} GEN_OPTIONS;
+
+/*
+ * Position of a walk over the files of an archive, see NextGeneratedFile.
+ */
+typedef struct t_genstate {
+    const GEN_OPTIONS   *options;
+    unsigned int        random;
+    DWORD               next;           /* Number of the next file */
+} GEN_STATE;
+
+/*----------------------------------------------------------------------------
+ * Fills 'options' with a small archive of mixed file sizes, encrypted with
+ * the Sounds.dta keys.
+ *
+ *  Arguments:      options         Options to fill
+ *--------------------------------------------------------------------------*/
+void DefaultGenOptions(GEN_OPTIONS *options);
+
+/*----------------------------------------------------------------------------
+ * Writes a synthetic archive to 'filename'. If any errors occur, 'error' is
+ * set and the function returns FALSE.
+ *
+ *  Arguments:      filename        Archive to create
+ *                  options         Description of the archive
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL GenerateArchive(char *filename, const GEN_OPTIONS *options, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Starts a walk over the files of the archive 'options' describes. The
+ * walk produces the same names and contents GenerateArchive writes, so a
+ * generated archive can be checked without keeping its files in memory.
+ *
+ *  Arguments:      state           State to initialize
+ *                  options         Description of the archive
+ *--------------------------------------------------------------------------*/
+void InitGenerator(GEN_STATE *state, const GEN_OPTIONS *options);
+
+/*----------------------------------------------------------------------------
+ * Produces the next file of a walk. Returns FALSE once every file was
+ * produced.
+ *
+ *  Arguments:      state           State from InitGenerator
+ *                  filename        Receives the name of the file
+ *                  data            Receives the plain contents, must hold
+ *                                  'maxSize' bytes
+ *                  fileSize        Receives the size of the file
+ *--------------------------------------------------------------------------*/
+BOOL NextGeneratedFile(GEN_STATE *state, char filename[256], char *data, DWORD *fileSize);
+
+#endif
@@ -0,0 +1,213 @@
+/*  Description:
+ *      Implementation of the libdta round trip. The expected contents are
+ *      produced again by walking the generator, so only a single file has to
+ *      be held in memory.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NativeCheck.h"
+#include "Dta.h"
+
+/* Sizes of the pieces a file is read in, taken in turn */
+static const DWORD pieceSizes[] = { 1, 7, 64, 4093, 65536, 1048576 };
+
+#define NUM_OF_PIECE_SIZES  (sizeof(pieceSizes) / sizeof(pieceSizes[0]))
+
+/*----------------------------------------------------------------------------
+ * Reads through 'reader' from its current position to the end into
+ * 'buffer', in pieces of changing sizes. Returns the number of bytes read;
+ * a read past the end must return nothing.
+ *--------------------------------------------------------------------------*/
+static DWORD ReadToEnd(DTA_READER *reader, char *buffer, DWORD size, DWORD piece) {
+    DWORD total = 0;
+
+    for(;;) {
+        DWORD n     = pieceSizes[piece++ % NUM_OF_PIECE_SIZES];
+        DWORD read  = DtaRead(reader, buffer + total, min(n, size - total + 1));
+
+        if(read == 0)
+            return total;
+
+        total += read;
+
+        /* More than the file holds */
+        if(total > size)
+            return total;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Sets 'error' to 'what' went wrong with file number 'index'.
+ *--------------------------------------------------------------------------*/
+static void SetFileError(char error[ERROR_LENGTH], const char *what, DWORD index, const char *filename) {
+    _snprintf(error, ERROR_LENGTH - 1, "%s file %u (%s)", what, index, filename);
+    error[ERROR_LENGTH - 1] = '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * Opens 'archive' mapped in windows of NATIVE_CHECK_VIEW_SIZE bytes and reads
+ * every file of it back, at once and through a reader, so that reads cross
+ * the edges of the windows. The entries come from the sidecar 'indexFile'.
+ * 'expected' and 'actual' hold a file each.
+ *--------------------------------------------------------------------------*/
+static BOOL CheckWindowedArchive(char *archive, const char *indexFile, const GEN_OPTIONS *options, char *expected, char *actual,
+                                 char error[ERROR_LENGTH]) {
+    GEN_STATE           state;
+    DTA_OPEN_OPTIONS    openOptions;
+    DTA_ARCHIVE         *dta;
+    char                filename[256];
+    DWORD               fileSize;
+    BOOL                result = TRUE;
+
+    openOptions.viewSize    = NATIVE_CHECK_VIEW_SIZE;
+    openOptions.indexFile   = indexFile;
+
+    if((dta = DtaOpenArchiveEx(archive, options->key1, options->key2, &openOptions, error)) == NULL)
+        return FALSE;
+
+    /* A single window would never be moved */
+    if(DtaGetArchiveSize(dta) <= NATIVE_CHECK_VIEW_SIZE) {
+        strncpy_s(error, ERROR_LENGTH, "The archive is too small to be read in windows, generate more files", ERROR_LENGTH);
+        DtaCloseArchive(dta);
+        return FALSE;
+    }
+
+    InitGenerator(&state, options);
+
+    while(result && NextGeneratedFile(&state, filename, expected, &fileSize)) {
+        DWORD           index = state.next - 1;
+        DTA_ENTRY_INFO  info;
+        DTA_READER      reader;
+
+        if(!DtaFindEntry(dta, filename, &info)) {
+            SetFileError(error, "Could not find the windowed", index, filename);
+            result = FALSE;
+        }
+        else if(DtaReadEntry(dta, &info, 0, actual, options->maxSize + 1) != fileSize ||
+                memcmp(actual, expected, fileSize) != 0) {
+            SetFileError(error, "Read back wrong through windows", index, filename);
+            result = FALSE;
+        }
+        else {
+            DtaOpenReader(dta, &info, &reader);
+
+            if(ReadToEnd(&reader, actual, fileSize, index) != fileSize || memcmp(actual, expected, fileSize) != 0) {
+                SetFileError(error, "Read back wrong through windows by a reader from", index, filename);
+                result = FALSE;
+            }
+
+            DtaCloseReader(&reader);
+        }
+    }
+
+    DtaCloseArchive(dta);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Generates the archive 'options' describes into 'archive' and reads every
+ * file of it back through the native backend. Every file is read in pieces
+ * of changing sizes, then once more from the middle after a seek, and then
+ * again with the archive mapped in windows. If a file can't be opened or
+ * differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          archive         Archive to create
+ *                      options         Description of the archive
+ *                      error           Error string
+ *
+ *  Returns TRUE if every file matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckNativeReader(char *archive, const GEN_OPTIONS *options, char error[ERROR_LENGTH]) {
+    GEN_STATE           state;
+    DTA_OPEN_OPTIONS    openOptions = { 0 };
+    DTA_ARCHIVE         *dta;
+    char                indexFile[MAX_PATH];
+    char                filename[256];
+    char                *expected;
+    char                *actual;
+    DWORD               fileSize;
+    BOOL                result      = TRUE;
+
+    if(!GenerateArchive(archive, options, error))
+        return FALSE;
+
+    /* A sidecar left by an earlier run belongs to another archive */
+    _snprintf(indexFile, sizeof(indexFile) - 1, "%s%s", archive, DTA_INDEX_EXTENSION);
+    indexFile[sizeof(indexFile) - 1] = '\0';
+    DeleteFile(indexFile);
+
+    openOptions.indexFile = indexFile;
+
+    /* One byte more, so that a reader returning too much is caught */
+    expected    = (char *)malloc(options->maxSize + 1);
+    actual      = (char *)malloc(options->maxSize + 1);
+
+    if(expected == NULL || actual == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the native check", ERROR_LENGTH);
+        free(expected);
+        free(actual);
+        return FALSE;
+    }
+
+    if((dta = DtaOpenArchiveEx(archive, options->key1, options->key2, &openOptions, error)) == NULL) {
+        free(expected);
+        free(actual);
+        return FALSE;
+    }
+
+    InitGenerator(&state, options);
+
+    while(result && NextGeneratedFile(&state, filename, expected, &fileSize)) {
+        DWORD           index   = state.next - 1;
+        DWORD           middle  = fileSize / 2;
+        DTA_ENTRY_INFO  info;
+        DTA_READER      reader;
+
+        if(!DtaFindEntry(dta, filename, &info)) {
+            SetFileError(error, "Could not open", index, filename);
+            result = FALSE;
+            break;
+        }
+
+        DtaOpenReader(dta, &info, &reader);
+
+        if(ReadToEnd(&reader, actual, fileSize, index) != fileSize || memcmp(actual, expected, fileSize) != 0) {
+            SetFileError(error, "Read back wrong", index, filename);
+            result = FALSE;
+        }
+
+        /* The reader has to pick up in the middle of a block */
+        DtaSeek(&reader, middle, SEEK_SET);
+
+        if(result && (ReadToEnd(&reader, actual, fileSize - middle, index + 1) != fileSize - middle ||
+                      memcmp(actual, expected + middle, fileSize - middle) != 0)) {
+            SetFileError(error, "Read back wrong after a seek in", index, filename);
+            result = FALSE;
+        }
+
+        DtaCloseReader(&reader);
+    }
+
+    DtaCloseArchive(dta);
+
+    /* The first open wrote the sidecar, the second one reads it */
+    if(result && GetFileAttributes(indexFile) == INVALID_FILE_ATTRIBUTES) {
+        strncpy_s(error, ERROR_LENGTH, "The sidecar of the entries was not written", ERROR_LENGTH);
+        result = FALSE;
+    }
+
+    if(result)
+        result = CheckWindowedArchive(archive, indexFile, options, expected, actual, error);
+
+    DeleteFile(indexFile);
+
+    free(expected);
+    free(actual);
+
+    return result;
+}
@@ -0,0 +1,40 @@
+/*  Description:
+ *      Round trip through libdta. An archive is generated, then every file is
+ *      looked up by name with DtaFindEntry() and read back through a
+ *      DTA_READER, the way the unpacker reads it with --native, and compared
+ *      with the plain contents the generator produced. The open writes the
+ *      sidecar of the entries.
+ *
+ *      The archive is then opened once more, mapped in windows of
+ *      NATIVE_CHECK_VIEW_SIZE bytes the way a 32-bit process maps an archive
+ *      of a few GB and with the entries taken from the sidecar, and read back
+ *      again through DtaReadEntry() and DtaRead().
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef NATIVE_CHECK_H_
+#define NATIVE_CHECK_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "Generator.h"
+
+/* Window of the second pass, far smaller than the archive */
+#define NATIVE_CHECK_VIEW_SIZE  (64 * 1024)
+
+/*----------------------------------------------------------------------------
+ * Generates the archive 'options' describes into 'archive' and reads every
+ * file of it back through libdta. Every file is read in pieces of changing
+ * sizes, then once more from the middle after a seek, and then again with
+ * the archive mapped in windows and the entries read from the sidecar. If a file can't be opened or
+ * differs, 'error' is set and the function returns FALSE.
+ *
+ *  Arguments:          archive         Archive to create
+ *                      options         Description of the archive
+ *                      error           Error string
+ *
+ *  Returns TRUE if every file matched, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL CheckNativeReader(char *archive, const GEN_OPTIONS *options, char error[ERROR_LENGTH]);
+
+#endif
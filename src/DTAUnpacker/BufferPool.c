@@ -0,0 +1,398 @@
+/*  Description:
+ *      Implementation of the buffer pool. A free buffer keeps the link to the
+ *      next free buffer of its class in its first bytes, so the free lists
+ *      need no memory of their own. The thread caches are kept in a list
+ *      until StopBufferPool, the same way the trace keeps its counters.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "BufferPool.h"
+
+/* Buffers too large for any class are rounded up to this */
+#define BUFFER_GRANULARITY      (64 * 1024)
+
+/*
+ * Buffers cached by one thread, one of each class.
+ */
+typedef struct t_buffercache {
+    char                    *buffers[BUFFER_CLASSES];
+    DWORD                   leases;
+    DWORD                   cacheHits;
+    struct t_buffercache    *next;
+} BUFFER_CACHE;
+
+/*
+ * The pool of the whole run. Everything but the thread caches is guarded
+ * by the lock.
+ */
+static struct {
+    BOOL                enabled;
+    BOOL                largePages;
+    SIZE_T              largePageSize;
+    DWORD               tlsIndex;
+    CRITICAL_SECTION    lock;
+    BUFFER_CACHE        *caches;
+    char                *freeLists[BUFFER_CLASSES];
+    DWORD               numOfFree[BUFFER_CLASSES];
+    DWORD               poolHits;
+    DWORD               allocations;
+    DWORD               largePageAllocations;
+    unsigned __int64    bytesHeld;
+    unsigned __int64    peakBytesHeld;
+} pool = { FALSE };
+
+/*----------------------------------------------------------------------------
+ * Returns the class of buffers holding 'size' bytes, or BUFFER_CLASSES if
+ * 'size' is larger than every class.
+ *--------------------------------------------------------------------------*/
+static DWORD GetSizeClass(size_t size) {
+    DWORD shift = BUFFER_MIN_SHIFT;
+
+    while(shift <= BUFFER_MAX_SHIFT && ((size_t)1 << shift) < size)
+        ++shift;
+
+    return shift - BUFFER_MIN_SHIFT;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the size of the buffers of class 'sizeClass'.
+ *--------------------------------------------------------------------------*/
+static size_t GetClassSize(DWORD sizeClass) {
+    return (size_t)1 << (sizeClass + BUFFER_MIN_SHIFT);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the buffers cached by the calling thread, creating the cache the
+ * first time. Returns NULL if there is no memory for it.
+ *--------------------------------------------------------------------------*/
+static BUFFER_CACHE *GetBufferCache(void) {
+    BUFFER_CACHE *cache = (BUFFER_CACHE *)TlsGetValue(pool.tlsIndex);
+
+    if(cache != NULL)
+        return cache;
+
+    if((cache = (BUFFER_CACHE *)calloc(1, sizeof(BUFFER_CACHE))) == NULL)
+        return NULL;
+
+    TlsSetValue(pool.tlsIndex, cache);
+
+    EnterCriticalSection(&pool.lock);
+    cache->next = pool.caches;
+    pool.caches = cache;
+    LeaveCriticalSection(&pool.lock);
+
+    return cache;
+}
+
+/*----------------------------------------------------------------------------
+ * Allocates a buffer of 'size' bytes from the system, on large pages if
+ * they are enabled and 'size' is a multiple of them. Returns NULL if there
+ * is no memory for it.
+ *--------------------------------------------------------------------------*/
+static char *AllocateBuffer(size_t size) {
+    char    *buf        = NULL;
+    BOOL    largePages  = FALSE;
+
+    if(pool.largePages && size % pool.largePageSize == 0) {
+        buf         = (char *)VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        largePages  = buf != NULL;
+    }
+
+    /* Large pages run out once physical memory is fragmented */
+    if(buf == NULL)
+        buf = (char *)VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    if(buf == NULL || !pool.enabled)
+        return buf;
+
+    EnterCriticalSection(&pool.lock);
+
+    ++pool.allocations;
+
+    if(largePages)
+        ++pool.largePageAllocations;
+
+    pool.bytesHeld += size;
+    pool.peakBytesHeld = max(pool.peakBytesHeld, pool.bytesHeld);
+
+    LeaveCriticalSection(&pool.lock);
+
+    return buf;
+}
+
+/*----------------------------------------------------------------------------
+ * Gives a buffer of 'size' bytes back to the system. The caller must hold
+ * the lock if the pool is on.
+ *--------------------------------------------------------------------------*/
+static void FreeBufferLocked(char *buf, size_t size) {
+    VirtualFree(buf, 0, MEM_RELEASE);
+
+    if(pool.enabled)
+        pool.bytesHeld -= size;
+}
+
+/*----------------------------------------------------------------------------
+ * Puts 'buf' of class 'sizeClass' on its free list, or gives it back to the
+ * system if the list is full. The caller must hold the lock.
+ *--------------------------------------------------------------------------*/
+static void PutFreeBufferLocked(char *buf, DWORD sizeClass) {
+    if(pool.numOfFree[sizeClass] >= BUFFER_MAX_FREE) {
+        FreeBufferLocked(buf, GetClassSize(sizeClass));
+        return;
+    }
+
+    *(char **)buf = pool.freeLists[sizeClass];
+    pool.freeLists[sizeClass] = buf;
+    ++pool.numOfFree[sizeClass];
+}
+
+/*----------------------------------------------------------------------------
+ * Moves the buffers of 'cache' to the free lists. The caller must hold the
+ * lock.
+ *--------------------------------------------------------------------------*/
+static void FlushCacheLocked(BUFFER_CACHE *cache) {
+    DWORD i;
+
+    for(i = 0; i < BUFFER_CLASSES; ++i) {
+        if(cache->buffers[i] != NULL) {
+            PutFreeBufferLocked(cache->buffers[i], i);
+            cache->buffers[i] = NULL;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Turns the pool on. Returns FALSE if there is no thread local storage left
+ * for the thread caches.
+ *--------------------------------------------------------------------------*/
+BOOL StartBufferPool(void) {
+    if((pool.tlsIndex = TlsAlloc()) == TLS_OUT_OF_INDEXES)
+        return FALSE;
+
+    InitializeCriticalSection(&pool.lock);
+
+    pool.caches     = NULL;
+    pool.enabled    = TRUE;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Lets the pool back large buffers with large pages. This needs the "Lock
+ * pages in memory" right, which is enabled for the process here. Returns
+ * FALSE if the system has no large pages or the right is missing.
+ *--------------------------------------------------------------------------*/
+BOOL EnableLargePages(void) {
+    TOKEN_PRIVILEGES    privileges;
+    HANDLE              hToken;
+    BOOL                result;
+
+    if((pool.largePageSize = GetLargePageMinimum()) == 0)
+        return FALSE;
+
+    if(!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES, &hToken))
+        return FALSE;
+
+    privileges.PrivilegeCount           = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+    /* Succeeds with ERROR_NOT_ALL_ASSIGNED if the account lacks the right */
+    result = LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+             AdjustTokenPrivileges(hToken, FALSE, &privileges, 0, NULL, NULL) &&
+             GetLastError() == ERROR_SUCCESS;
+
+    CloseHandle(hToken);
+
+    pool.largePages = result;
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Leases a buffer of at least 'size' bytes. The contents are undefined.
+ * Returns NULL if there is no memory for it.
+ *
+ *  Arguments:      size            Bytes needed
+ *                  leased          Receives the real size of the buffer
+ *--------------------------------------------------------------------------*/
+char *LeaseBuffer(size_t size, size_t *leased) {
+    DWORD           sizeClass = GetSizeClass(size);
+    BUFFER_CACHE    *cache;
+    char            *buf;
+
+    /* Larger than every class, allocated for this lease only */
+    if(sizeClass == BUFFER_CLASSES) {
+        *leased = (size + BUFFER_GRANULARITY - 1) & ~(size_t)(BUFFER_GRANULARITY - 1);
+
+        return *leased < size ? NULL : AllocateBuffer(*leased);
+    }
+
+    *leased = GetClassSize(sizeClass);
+
+    if(!pool.enabled)
+        return AllocateBuffer(*leased);
+
+    if((cache = GetBufferCache()) != NULL) {
+        ++cache->leases;
+
+        if((buf = cache->buffers[sizeClass]) != NULL) {
+            cache->buffers[sizeClass] = NULL;
+            ++cache->cacheHits;
+            return buf;
+        }
+    }
+
+    EnterCriticalSection(&pool.lock);
+
+    if((buf = pool.freeLists[sizeClass]) != NULL) {
+        pool.freeLists[sizeClass] = *(char **)buf;
+        --pool.numOfFree[sizeClass];
+        ++pool.poolHits;
+    }
+
+    LeaveCriticalSection(&pool.lock);
+
+    return buf != NULL ? buf : AllocateBuffer(*leased);
+}
+
+/*----------------------------------------------------------------------------
+ * Gives a leased buffer back. Does nothing if 'buf' is NULL.
+ *
+ *  Arguments:      buf             Buffer returned by LeaseBuffer
+ *                  size            Size LeaseBuffer reported for it
+ *--------------------------------------------------------------------------*/
+void ReturnBuffer(char *buf, size_t size) {
+    DWORD           sizeClass = GetSizeClass(size);
+    BUFFER_CACHE    *cache;
+
+    if(buf == NULL)
+        return;
+
+    if(!pool.enabled) {
+        VirtualFree(buf, 0, MEM_RELEASE);
+        return;
+    }
+
+    /* Not worth keeping around for the rest of the run */
+    if(sizeClass == BUFFER_CLASSES || sizeClass + BUFFER_MIN_SHIFT > BUFFER_MAX_KEPT_SHIFT) {
+        EnterCriticalSection(&pool.lock);
+        FreeBufferLocked(buf, size);
+        LeaveCriticalSection(&pool.lock);
+        return;
+    }
+
+    if((cache = GetBufferCache()) != NULL && cache->buffers[sizeClass] == NULL) {
+        cache->buffers[sizeClass] = buf;
+        return;
+    }
+
+    EnterCriticalSection(&pool.lock);
+    PutFreeBufferLocked(buf, sizeClass);
+    LeaveCriticalSection(&pool.lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Moves the buffers cached by the calling thread into the pool, so other
+ * threads can lease them. Called by threads that are about to exit.
+ *--------------------------------------------------------------------------*/
+void FlushBufferCache(void) {
+    BUFFER_CACHE *cache;
+
+    if(!pool.enabled || (cache = (BUFFER_CACHE *)TlsGetValue(pool.tlsIndex)) == NULL)
+        return;
+
+    EnterCriticalSection(&pool.lock);
+    FlushCacheLocked(cache);
+    LeaveCriticalSection(&pool.lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the pool.
+ *
+ *  Arguments:      stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void GetBufferPoolStats(BUFFER_POOL_STATS *stats) {
+    BUFFER_CACHE *cache;
+
+    memset(stats, 0, sizeof(BUFFER_POOL_STATS));
+
+    if(!pool.enabled)
+        return;
+
+    EnterCriticalSection(&pool.lock);
+
+    for(cache = pool.caches; cache != NULL; cache = cache->next) {
+        stats->leases       += cache->leases;
+        stats->cacheHits    += cache->cacheHits;
+    }
+
+    stats->poolHits         = pool.poolHits;
+    stats->allocations      = pool.allocations;
+    stats->largePages       = pool.largePageAllocations;
+    stats->bytesHeld        = pool.bytesHeld;
+    stats->peakBytesHeld    = pool.peakBytesHeld;
+
+    LeaveCriticalSection(&pool.lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Prints the counters of the pool to stderr.
+ *--------------------------------------------------------------------------*/
+void PrintBufferPoolStats(void) {
+    BUFFER_POOL_STATS stats;
+
+    if(!pool.enabled)
+        return;
+
+    GetBufferPoolStats(&stats);
+
+    fprintf(stderr, "Buffers: %u leases, %u from thread caches, %u from the pool, %u allocated",
+            stats.leases, stats.cacheHits, stats.poolHits, stats.allocations);
+
+    if(pool.largePages)
+        fprintf(stderr, " (%u on large pages)", stats.largePages);
+
+    fprintf(stderr, ", peak %.1f MB\n", (double)(__int64)stats.peakBytesHeld / (1024.0 * 1024.0));
+}
+
+/*----------------------------------------------------------------------------
+ * Turns the pool off and frees every buffer it still holds. Buffers that
+ * are still leased are freed when they are returned.
+ *--------------------------------------------------------------------------*/
+void StopBufferPool(void) {
+    DWORD i;
+
+    if(!pool.enabled)
+        return;
+
+    EnterCriticalSection(&pool.lock);
+
+    while(pool.caches != NULL) {
+        BUFFER_CACHE *next = pool.caches->next;
+
+        FlushCacheLocked(pool.caches);
+        free(pool.caches);
+        pool.caches = next;
+    }
+
+    for(i = 0; i < BUFFER_CLASSES; ++i) {
+        while(pool.freeLists[i] != NULL) {
+            char *buf = pool.freeLists[i];
+
+            pool.freeLists[i] = *(char **)buf;
+            FreeBufferLocked(buf, GetClassSize(i));
+        }
+
+        pool.numOfFree[i] = 0;
+    }
+
+    pool.enabled = FALSE;
+
+    LeaveCriticalSection(&pool.lock);
+
+    TlsFree(pool.tlsIndex);
+    DeleteCriticalSection(&pool.lock);
+}
@@ -0,0 +1,110 @@
+/*  Description:
+ *      Pool of the buffers that file data passes through. A buffer is leased
+ *      in one of a few size classes, powers of two from 64 KB up, and given
+ *      back when it is no longer needed; the next lease of the same class
+ *      gets it again instead of asking the system for memory:
+ *
+ *          buf = LeaseBuffer(fileSize, &size);
+ *          ...
+ *          ReturnBuffer(buf, size);
+ *
+ *      Every thread first looks into a cache of its own, which holds one
+ *      buffer of each class, and only takes the lock of the pool when that
+ *      is empty. Once the buffers of a run have been allocated, leasing and
+ *      returning them never touches the heap.
+ *
+ *      Buffers come straight from VirtualAlloc, so they start on a page
+ *      boundary and their size is a multiple of the page size, as unbuffered
+ *      (FILE_FLAG_NO_BUFFERING) reads and writes require. After
+ *      EnableLargePages, classes that are a multiple of the large page size
+ *      are backed by large pages where the system has them to spare.
+ *
+ *      Until StartBufferPool is called, LeaseBuffer allocates and
+ *      ReturnBuffer frees every buffer right away.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef BUFFER_POOL_H_
+#define BUFFER_POOL_H_
+
+#include <windows.h>
+
+/* Smallest and largest size class, as powers of two */
+#define BUFFER_MIN_SHIFT        16
+#define BUFFER_MAX_SHIFT        31
+#define BUFFER_CLASSES          (BUFFER_MAX_SHIFT - BUFFER_MIN_SHIFT + 1)
+
+/* Larger classes go back to the system as soon as they are returned */
+#define BUFFER_MAX_KEPT_SHIFT   26
+
+/* Free buffers the pool keeps of each class, besides the thread caches */
+#define BUFFER_MAX_FREE         4
+
+/*
+ * Counters of the pool, summed over all threads.
+ */
+typedef struct t_bufferpoolstats {
+    DWORD               leases;
+    DWORD               cacheHits;          /* Leases served by a thread cache */
+    DWORD               poolHits;           /* Leases served by the pool */
+    DWORD               allocations;        /* Buffers allocated from the system */
+    DWORD               largePages;         /* Of those, backed by large pages */
+    unsigned __int64    bytesHeld;          /* Allocated and not freed yet */
+    unsigned __int64    peakBytesHeld;
+} BUFFER_POOL_STATS;
+
+/*----------------------------------------------------------------------------
+ * Turns the pool on. Returns FALSE if there is no thread local storage left
+ * for the thread caches.
+ *--------------------------------------------------------------------------*/
+BOOL StartBufferPool(void);
+
+/*----------------------------------------------------------------------------
+ * Lets the pool back large buffers with large pages. This needs the "Lock
+ * pages in memory" right, which is enabled for the process here. Returns
+ * FALSE if the system has no large pages or the right is missing.
+ *--------------------------------------------------------------------------*/
+BOOL EnableLargePages(void);
+
+/*----------------------------------------------------------------------------
+ * Leases a buffer of at least 'size' bytes. The contents are undefined.
+ * Returns NULL if there is no memory for it.
+ *
+ *  Arguments:      size            Bytes needed
+ *                  leased          Receives the real size of the buffer
+ *--------------------------------------------------------------------------*/
+char *LeaseBuffer(size_t size, size_t *leased);
+
+/*----------------------------------------------------------------------------
+ * Gives a leased buffer back. Does nothing if 'buf' is NULL.
+ *
+ *  Arguments:      buf             Buffer returned by LeaseBuffer
+ *                  size            Size LeaseBuffer reported for it
+ *--------------------------------------------------------------------------*/
+void ReturnBuffer(char *buf, size_t size);
+
+/*----------------------------------------------------------------------------
+ * Moves the buffers cached by the calling thread into the pool, so other
+ * threads can lease them. Called by threads that are about to exit.
+ *--------------------------------------------------------------------------*/
+void FlushBufferCache(void);
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the pool.
+ *
+ *  Arguments:      stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void GetBufferPoolStats(BUFFER_POOL_STATS *stats);
+
+/*----------------------------------------------------------------------------
+ * Prints the counters of the pool to stderr.
+ *--------------------------------------------------------------------------*/
+void PrintBufferPoolStats(void);
+
+/*----------------------------------------------------------------------------
+ * Turns the pool off and frees every buffer it still holds. Buffers that
+ * are still leased are freed when they are returned.
+ *--------------------------------------------------------------------------*/
+void StopBufferPool(void);
+
+#endif
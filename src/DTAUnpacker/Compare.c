@@ -0,0 +1,140 @@
+/*  Description:
+ *      Implementation of the comparison between tmp.dll and libdta. The
+ *      archive is open in both: libdta keeps no globals and so can't get in
+ *      the way of the DLL.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Compare.h"
+#include "EntryIndex.h"
+
+/* No difference was found */
+#define COMPARE_SAME    0xFFFFFFFF
+
+/*----------------------------------------------------------------------------
+ * Returns the position of the first byte where the 'dllLength' bytes of
+ * 'dll' and the 'nativeLength' bytes of 'native' differ, or COMPARE_SAME.
+ *--------------------------------------------------------------------------*/
+static DWORD FindDifference(const char *dll, DWORD dllLength, const char *native, DWORD nativeLength) {
+    DWORD i;
+
+    for(i = 0; i < min(dllLength, nativeLength); ++i) {
+        if(dll[i] != native[i])
+            return i;
+    }
+
+    return dllLength == nativeLength ? COMPARE_SAME : i;
+}
+
+/*----------------------------------------------------------------------------
+ * Streams the entry 'info' through tmp.dll and compares it with libdta.
+ * Sets 'dllSize' to the number of bytes tmp.dll returned and returns the
+ * first differing position, or COMPARE_SAME. Returns FALSE if tmp.dll
+ * can't open the entry.
+ *--------------------------------------------------------------------------*/
+static BOOL CompareEntry(APP_DATA *data, const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info,
+                         char *dllBuf, char *nativeBuf, DWORD *dllSize, DWORD *difference) {
+    DWORD       fileHandle = data->dtaOpen((char *)info->name, 0);
+    DTA_READER  reader;
+    DWORD       n;
+
+    if(fileHandle == DTA_OPEN_FAILED)
+        return FALSE;
+
+    *dllSize    = 0;
+    *difference = COMPARE_SAME;
+
+    DtaOpenReader(archive, info, &reader);
+
+    while((n = data->dtaRead(fileHandle, dllBuf, COMPARE_CHUNK)) > 0) {
+        DWORD nativeLength  = DtaRead(&reader, nativeBuf, n);
+        DWORD at            = FindDifference(dllBuf, n, nativeBuf, nativeLength);
+
+        if(*difference == COMPARE_SAME && at != COMPARE_SAME)
+            *difference = *dllSize + at;
+
+        *dllSize += n;
+    }
+
+    /* tmp.dll stopping early is a difference as well */
+    if(*difference == COMPARE_SAME && *dllSize != info->fileSize)
+        *difference = *dllSize;
+
+    DtaCloseReader(&reader);
+    data->dtaClose(fileHandle);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads every entry matching the --include and --exclude patterns through
+ * tmp.dll and through 'job->archive', and prints the entries whose
+ * contents differ to stdout. If any errors occur, 'error' string is set and
+ * the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to compare
+ *                  error           Error string
+ *
+ *  Returns TRUE if the comparison ran, whether or not entries differ.
+ *--------------------------------------------------------------------------*/
+BOOL CompareWithNative(ARCHIVE_JOB *job, char error[ERROR_LENGTH]) {
+    APP_DATA        *data       = job->data;
+    DTA_ARCHIVE     *archive    = job->archive;
+    DTA_ITERATOR    iterator;
+    DTA_ENTRY_INFO  info;
+    char            *dllBuf;
+    char            *nativeBuf;
+    DWORD           compared    = 0;
+    DWORD           differing   = 0;
+
+    dllBuf      = (char *)malloc(COMPARE_CHUNK);
+    nativeBuf   = (char *)malloc(COMPARE_CHUNK);
+
+    if(dllBuf == NULL || nativeBuf == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the comparison", ERROR_LENGTH);
+        free(dllBuf);
+        free(nativeBuf);
+        return FALSE;
+    }
+
+    DtaBeginEntries(archive, &iterator);
+
+    while(DtaNextEntry(&iterator, &info)) {
+        DTA_FILE_HEADER fileHeader;
+        DWORD           dllSize;
+        DWORD           difference;
+
+        if(!IsEntrySelected(data, info.name))
+            continue;
+
+        ++compared;
+
+        if(!CompareEntry(data, archive, &info, dllBuf, nativeBuf, &dllSize, &difference)) {
+            printf("%s: tmp.dll could not open it\n", info.name);
+            ++differing;
+            continue;
+        }
+
+        if(difference == COMPARE_SAME)
+            continue;
+
+        /* The unknown fields may tell a block type the decoder doesn't know */
+        if(!DtaGetFileHeader(archive, &info, &fileHeader))
+            memset(&fileHeader, 0, sizeof(DTA_FILE_HEADER));
+
+        printf("%s: size %u, tmp.dll returned %u, first difference at %u, %u blocks, header %08X %08X %08X %08X\n",
+               info.name, info.fileSize, dllSize, difference, info.numOfBlocks,
+               fileHeader.extra1, fileHeader.extra2, fileHeader.extra3, fileHeader.extra4);
+        ++differing;
+    }
+
+    fprintf(stderr, "%u of %u files differ between tmp.dll and the native reader\n", differing, compared);
+
+    free(dllBuf);
+    free(nativeBuf);
+
+    return TRUE;
+}
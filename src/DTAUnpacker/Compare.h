@@ -0,0 +1,36 @@
+/*  Description:
+ *      Compares what tmp.dll returns for every entry with the bytes the
+ *      native reader (libdta) decodes. An entry whose blocks libdta decodes
+ *      differently from tmp.dll shows up here with a different size or a
+ *      first differing byte, next to the unknown fields of its file header,
+ *      so a real archive can be checked against the DLL before the native
+ *      reader is trusted with it.
+ *
+ *      Both readers are streamed in pieces of COMPARE_CHUNK bytes, so any
+ *      size of entry can be compared.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef COMPARE_H_
+#define COMPARE_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/* Size of the pieces read from each side */
+#define COMPARE_CHUNK   (64 * 1024)
+
+/*----------------------------------------------------------------------------
+ * Reads every entry matching the --include and --exclude patterns through
+ * tmp.dll and through 'job->archive', and prints the entries whose
+ * contents differ to stdout. If any errors occur, 'error' string is set and
+ * the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to compare
+ *                  error           Error string
+ *
+ *  Returns TRUE if the comparison ran, whether or not entries differ.
+ *--------------------------------------------------------------------------*/
+BOOL CompareWithNative(ARCHIVE_JOB *job, char error[ERROR_LENGTH]);
+
+#endif
@@ -1,113 +1,216 @@
-/*  Description:
- *      Implementation of the resizable buffer. VC++ generates warnings due to
- *      "unsafe" functions. Those are turned off in the project settings.
- *
- *  Author: Jovan Stanojlovic
- */
-
-#include <stdlib.h>
-#include <windows.h>
-#include <stdio.h>
-#include "Container.h"
-
-/*----------------------------------------------------------------------------
- * Initializes the buffer to the given 'size'. Returns TRUE if successful,
- * FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      size            Initial size
- *--------------------------------------------------------------------------*/
-BOOL InitBuffer(BUF_CONTAINER *buf, size_t size) {
-    if((buf->buf = (char *)calloc(size, sizeof(char))) == NULL)
-        return FALSE;
-
-    buf->size = size;
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Resizes a BUF_CONTAINER object to 'newSize'. Returns TRUE if successful,
- * FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      newSize         Size of the new buffer
- *--------------------------------------------------------------------------*/
-BOOL ResizeBuffer(BUF_CONTAINER *buf, size_t newSize) {
-    char *tempBuf;
-
-    if((tempBuf = (char *)realloc(buf->buf, newSize)) == NULL)
-        return FALSE;
-
-    buf->buf  = tempBuf;
-    buf->size = newSize;
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Performs a block write operation from 'data' of size 'n' to the buffer.
- * The buffer may be resized during this operation to fit all the data, and if
- * it fails to resize, the function returns FALSE; otherwise, returns TRUE.
- *
- *  Arguments:          buf             Pointer to the container
- *                      data            Data to write
- *                      n               Size of data
- *--------------------------------------------------------------------------*/
-BOOL WriteToBuffer(BUF_CONTAINER *buf, char *data, size_t n) {
-    /* Need to resize? */
-    if(buf->size < n && !ResizeBuffer(buf, n))
-        return FALSE;
-
-    memcpy((void *)buf->buf, (void *)data, n);
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Writes data of size 'n' from the beginning of the buffer to 'filename'.
- * The function will create subdirectories if required. Returns TRUE if
- * successful, FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      n               Number of bytes to write
- *                      filename        Name of file to write to
- *--------------------------------------------------------------------------*/
-BOOL WriteToFile(BUF_CONTAINER *buf, size_t n, char *filename) {
-    char fullname[256 + 1] = { 0 };
-    char *dirseek;
-
-    dirseek = strtok(filename, "\\");
-
-    while(dirseek != NULL) {
-        strcat(fullname, dirseek);
-        dirseek = strtok(NULL, "\\");
-
-        if(dirseek != NULL) {
-            CreateDirectory(fullname, NULL);
-            strcat(fullname, "\\");
-        } else {
-            DWORD written;
-            HANDLE hFile = CreateFile(fullname, GENERIC_ALL, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-
-            if(hFile == INVALID_HANDLE_VALUE)
-                return FALSE;
-
-            WriteFile(hFile, (void *)buf->buf, (DWORD)n, &written, NULL); 
-            CloseHandle(hFile);
-        }
-    }
-
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Releases the memory used by the buffer. After this, the buffer is no
- * longer usable.
- *
- *  Arguments:          buf             Pointer to the container
- *--------------------------------------------------------------------------*/
-void ReleaseBuffer(BUF_CONTAINER *buf) {
-    free(buf->buf);
-}
+/*  Description:
+ *      Implementation of the resizable buffer. The memory is leased from the
+ *      buffer pool, so a buffer that grows takes the next size class instead
+ *      of reallocating. VC++ generates warnings due to "unsafe" functions.
+ *      Those are turned off in the project settings.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdlib.h>
+#include <windows.h>
+#include <stdio.h>
+#include "Container.h"
+#include "BufferPool.h"
+#include "Trace.h"
+
+/*----------------------------------------------------------------------------
+ * Initializes the buffer to the given 'size'. Returns TRUE if successful,
+ * FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      size            Initial size
+ *--------------------------------------------------------------------------*/
+BOOL InitBuffer(BUF_CONTAINER *buf, size_t size) {
+    if((buf->buf = LeaseBuffer(size, &buf->size)) == NULL) {
+        buf->size = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Resizes a BUF_CONTAINER object to 'newSize', keeping as much of its
+ * contents as fit. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      newSize         Size of the new buffer
+ *--------------------------------------------------------------------------*/
+BOOL ResizeBuffer(BUF_CONTAINER *buf, size_t newSize) {
+    char    *tempBuf;
+    size_t  leased;
+    __int64 started;
+
+    /* Still the same size class, nothing to do */
+    if(buf->size >= newSize && (buf->size <= ((size_t)1 << BUFFER_MIN_SHIFT) || buf->size / 2 < newSize))
+        return TRUE;
+
+    started = BeginTrace();
+    tempBuf = LeaseBuffer(newSize, &leased);
+
+    if(tempBuf != NULL && buf->buf != NULL)
+        memcpy(tempBuf, buf->buf, min(buf->size, leased));
+
+    EndTrace(TRACE_BUFFER, started, newSize);
+
+    if(tempBuf == NULL)
+        return FALSE;
+
+    ReturnBuffer(buf->buf, buf->size);
+    buf->buf  = tempBuf;
+    buf->size = leased;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Makes sure the buffer holds at least 'size' bytes. Unlike ResizeBuffer,
+ * the contents are not kept, so nothing is copied when it grows. Returns
+ * TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      size            Minimum size of the buffer
+ *--------------------------------------------------------------------------*/
+BOOL ReserveBuffer(BUF_CONTAINER *buf, size_t size) {
+    char    *tempBuf;
+    size_t  leased;
+    __int64 started;
+
+    if(buf->size >= size)
+        return TRUE;
+
+    started = BeginTrace();
+    tempBuf = LeaseBuffer(size, &leased);
+    EndTrace(TRACE_BUFFER, started, size);
+
+    if(tempBuf == NULL)
+        return FALSE;
+
+    ReturnBuffer(buf->buf, buf->size);
+    buf->buf  = tempBuf;
+    buf->size = leased;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Performs a block write operation from 'data' of size 'n' to the buffer.
+ * The buffer may be resized during this operation to fit all the data, and if
+ * it fails to resize, the function returns FALSE; otherwise, returns TRUE.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      data            Data to write
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+BOOL WriteToBuffer(BUF_CONTAINER *buf, char *data, size_t n) {
+    /* The old contents are overwritten anyway */
+    if(!ReserveBuffer(buf, n))
+        return FALSE;
+
+    memcpy((void *)buf->buf, (void *)data, n);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Creates 'filename' for writing, along with any subdirectories that 'dirs'
+ * doesn't hold yet. Returns the handle of the file, or INVALID_HANDLE_VALUE
+ * if it could not be created.
+ *
+ *  Arguments:          filename        Name of file to create
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+HANDLE CreateOutputFile(char *filename, DIR_CACHE *dirs) {
+    char    fullname[256 + 1];
+    size_t  length;
+
+    strncpy_s(fullname, sizeof(fullname), filename, _TRUNCATE);
+    length = NormalizePath(fullname);
+
+    if(length == 0 || fullname[length - 1] == '\\')
+        return INVALID_HANDLE_VALUE;
+
+    if(!CreateParentDirectory(dirs, fullname))
+        return INVALID_HANDLE_VALUE;
+
+    return CreateFile(fullname, GENERIC_ALL, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * Creates 'filename' like CreateOutputFile and sets its size to 'size', so
+ * that several threads can later write their parts of it. The file is
+ * closed again. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          filename        Name of file to create
+ *                      size            Final size of the file
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+BOOL PreallocateOutputFile(char *filename, DWORD size, DIR_CACHE *dirs) {
+    LARGE_INTEGER   end;
+    BOOL            result;
+    HANDLE          hFile = CreateOutputFile(filename, dirs);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    end.QuadPart = size;
+    result = SetFilePointerEx(hFile, end, NULL, FILE_BEGIN) && SetEndOfFile(hFile);
+
+    CloseHandle(hFile);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Opens a file created by PreallocateOutputFile for writing. Other handles
+ * to the same file may be open at the same time. Returns the handle of the
+ * file, or INVALID_HANDLE_VALUE if it could not be opened.
+ *
+ *  Arguments:          filename        Name of the file
+ *--------------------------------------------------------------------------*/
+HANDLE OpenOutputFile(char *filename) {
+    char fullname[256 + 1];
+
+    /* Same name CreateOutputFile used */
+    strncpy_s(fullname, sizeof(fullname), filename, _TRUNCATE);
+    NormalizePath(fullname);
+
+    return CreateFile(fullname, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes data of size 'n' from the beginning of the buffer to 'filename'.
+ * The function will create subdirectories if required, skipping the ones
+ * that 'dirs' already holds. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      n               Number of bytes to write
+ *                      filename        Name of file to write to
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+BOOL WriteToFile(BUF_CONTAINER *buf, size_t n, char *filename, DIR_CACHE *dirs) {
+    DWORD   written;
+    HANDLE  hFile = CreateOutputFile(filename, dirs);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    WriteFile(hFile, (void *)buf->buf, (DWORD)n, &written, NULL); 
+    CloseHandle(hFile);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Gives the memory of the buffer back to the pool. After this, the buffer
+ * is empty until it is initialized again.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *--------------------------------------------------------------------------*/
+void ReleaseBuffer(BUF_CONTAINER *buf) {
+    ReturnBuffer(buf->buf, buf->size);
+
+    buf->buf  = NULL;
+    buf->size = 0;
+}
@@ -1,69 +1,112 @@
-/*  Description:
- *      Interface to a resizable buffer that is wrapped inside a struct.
- *      This lets the file data that is being read get stored in a single place,
- *      without using too much dynamic memory.
- *
- *  Author: Jovan Stanojlovic
- */
-#ifndef CONTAINER_H_
-#define CONTAINER_H_
-
-#include <windows.h>
-
-/*
- * A struct used to keep a buffer. This is mainly used to minimize memory usage.
- */
-typedef struct t_bufcontainer {
-    size_t  size;
-    char    *buf;
-} BUF_CONTAINER;
-
-/*----------------------------------------------------------------------------
- * Initializes the buffer to the given 'size'. Returns TRUE if successful,
- * FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      size            Initial size
- *--------------------------------------------------------------------------*/
-BOOL InitBuffer(BUF_CONTAINER *buf, size_t size);
-
-/*----------------------------------------------------------------------------
- * Resizes a BUF_CONTAINER object to 'newSize'. Returns TRUE if successful,
- * FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      newSize         Size of the new buffer
- *--------------------------------------------------------------------------*/
-BOOL ResizeBuffer(BUF_CONTAINER *buf, size_t newSize);
-
-/*----------------------------------------------------------------------------
- * Performs a block write operation from 'data' of size 'n' to the buffer.
- * The buffer may be resized during this operation to fit all the data, and if
- * it fails to resize, the function returns FALSE; otherwise, returns TRUE.
- *
- *  Arguments:          buf             Pointer to the container
- *                      data            Data to write
- *                      n               Size of data
- *--------------------------------------------------------------------------*/
-BOOL WriteToBuffer(BUF_CONTAINER *buf, char *data, size_t n);
-
-/*----------------------------------------------------------------------------
- * Writes data of size 'n' from the beginning of the buffer to 'filename'.
- * The function will create subdirectories if required. Returns TRUE if
- * successful, FALSE otherwise.
- *
- *  Arguments:          buf             Pointer to the container
- *                      n               Number of bytes to write
- *                      filename        Name of file to write to
- *--------------------------------------------------------------------------*/
-BOOL WriteToFile(BUF_CONTAINER *buf, size_t n, char *filename);
-
-/*----------------------------------------------------------------------------
- * Releases the memory used by the buffer. After this, the buffer is no
- * longer usable.
- *
- *  Arguments:          buf             Pointer to the container
- *--------------------------------------------------------------------------*/
-void ReleaseBuffer(BUF_CONTAINER *buf);
-
-#endif
+/*  Description:
+ *      Interface to a resizable buffer that is wrapped inside a struct.
+ *      This lets the file data that is being read get stored in a single place,
+ *      without using too much dynamic memory. The memory comes from the pool
+ *      in BufferPool.h, so 'size' may be larger than what was asked for.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef CONTAINER_H_
+#define CONTAINER_H_
+
+#include <windows.h>
+#include "DirCache.h"
+
+/*
+ * A struct used to keep a buffer. This is mainly used to minimize memory usage.
+ */
+typedef struct t_bufcontainer {
+    size_t  size;
+    char    *buf;
+} BUF_CONTAINER;
+
+/*----------------------------------------------------------------------------
+ * Initializes the buffer to the given 'size'. Returns TRUE if successful,
+ * FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      size            Initial size
+ *--------------------------------------------------------------------------*/
+BOOL InitBuffer(BUF_CONTAINER *buf, size_t size);
+
+/*----------------------------------------------------------------------------
+ * Resizes a BUF_CONTAINER object to 'newSize', keeping as much of its
+ * contents as fit. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      newSize         Size of the new buffer
+ *--------------------------------------------------------------------------*/
+BOOL ResizeBuffer(BUF_CONTAINER *buf, size_t newSize);
+
+/*----------------------------------------------------------------------------
+ * Makes sure the buffer holds at least 'size' bytes. Unlike ResizeBuffer,
+ * the contents are not kept, so nothing is copied when it grows. Returns
+ * TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      size            Minimum size of the buffer
+ *--------------------------------------------------------------------------*/
+BOOL ReserveBuffer(BUF_CONTAINER *buf, size_t size);
+
+/*----------------------------------------------------------------------------
+ * Performs a block write operation from 'data' of size 'n' to the buffer.
+ * The buffer may be resized during this operation to fit all the data, and if
+ * it fails to resize, the function returns FALSE; otherwise, returns TRUE.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      data            Data to write
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+BOOL WriteToBuffer(BUF_CONTAINER *buf, char *data, size_t n);
+
+/*----------------------------------------------------------------------------
+ * Creates 'filename' for writing, along with any subdirectories that 'dirs'
+ * doesn't hold yet. Returns the handle of the file, or INVALID_HANDLE_VALUE
+ * if it could not be created.
+ *
+ *  Arguments:          filename        Name of file to create
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+HANDLE CreateOutputFile(char *filename, DIR_CACHE *dirs);
+
+/*----------------------------------------------------------------------------
+ * Creates 'filename' like CreateOutputFile and sets its size to 'size', so
+ * that several threads can later write their parts of it. The file is
+ * closed again. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          filename        Name of file to create
+ *                      size            Final size of the file
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+BOOL PreallocateOutputFile(char *filename, DWORD size, DIR_CACHE *dirs);
+
+/*----------------------------------------------------------------------------
+ * Opens a file created by PreallocateOutputFile for writing. Other handles
+ * to the same file may be open at the same time. Returns the handle of the
+ * file, or INVALID_HANDLE_VALUE if it could not be opened.
+ *
+ *  Arguments:          filename        Name of the file
+ *--------------------------------------------------------------------------*/
+HANDLE OpenOutputFile(char *filename);
+
+/*----------------------------------------------------------------------------
+ * Writes data of size 'n' from the beginning of the buffer to 'filename'.
+ * The function will create subdirectories if required, skipping the ones
+ * that 'dirs' already holds. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *                      n               Number of bytes to write
+ *                      filename        Name of file to write to
+ *                      dirs            Directories created so far
+ *--------------------------------------------------------------------------*/
+BOOL WriteToFile(BUF_CONTAINER *buf, size_t n, char *filename, DIR_CACHE *dirs);
+
+/*----------------------------------------------------------------------------
+ * Gives the memory of the buffer back to the pool. After this, the buffer
+ * is empty until it is initialized again.
+ *
+ *  Arguments:          buf             Pointer to the container
+ *--------------------------------------------------------------------------*/
+void ReleaseBuffer(BUF_CONTAINER *buf);
+
+#endif
@@ -1,241 +1,412 @@
-/*  Description:
- *      Implementation of the functions needed to read through DTA files, as well
- *      as decrypt headers.
- *
- *  Author: Jovan Stanojlovic
- */
-
-
-#include <stdio.h>
-#include "DTAFunctions.h"
-#include "DTAFormat.h"
-#include "Container.h"
-
-/*----------------------------------------------------------------------------
- * Utility function that processes a single file. The function assumes that
- * the position of the stream reader is set at the beginning of the header.
- *
- *  Arguments:      data            Pointer to the APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on successful, false otherwise.
- *--------------------------------------------------------------------------*/
-static BOOL ProcessFile(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*--------------------------------------------------------------------------
- * Decrypts 'buffer' of size 'byteCount' using 'key1' and 'key2' as
- * decryption keys.
- *
- * These keys are more or less specific to the file.
- *
- * Arguments:       buffer          Data to decrypt
- *                  byteCount       Size of data
- *                  key1            First decryption key
- *                  key2            Second decryption key
- *-------------------------------------------------------------------------*/
-void Decrypt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2) {
-    unsigned char   *pKey;
-    unsigned int    byteCount64;
-    __int64         *buffer64;
-    unsigned char   *pByte;
-    unsigned int    cBytes;
-    unsigned int    keys[2] = { key2, key1 };
-
-    /* Process 64-bit chunks first, then process remaining bytes */
-    buffer64 = (__int64 *)buffer;
-    byteCount64 = byteCount / 8;
-
-    for (; byteCount64; --byteCount64, ++buffer64) {
-        unsigned int    ulong;
-        unsigned int    *pLong = ((unsigned int *)buffer64);
-
-        ulong = *pLong;
-        *pLong = ~((~ulong) ^ key2);
-        ++pLong;
-        ulong = *pLong;
-        *pLong = ~((~ulong) ^ key1);
-    }
-
-    pByte = ((unsigned char *)buffer64);
-    cBytes = byteCount % 8;
-    pKey = ((unsigned char *)keys);
-
-    for (; cBytes; --cBytes, ++pByte, ++pKey) {
-        unsigned char byte  = *pByte;
-        unsigned char key   = *pKey;
-
-        *pByte = (unsigned char)(~((~byte) ^ key));
-    }
-}
-
-/*----------------------------------------------------------------------------
- * Opens the .dta file, decrypts it, and unpacks it's contents into a folder.
- * If any errors occur, 'error' string is set, and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAFile(APP_DATA *data, char error[ERROR_LENGTH]) {
-    int key1;
-    int key2;
-    DWORD result;
-    DTA_CONTENT_HEADER c = { 0 };
-    DTA_HEADER f = { 0 };
-    DTA_FILE_HEADER h = { 0 };
-
-    /* Prepare for opening, attempt to open the file */
-    data->dtaSetDtaFirstForce();
-    result = data->dtaCreate(data->dtaFile);
-
-    key1 = data->key1;
-    key2 = data->key2;
-
-    /* If it succeeded, load the two keys */
-    if(result) {
-        __asm {
-            mov eax, key1           ; Load the first key into the EAX register
-            xor eax, 034985762h     ; XOR it with the first magic key
-            push eax                
-            mov eax, key2           ; Push the second key onto the EAX stack
-            xor eax, 039475694h     ; XOR it with the second magic key
-            push eax
-            mov ecx, result         ; Load the result into the ECX register -- this is demanded by the function
-            mov eax, [ecx]          ; Load the address of the function table into EAX.
-            call[eax + 0ch]         ; Call the fourth table entry
-        }
-    } else {
-        strncpy_s(error, ERROR_LENGTH, "Failed to open the requested .dta file", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    data->dtaFileHandle = data->dtaOpen(data->dtaFile, 0);
-
-    if(data->dtaFileHandle == DTA_OPEN_FAILED) {
-        strncpy_s(error, ERROR_LENGTH, "The file was mounted successfuly, however opening it failed.", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Reads the initial DTA header (including the magic "ISD0" identifier) and
- * returns TRUE if read correctly. After this function is called, the file
- * position indicator will be set at the beginning of the content header. If
- * any errors occur, 'error' string is set, and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAHeader(APP_DATA *data, char error[ERROR_LENGTH]) {
-    int identifier;
-    DTA_HEADER header = { 0 };
-
-    /* Confirm ISD0 exists */
-    data->dtaRead(data->dtaFileHandle, (char *)&identifier, sizeof(int));
-
-    if(identifier != TRUE_DTA_IDENTIFIER) {
-        strncpy_s(error, ERROR_LENGTH, "File did not begin with \"ISD0\"", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    /* Read and decrypt the rest of the header */
-    data->dtaRead(data->dtaFileHandle, (char *)&header, sizeof(DTA_HEADER));
-    Decrypt((void*)&header, sizeof(DTA_HEADER), data->key1, data->key2);
-
-    data->numOfFiles = header.numOfFiles;
-
-    /* Advance the position indicator */
-    data->dtaSeek(data->dtaFileHandle, header.contentOffset, SEEK_SET);
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Reads the invidiual DTA files, and creates a new file on the hard drive
- * where the file is finally written. If any errors occur, 'error' string is
- * set and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAFiles(APP_DATA *data, char error[ERROR_LENGTH]) {
-    DTA_CONTENT_HEADER *contentHeaders;
-
-    /* Reserve space for all header, read them in and decrypt them */
-    contentHeaders = (DTA_CONTENT_HEADER *)malloc(sizeof(DTA_CONTENT_HEADER) * data->numOfFiles);
-
-    if(contentHeaders == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for content headers", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    data->dtaRead(data->dtaFileHandle, (char *)contentHeaders, sizeof(DTA_CONTENT_HEADER) * data->numOfFiles);
-    Decrypt((void *)contentHeaders, sizeof(DTA_CONTENT_HEADER) * data->numOfFiles, data->key1, data->key2);
-
-    /* Read each file */
-    while(data->numOfFiles--) {
-        int pos = contentHeaders[data->numOfFiles].fileOffset;
-        data->dtaSeek(data->dtaFileHandle, pos, SEEK_SET);
-
-        ProcessFile(data, error);
-    }
-
-    /* Clean up, successful exit */
-    free(contentHeaders);
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Utility function that processes a single file. The function assumes that
- * the position of the stream reader is set at the beginning of the header.
- *
- *  Arguments:      data            Pointer to the APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on successful, false otherwise.
- *--------------------------------------------------------------------------*/
-static BOOL ProcessFile(APP_DATA *data, char error[ERROR_LENGTH]) {
-    DWORD                   fileHandle;
-    char                    filename[256 + 1]   = { 0 };
-    DTA_FILE_HEADER         fileHeader          = { 0 };
-
-    /* Read in the file header, followed by the filename
-       Because we don't know the size of the filename right away, we deal with it
-       seperately. */
-
-    data->dtaRead(data->dtaFileHandle, (char *)&fileHeader, sizeof(DTA_FILE_HEADER));
-    Decrypt((void *)&fileHeader, sizeof(DTA_FILE_HEADER), data->key1, data->key2);
-
-    data->dtaRead(data->dtaFileHandle, filename, fileHeader.filenameLength);
-    Decrypt((void *)filename, fileHeader.filenameLength, data->key1, data->key2);
-    filename[fileHeader.filenameLength] = '\0';
-
-    /* Attempt to open the file */
-    fileHandle = data->dtaOpen(filename, 0);
-
-    if(fileHandle == DTA_OPEN_FAILED) {
-        strncpy_s(error, ERROR_LENGTH, "A file inside the archive could not be opened", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    /* Read the contents into the buffer */
-    if(data->buffer.size < fileHeader.fileSize && !ResizeBuffer(&data->buffer, fileHeader.fileSize)) {
-        strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    data->dtaRead(fileHandle, data->buffer.buf, fileHeader.fileSize);
-
-    WriteToFile(&data->buffer, fileHeader.fileSize, filename);
-    
-    data->dtaClose(fileHandle);
-
-    return TRUE;
-}
+/*  Description:
+ *      Implementation of the functions needed to read through DTA files, as well
+ *      as decrypt headers.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+
+#include <stdio.h>
+#include "DTAFunctions.h"
+#include "Container.h"
+#include "EntryIndex.h"
+#include "Hash.h"
+#include "Manifest.h"
+#include "Parallel.h"
+#include "Pipeline.h"
+#include "Scheduler.h"
+#include "Trace.h"
+
+/*----------------------------------------------------------------------------
+ * Passes the keys to an archive mounted by tmp.dll. The archive object keeps
+ * a function table, and the fourth entry expects both keys XOR'ed with a
+ * magic value. Only available in 32-bit builds.
+ *
+ *  Arguments:      archive         Value returned by dtaCreate
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *--------------------------------------------------------------------------*/
+void CALLBACK DllSetKeys(DWORD archive, unsigned int key1, unsigned int key2) {
+#ifdef _M_IX86
+    __asm {
+        mov eax, key1           ; Load the first key into the EAX register
+        xor eax, 034985762h     ; XOR it with the first magic key
+        push eax                
+        mov eax, key2           ; Push the second key onto the EAX stack
+        xor eax, 039475694h     ; XOR it with the second magic key
+        push eax
+        mov ecx, archive        ; Load the archive into the ECX register -- this is demanded by the function
+        mov eax, [ecx]          ; Load the address of the function table into EAX.
+        call[eax + 0ch]         ; Call the fourth table entry
+    }
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * Creates the directory of every entry in 'index', so that the extraction
+ * itself finds all of them in the cache.
+ *
+ *  Arguments:      data            Pointer to APP_DATA object
+ *                  index           Entries that will be extracted
+ *--------------------------------------------------------------------------*/
+static void CreateDirectories(APP_DATA *data, ENTRY_INDEX *index) {
+    DWORD i;
+
+    for(i = 0; i < index->count; ++i) {
+        char filename[256 + 1];
+
+        /* WriteToFile cleans the name up the same way before asking the cache */
+        strncpy_s(filename, sizeof(filename), ENTRY_NAME(index, i), _TRUNCATE);
+        NormalizePath(filename);
+        CreateParentDirectory(&data->dirCache, filename);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Opens the archive in 'job->dtaFile' through libdta, which reads the
+ * entries, and mounts it in tmp.dll as well unless the reads are native.
+ * If any errors occur, 'error' string is set, and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to open
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFile(ARCHIVE_JOB *job, char error[ERROR_LENGTH]) {
+    APP_DATA            *data       = job->data;
+    DTA_OPEN_OPTIONS    options     = { 0 };
+    char                indexFile[MAX_PATH];
+    DWORD               result;
+    __int64             started;
+
+    /* The entries are kept next to the archive, unless --no-index */
+    if(data->useIndexCache) {
+        _snprintf(indexFile, sizeof(indexFile) - 1, "%s%s", job->dtaFile, DTA_INDEX_EXTENSION);
+        indexFile[sizeof(indexFile) - 1] = '\0';
+
+        options.indexFile = indexFile;
+    }
+
+    started         = BeginTrace();
+    job->archive    = DtaOpenArchiveEx(job->dtaFile, job->key1, job->key2, &options, error);
+    EndTrace(TRACE_ENTRIES, started, job->archive != NULL ? DtaGetEntryCount(job->archive) : 0);
+
+    if(job->archive == NULL)
+        return FALSE;
+
+    /* libdta does the reads as well */
+    if(data->useNative)
+        return TRUE;
+
+    /* Prepare for opening, attempt to open the file */
+    data->dtaSetDtaFirstForce();
+    result = data->dtaCreate(job->dtaFile);
+
+    /* If it succeeded, load the two keys */
+    if(result) {
+        data->dtaSetKeys(result, job->key1, job->key2);
+    } else {
+        strncpy_s(error, ERROR_LENGTH, "Failed to open the requested .dta file", ERROR_LENGTH);
+        CloseDTAFile(job);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Closes the archive opened by ProcessDTAFile.
+ *
+ *  Arguments:      job             Archive to close
+ *--------------------------------------------------------------------------*/
+void CloseDTAFile(ARCHIVE_JOB *job) {
+    DtaCloseArchive(job->archive);
+    job->archive = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the invidiual DTA files, and creates a new file on the hard drive
+ * where the file is finally written. If any errors occur, 'error' string is
+ * set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive opened by ProcessDTAFile
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFiles(ARCHIVE_JOB *job, char error[ERROR_LENGTH]) {
+    APP_DATA            *data   = job->data;
+    ENTRY_INDEX         index;
+    MANIFEST            manifest;
+    BOOL                result;
+
+    if(!PrepareExtraction(job, &index, &manifest, error))
+        return FALSE;
+
+    if(data->numOfThreads > 1 && data->useNative) {
+        /* Hand the entries to the worker threads if the backend allows it */
+        result = ProcessDTAFilesParallel(job, &index, 1, error);
+    } else if(data->usePipeline && data->useNative) {
+        PIPELINE_STATS stats;
+
+        result = ProcessDTAFilesPipelined(job, &index, &stats, error);
+        PrintPipelineStats(&stats);
+    } else {
+        /* Read neighbouring files together, front to back */
+        result = ProcessDTAFilesScheduled(job, &index, error);
+    }
+
+    /* Small files may still be queued for the writer threads */
+    FlushSink(&data->sink);
+
+    return FinishExtraction(job, &index, &manifest, result, error);
+}
+
+/*----------------------------------------------------------------------------
+ * First half of ProcessDTAFiles: fills 'index' with the entries of the
+ * archive that have to be extracted, loads the manifest into 'manifest'
+ * with --incremental, and creates the directories. Every successful call
+ * has to be followed by FinishExtraction. If any errors occur, 'error'
+ * string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive opened by ProcessDTAFile
+ *                  index           Index to fill
+ *                  manifest        Manifest to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL PrepareExtraction(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest, char error[ERROR_LENGTH]) {
+    APP_DATA            *data   = job->data;
+    BOOL                result;
+    __int64             started = BeginTrace();
+
+    /* The entries were read when libdta opened the archive */
+    result = BuildEntryIndex(job->archive, index, error);
+    EndTrace(TRACE_INDEX, started, index->namesSize);
+
+    if(!result)
+        return FALSE;
+
+    /* Drop everything that wasn't asked for */
+    SelectEntries(index, data);
+    job->failedFiles    = 0;
+    job->manifest       = NULL;
+
+    /* And everything an earlier run already extracted */
+    if(data->useManifest && data->sink.type == SINK_FILES && !SkipUnchangedEntries(job, index, manifest, error)) {
+        ReleaseEntryIndex(index);
+        return FALSE;
+    }
+
+    /* Create the whole directory tree before any file is written */
+    if(data->sink.type == SINK_FILES) {
+        started = BeginTrace();
+        CreateDirectories(data, index);
+        EndTrace(TRACE_DIRECTORIES, started, 0);
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Second half of ProcessDTAFiles, once the files of 'index' were extracted:
+ * saves the manifest and releases the index. The queued files of the
+ * output have to be flushed before. If files could not be extracted,
+ * 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive passed to PrepareExtraction
+ *                  index           Index filled by PrepareExtraction
+ *                  manifest        Manifest filled by PrepareExtraction
+ *                  result          Whether the extraction itself succeeded
+ *                  error           Error string, already set if 'result' is FALSE
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL FinishExtraction(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest, BOOL result,
+                      char error[ERROR_LENGTH]) {
+    /* A file that is missing or cut short must not pass for a complete extraction */
+    if(result && job->failedFiles > 0) {
+        _snprintf(error, ERROR_LENGTH - 1, "%ld of the files could not be extracted", job->failedFiles);
+        error[ERROR_LENGTH - 1] = '\0';
+        result = FALSE;
+    }
+
+    if(job->manifest != NULL) {
+        SaveManifest(job, index, manifest);
+        ReleaseManifest(job, manifest);
+    }
+
+    /* Clean up */
+    ReleaseEntryIndex(index);
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Opens the entry at position 'entry' of 'index' for reading, from its
+ * first byte. Returns FALSE if the entry can't be opened.
+ *
+ *  Arguments:      data            Pointer to APP_DATA object
+ *                  index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  stream          Stream to set up
+ *--------------------------------------------------------------------------*/
+BOOL OpenEntryStream(APP_DATA *data, const ENTRY_INDEX *index, DWORD entry, ENTRY_STREAM *stream) {
+    DTA_ENTRY_INFO info;
+
+    stream->data = data;
+
+    if(data->useNative) {
+        GetEntryInfo(index, entry, &info);
+        DtaOpenReader(index->archive, &info, &stream->reader);
+
+        return TRUE;
+    }
+
+    /* tmp.dll finds the entry by its name */
+    stream->fileHandle = data->dtaOpen(ENTRY_NAME(index, entry), 0);
+
+    return stream->fileHandle != DTA_OPEN_FAILED;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes from the position of 'stream' into 'buffer' and
+ * advances the position.
+ *
+ *  Arguments:      stream          Stream set up by OpenEntryStream
+ *                  buffer          Buffer to store data
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes read, 0 at the end of the entry.
+ *--------------------------------------------------------------------------*/
+DWORD ReadEntryStream(ENTRY_STREAM *stream, char *buffer, DWORD size) {
+    if(stream->data->useNative)
+        return DtaRead(&stream->reader, buffer, size);
+
+    return stream->data->dtaRead(stream->fileHandle, buffer, size);
+}
+
+/*----------------------------------------------------------------------------
+ * Moves the position of 'stream' to 'offset' bytes into the entry.
+ *
+ *  Arguments:      stream          Stream set up by OpenEntryStream
+ *                  offset          New position
+ *--------------------------------------------------------------------------*/
+void SeekEntryStream(ENTRY_STREAM *stream, DWORD offset) {
+    if(stream->data->useNative)
+        DtaSeek(&stream->reader, offset, SEEK_SET);
+    else
+        stream->data->dtaSeek(stream->fileHandle, offset, SEEK_SET);
+}
+
+/*----------------------------------------------------------------------------
+ * Closes a stream set up by OpenEntryStream.
+ *
+ *  Arguments:      stream          Stream to close
+ *--------------------------------------------------------------------------*/
+void CloseEntryStream(ENTRY_STREAM *stream) {
+    if(stream->data->useNative)
+        DtaCloseReader(&stream->reader);
+    else
+        stream->data->dtaClose(stream->fileHandle);
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts the entry at position 'entry' of 'index' into 'data->sink'. The
+ * file is streamed through 'buffer' in pieces of at most
+ * 'data->streamWindow' bytes, so large files don't need a buffer of their
+ * own size.
+ *
+ *  Arguments:      data            Pointer to the APP_DATA object
+ *                  index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  buffer          Buffer for the file contents
+ *                  hash            Receives the XXH64 of the file, may be NULL
+ *                  error           Error string
+ *
+ *  Returns TRUE if the whole file was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessFile(APP_DATA *data, const ENTRY_INDEX *index, DWORD entry, BUF_CONTAINER *buffer, unsigned __int64 *hash,
+                 char error[ERROR_LENGTH]) {
+    ENTRY_STREAM    stream;
+    char            *filename   = ENTRY_NAME(index, entry);
+    DWORD           fileSize    = index->fileSizes[entry];
+    DWORD           window      = min(fileSize, data->streamWindow);
+    DWORD           remaining   = fileSize;
+    SINK_ENTRY      output;
+    HASH64_STATE    state;
+    __int64         started     = BeginTrace();
+    BOOL            result      = TRUE;
+
+    /* Attempt to open the file */
+    if(!OpenEntryStream(data, index, entry, &stream)) {
+        strncpy_s(error, ERROR_LENGTH, "A file inside the archive could not be opened", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* The buffer never grows past the window */
+    if(!ReserveBuffer(buffer, max(window, 1))) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+        CloseEntryStream(&stream);
+        return FALSE;
+    }
+
+    if(!BeginSinkEntry(&data->sink, filename, fileSize, &output)) {
+        strncpy_s(error, ERROR_LENGTH, "A file could not be created on the disk", ERROR_LENGTH);
+        CloseEntryStream(&stream);
+        return FALSE;
+    }
+
+    InitHash64(&state, 0);
+
+    /* Read, decrypt and write one window at a time */
+    while(remaining > 0) {
+        __int64 phase   = BeginTrace();
+        DWORD   read    = ReadEntryStream(&stream, buffer->buf, min(remaining, (DWORD)buffer->size));
+
+        EndTrace(TRACE_READ, phase, read);
+
+        if(read == 0) {
+            strncpy_s(error, ERROR_LENGTH, "A file inside the archive could not be read or decoded", ERROR_LENGTH);
+            result = FALSE;
+            break;
+        }
+
+        if(hash != NULL) {
+            phase = BeginTrace();
+            UpdateHash64(&state, buffer->buf, read);
+            EndTrace(TRACE_HASH, phase, read);
+        }
+
+        if(!WriteSinkEntry(&output, buffer->buf, read)) {
+            strncpy_s(error, ERROR_LENGTH, "A file could not be written to the disk", ERROR_LENGTH);
+            result = FALSE;
+            break;
+        }
+
+        remaining -= read;
+    }
+
+    EndSinkEntry(&output);
+    CloseEntryStream(&stream);
+
+    if(hash != NULL)
+        *hash = FinishHash64(&state);
+
+    EndTrace(TRACE_FILE, started, fileSize - remaining);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Prints why a file could not be extracted to stderr and counts it, so that
+ * the archive fails once the other files are done. Any thread may call it.
+ *
+ *  Arguments:      job             Archive holding the file
+ *                  filename        Name of the file inside the archive
+ *                  reason          What went wrong
+ *--------------------------------------------------------------------------*/
+void ReportFailedFile(ARCHIVE_JOB *job, const char *filename, const char *reason) {
+    InterlockedIncrement(&job->failedFiles);
+    fprintf(stderr, "Could not extract %s: %s\n", filename, reason);
+}
@@ -1,174 +1,374 @@
-/*  Description:
- *      Contains the prototypes of the functions needed when the DLL is loaded and
- *      GetProcAddress() is called.
- *
- *  Author: Jovan Stanojlovic
- */
-
-#ifndef DTA_FUNCTIONS_H_
-#define DTA_FUNCTIONS_H_
-
-#include <windows.h>
-#include "Container.h"
-
-/* Length of an error string */
-#define ERROR_LENGTH    128
-
-/* Error codes */
-#define DTA_OPEN_FAILED 0xFFFFFFFF      /* Calling dtaOpen() failed */ 
-
-/*
- * Make things look cleaner. Use these strings when looking for the procedure inside the dll.
- */
-
-#define FUNC_DTABIN2TEXT            "dtaBin2Text"
-#define FUNC_DTACLOSE               "_dtaClose@4"
-#define FUNC_DTACREATE              "_dtaCreate@4"
-#define FUNC_DTADELETE              "dtaDelete"
-#define FUNC_DTADUMPMEMORYLEAKS     "dtaDumpMemoryLeaks"
-#define FUNC_DTAGETTIME             "dtaGetTime"
-#define FUNC_DTAOPEN                "_dtaOpen@8"
-#define FUNC_DTAOPENWRITE           "dtaOpenWrite"
-#define FUNC_DTAREAD                "_dtaRead@12"
-#define FUNC_DTASEEK                "_dtaSeek@12"
-#define FUNC_DTASETDTAFIRSTFORCE    "_dtaSetDtaFirstForce@0"
-#define FUNC_DTAWRITE               "dtaWrite"
-
-/*
- * Function pointers used along with the rw_data.dll to decompress/decrypt the .dta files.
- */
-
-/*--------------------------------------------------------------------------
- * Forces the files to be loaded from the disk first rather than the DTA
- * file. Call this function before doing any other operations.
- *-------------------------------------------------------------------------*/
-typedef void (CALLBACK *FPDtaSetDtaFirstForce)();
-
-/*--------------------------------------------------------------------------
- * Mounts a .DTA file so that further operations can be performed (such as
- * reading and writing).
- *
- *  Arguments:      filename            .DTA file to mount
- *
- *  Returns a non-zero value on success.
- *-------------------------------------------------------------------------*/
-typedef DWORD (CALLBACK *FPDtaCreate)(char *filename);
-
-/*--------------------------------------------------------------------------
- * Opens a file from a .DTA archive. If the call is successful, a handle to
- * the file is returned.
- *
- *  Arguments:      filename            File inside the archive
- *                  d                   Unknown, should be 0
- *
- *  Returns a handle to the file.
- *-------------------------------------------------------------------------*/
-typedef DWORD (CALLBACK *FPDtaOpen)(char *filename, DWORD d);
-
-/*--------------------------------------------------------------------------
- * Reads 'byteCount' bytes from a file inside an archive and stores them
- * into the 'buffer'. Returns the amount of bytes successfuly read.
- *
- *  Arguments:      fileHandle          Handle to the file to read
- *                  buffer              Buffer to store data
- *                  byteCount           Size of data
- *
- *  Returns number of bytes read.
- *-------------------------------------------------------------------------*/
-typedef DWORD (CALLBACK *FPDtaRead)(DWORD fileHandle, char* buffer, DWORD byteCount);
-
-/*--------------------------------------------------------------------------
- * Closes a file inside the archive given the file's handle.
- *
- *  Arguments:      fileHandle          File to close
- *-------------------------------------------------------------------------*/
-typedef void (CALLBACK *FPDtaClose)(DWORD fileHandle);
-
-/*----------------------------------------------------------------------------
- * Move the stream positioner of a file. This function mimmicks fseek, and
- * fseek's 'origin' values can be used.
- *
- *  Arguments:      fileHandle          File to traverse
- *                  offset              Relative offset from 'origin'
- *                  origin              SEEK_SET - Offset from beginning of file
- *                                      SEEK_CUR - Offset from current position
- *                                      SEEK_END - Offset from end of file
- *--------------------------------------------------------------------------*/
-typedef void (CALLBACK *FPDtaSeek)(DWORD fileHandle, DWORD offset, DWORD origin);
-
-
-/*
- * Structure used to simplify things and manage function pointers as well as keys.
- */
-typedef struct t_data {
-    HMODULE                 hDTADLL;
-
-    /* DLL Functions */
-    FPDtaSetDtaFirstForce   dtaSetDtaFirstForce;
-    FPDtaCreate             dtaCreate;
-    FPDtaOpen               dtaOpen;
-    FPDtaRead               dtaRead;
-    FPDtaClose              dtaClose;
-    FPDtaSeek               dtaSeek;
-
-    /* .dta file information */
-    char                    dtaFile[256];
-    DWORD                   dtaFileHandle;
-    unsigned int            key1;
-    unsigned int            key2;
-    DWORD                   numOfFiles;
-
-    /* Memory controller */
-    BUF_CONTAINER           buffer;
-} APP_DATA;
-
-/*----------------------------------------------------------------------------
- * Opens the .dta file, decrypts it, and unpacks it's contents into a folder.
- * If any errors occur, 'error' string is set, and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAFile(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*----------------------------------------------------------------------------
- * Reads the initial DTA header (including the magic "ISD0" identifier) and
- * returns TRUE if read correctly. After this function is called, the file
- * position indicator will be set at the beginning of the content header. If
- * any errors occur, 'error' string is set, and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAHeader(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*----------------------------------------------------------------------------
- * Reads the invidiual DTA files, and creates a new file on the hard drive
- * where the file is finally written. If any errors occur, 'error' string is
- * set and the function returns FALSE.
- *
- *  Arguments:      data            Pointer to APP_DATA object
- *                  error           Error string
- *
- *  Returns TRUE on success, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL ProcessDTAFiles(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*--------------------------------------------------------------------------
- * Decrypts 'buffer' of size 'byteCount' using 'key1' and 'key2' as
- * decryption keys.
- *
- * These keys are more or less specific to the file.
- *
- * Arguments:       buffer          Data to decrypt
- *                  byteCount       Size of data
- *                  key1            First decryption key
- *                  key2            Second decryption key
- *-------------------------------------------------------------------------*/
-void Decrypt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2);
-
-#endif
+/*  Description:
+ *      Contains the prototypes of the functions needed when the DLL is loaded and
+ *      GetProcAddress() is called.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#ifndef DTA_FUNCTIONS_H_
+#define DTA_FUNCTIONS_H_
+
+#include <windows.h>
+#include "Container.h"
+#include "OutputSink.h"
+#include "Dta.h"
+
+/* Length of an error string */
+#define ERROR_LENGTH    128
+
+/* Maximum number of --include or --exclude patterns */
+#define MAX_PATTERNS    32
+
+/* Default for --window, the largest piece of a file held in memory */
+#define DEFAULT_STREAM_WINDOW   (1024 * 1024)
+
+/* Output of --list */
+#define LIST_NONE       0
+#define LIST_TEXT       1
+#define LIST_JSON       2
+
+/* Error codes */
+#define DTA_OPEN_FAILED 0xFFFFFFFF      /* Calling dtaOpen() failed */ 
+
+/*
+ * Make things look cleaner. Use these strings when looking for the procedure inside the dll.
+ */
+
+#define FUNC_DTABIN2TEXT            "dtaBin2Text"
+#define FUNC_DTACLOSE               "_dtaClose@4"
+#define FUNC_DTACREATE              "_dtaCreate@4"
+#define FUNC_DTADELETE              "dtaDelete"
+#define FUNC_DTADUMPMEMORYLEAKS     "dtaDumpMemoryLeaks"
+#define FUNC_DTAGETTIME             "dtaGetTime"
+#define FUNC_DTAOPEN                "_dtaOpen@8"
+#define FUNC_DTAOPENWRITE           "dtaOpenWrite"
+#define FUNC_DTAREAD                "_dtaRead@12"
+#define FUNC_DTASEEK                "_dtaSeek@12"
+#define FUNC_DTASETDTAFIRSTFORCE    "_dtaSetDtaFirstForce@0"
+#define FUNC_DTAWRITE               "dtaWrite"
+
+/*
+ * Function pointers used along with the rw_data.dll to decompress/decrypt the .dta files.
+ */
+
+/*--------------------------------------------------------------------------
+ * Forces the files to be loaded from the disk first rather than the DTA
+ * file. Call this function before doing any other operations.
+ *-------------------------------------------------------------------------*/
+typedef void (CALLBACK *FPDtaSetDtaFirstForce)();
+
+/*--------------------------------------------------------------------------
+ * Mounts a .DTA file so that further operations can be performed (such as
+ * reading and writing).
+ *
+ *  Arguments:      filename            .DTA file to mount
+ *
+ *  Returns a non-zero value on success.
+ *-------------------------------------------------------------------------*/
+typedef DWORD (CALLBACK *FPDtaCreate)(char *filename);
+
+/*--------------------------------------------------------------------------
+ * Opens a file from a .DTA archive. If the call is successful, a handle to
+ * the file is returned.
+ *
+ *  Arguments:      filename            File inside the archive
+ *                  d                   Unknown, should be 0
+ *
+ *  Returns a handle to the file.
+ *-------------------------------------------------------------------------*/
+typedef DWORD (CALLBACK *FPDtaOpen)(char *filename, DWORD d);
+
+/*--------------------------------------------------------------------------
+ * Reads 'byteCount' bytes from a file inside an archive and stores them
+ * into the 'buffer'. Returns the amount of bytes successfuly read.
+ *
+ *  Arguments:      fileHandle          Handle to the file to read
+ *                  buffer              Buffer to store data
+ *                  byteCount           Size of data
+ *
+ *  Returns number of bytes read.
+ *-------------------------------------------------------------------------*/
+typedef DWORD (CALLBACK *FPDtaRead)(DWORD fileHandle, char* buffer, DWORD byteCount);
+
+/*--------------------------------------------------------------------------
+ * Closes a file inside the archive given the file's handle.
+ *
+ *  Arguments:      fileHandle          File to close
+ *-------------------------------------------------------------------------*/
+typedef void (CALLBACK *FPDtaClose)(DWORD fileHandle);
+
+/*----------------------------------------------------------------------------
+ * Move the stream positioner of a file. This function mimmicks fseek, and
+ * fseek's 'origin' values can be used.
+ *
+ *  Arguments:      fileHandle          File to traverse
+ *                  offset              Relative offset from 'origin'
+ *                  origin              SEEK_SET - Offset from beginning of file
+ *                                      SEEK_CUR - Offset from current position
+ *                                      SEEK_END - Offset from end of file
+ *--------------------------------------------------------------------------*/
+typedef void (CALLBACK *FPDtaSeek)(DWORD fileHandle, DWORD offset, DWORD origin);
+
+/*----------------------------------------------------------------------------
+ * Hands the decryption keys to a mounted archive. This is not exported by
+ * the DLL; for tmp.dll it is a call through the archive's function table.
+ *
+ *  Arguments:      archive             Value returned by dtaCreate
+ *                  key1                First decryption key
+ *                  key2                Second decryption key
+ *--------------------------------------------------------------------------*/
+typedef void (CALLBACK *FPDtaSetKeys)(DWORD archive, unsigned int key1, unsigned int key2);
+
+/*
+ * Structure used to simplify things and manage function pointers as well as keys.
+ */
+typedef struct t_data {
+    HMODULE                 hDTADLL;
+
+    /* DLL Functions */
+    FPDtaSetDtaFirstForce   dtaSetDtaFirstForce;
+    FPDtaCreate             dtaCreate;
+    FPDtaOpen               dtaOpen;
+    FPDtaRead               dtaRead;
+    FPDtaClose              dtaClose;
+    FPDtaSeek               dtaSeek;
+    FPDtaSetKeys            dtaSetKeys;
+
+    /* Read the file data through libdta instead of tmp.dll */
+    BOOL                    useNative;
+
+    /* Number of files extracted at the same time */
+    DWORD                   numOfThreads;
+
+    /* Files this large are split across the threads, 0 never splits (see Parallel.h) */
+    DWORD                   splitThreshold;
+
+    /* Largest piece of a file read at once */
+    DWORD                   streamWindow;
+
+    /* Read, decrypt and write on separate threads (see Pipeline.h) */
+    BOOL                    usePipeline;
+    DWORD                   pipelineDepth;
+    DWORD                   pipelineBudget;
+
+    /* Only extract the files matching these patterns (see Glob.h) */
+    char                    *includes[MAX_PATTERNS];
+    DWORD                   numOfIncludes;
+    char                    *excludes[MAX_PATTERNS];
+    DWORD                   numOfExcludes;
+
+    /* Print the entries instead of extracting them (LIST_*) */
+    DWORD                   listFormat;
+
+    /* Keep the entries in a .dtaidx file next to the archive (see IndexFile.h) */
+    BOOL                    useIndexCache;
+
+    /* Write a tar stream here instead of files, "-" is stdout (see OutputSink.h) */
+    char                    *tarFile;
+
+    /* Extract every known archive found in this directory (see KeyTable.h) */
+    char                    *batchDir;
+
+    /* Compare tmp.dll with libdta instead of extracting (see Compare.h) */
+    BOOL                    compareNative;
+
+    /* Time the phases of the run (see Trace.h) */
+    BOOL                    printStats;
+    char                    *traceFile;
+
+    /* Skip the files a .dtamanifest shows as already extracted (see Manifest.h) */
+    BOOL                    useManifest;
+
+    /* Memory controller of the main thread, leased from the pool (see BufferPool.h) */
+    BUF_CONTAINER           buffer;
+
+    /* Back large buffers with large pages (see BufferPool.h) */
+    BOOL                    largePages;
+
+    /* Directories created so far, shared by all threads */
+    DIR_CACHE               dirCache;
+
+    /* Where the extracted files go */
+    OUTPUT_SINK             sink;
+
+    /* Flush every extracted file to the disk before closing it */
+    BOOL                    flushFiles;
+} APP_DATA;
+
+/*
+ * A single archive of the run. APP_DATA holds the options and what every
+ * archive shares, this is what belongs to one of them, so that the archives
+ * of a batch can be extracted at the same time.
+ */
+typedef struct t_archivejob {
+    APP_DATA                *data;
+
+    /* .dta file information */
+    char                    dtaFile[256];
+    unsigned int            key1;
+    unsigned int            key2;
+
+    /* The archive opened through libdta, for its entries and the native reads */
+    DTA_ARCHIVE             *archive;
+
+    /* Records of the extracted files, NULL without --incremental (see Manifest.h) */
+    struct t_manifest       *manifest;
+
+    /* Files that could not be extracted, see ReportFailedFile */
+    LONG volatile           failedFiles;
+} ARCHIVE_JOB;
+
+struct t_entryindex;
+
+/*
+ * A single entry opened for reading, through libdta or through tmp.dll,
+ * whichever 'data->useNative' picks.
+ */
+typedef struct t_entrystream {
+    APP_DATA        *data;
+    DTA_READER      reader;             /* libdta */
+    DWORD           fileHandle;         /* tmp.dll */
+} ENTRY_STREAM;
+
+/*----------------------------------------------------------------------------
+ * Passes the keys to an archive mounted by tmp.dll. The archive object keeps
+ * a function table, and the fourth entry expects both keys XOR'ed with a
+ * magic value. Only available in 32-bit builds.
+ *
+ *  Arguments:      archive         Value returned by dtaCreate
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *--------------------------------------------------------------------------*/
+void CALLBACK DllSetKeys(DWORD archive, unsigned int key1, unsigned int key2);
+
+/*----------------------------------------------------------------------------
+ * Opens the archive in 'job->dtaFile' through libdta, which reads the
+ * entries, and mounts it in tmp.dll as well unless the reads are native.
+ * If any errors occur, 'error' string is set, and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to open
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFile(ARCHIVE_JOB *job, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Closes the archive opened by ProcessDTAFile.
+ *
+ *  Arguments:      job             Archive to close
+ *--------------------------------------------------------------------------*/
+void CloseDTAFile(ARCHIVE_JOB *job);
+
+/*----------------------------------------------------------------------------
+ * Reads the invidiual DTA files, and creates a new file on the hard drive
+ * where the file is finally written. If any errors occur, 'error' string is
+ * set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive opened by ProcessDTAFile
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFiles(ARCHIVE_JOB *job, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * First half of ProcessDTAFiles: fills 'index' with the entries of the
+ * archive that have to be extracted, loads the manifest into 'manifest'
+ * with --incremental, and creates the directories. Every successful call
+ * has to be followed by FinishExtraction. If any errors occur, 'error'
+ * string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive opened by ProcessDTAFile
+ *                  index           Index to fill
+ *                  manifest        Manifest to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL PrepareExtraction(ARCHIVE_JOB *job, struct t_entryindex *index, struct t_manifest *manifest, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Second half of ProcessDTAFiles, once the files of 'index' were extracted:
+ * saves the manifest and releases the index. The queued files of the
+ * output have to be flushed before. If files could not be extracted,
+ * 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive passed to PrepareExtraction
+ *                  index           Index filled by PrepareExtraction
+ *                  manifest        Manifest filled by PrepareExtraction
+ *                  result          Whether the extraction itself succeeded
+ *                  error           Error string, already set if 'result' is FALSE
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL FinishExtraction(ARCHIVE_JOB *job, struct t_entryindex *index, struct t_manifest *manifest, BOOL result,
+                      char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Opens the entry at position 'entry' of 'index' for reading, from its
+ * first byte. Returns FALSE if the entry can't be opened.
+ *
+ *  Arguments:      data            Pointer to APP_DATA object
+ *                  index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  stream          Stream to set up
+ *--------------------------------------------------------------------------*/
+BOOL OpenEntryStream(APP_DATA *data, const struct t_entryindex *index, DWORD entry, ENTRY_STREAM *stream);
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes from the position of 'stream' into 'buffer' and
+ * advances the position.
+ *
+ *  Arguments:      stream          Stream set up by OpenEntryStream
+ *                  buffer          Buffer to store data
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes read, 0 at the end of the entry.
+ *--------------------------------------------------------------------------*/
+DWORD ReadEntryStream(ENTRY_STREAM *stream, char *buffer, DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Moves the position of 'stream' to 'offset' bytes into the entry.
+ *
+ *  Arguments:      stream          Stream set up by OpenEntryStream
+ *                  offset          New position
+ *--------------------------------------------------------------------------*/
+void SeekEntryStream(ENTRY_STREAM *stream, DWORD offset);
+
+/*----------------------------------------------------------------------------
+ * Closes a stream set up by OpenEntryStream.
+ *
+ *  Arguments:      stream          Stream to close
+ *--------------------------------------------------------------------------*/
+void CloseEntryStream(ENTRY_STREAM *stream);
+
+/*----------------------------------------------------------------------------
+ * Extracts the entry at position 'entry' of 'index' into 'data->sink'. The
+ * file is streamed through 'buffer' in pieces of at most
+ * 'data->streamWindow' bytes, so large files don't need a buffer of their
+ * own size.
+ *
+ *  Arguments:      data            Pointer to the APP_DATA object
+ *                  index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  buffer          Buffer for the file contents
+ *                  hash            Receives the XXH64 of the file, may be NULL
+ *                  error           Error string
+ *
+ *  Returns TRUE if the whole file was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessFile(APP_DATA *data, const struct t_entryindex *index, DWORD entry, BUF_CONTAINER *buffer, unsigned __int64 *hash,
+                 char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Prints why a file could not be extracted to stderr and counts it, so that
+ * the archive fails once the other files are done. Any thread may call it.
+ *
+ *  Arguments:      job             Archive holding the file
+ *                  filename        Name of the file inside the archive
+ *                  reason          What went wrong
+ *--------------------------------------------------------------------------*/
+void ReportFailedFile(ARCHIVE_JOB *job, const char *filename, const char *reason);
+
+#endif
@@ -0,0 +1,208 @@
+/*  Description:
+ *      Implementation of the directory cache. Every prefix of a path is a
+ *      directory of its own, so the prefixes are looked up from the top down
+ *      and only the missing ones are created and added.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "DirCache.h"
+
+#define DIR_CACHE_INITIAL_CAPACITY  256
+
+/*----------------------------------------------------------------------------
+ * Returns the FNV-1a hash of the first 'length' characters of 'path',
+ * ignoring case.
+ *--------------------------------------------------------------------------*/
+static DWORD HashPath(const char *path, size_t length) {
+    DWORD   hash = 2166136261u;
+    size_t  i;
+
+    for(i = 0; i < length; ++i) {
+        hash ^= (unsigned char)tolower((unsigned char)path[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the slot that holds the first 'length' characters of 'path', or
+ * the empty slot where they belong.
+ *--------------------------------------------------------------------------*/
+static char **FindSlot(char **slots, DWORD capacity, const char *path, size_t length) {
+    DWORD index = HashPath(path, length) & (capacity - 1);
+
+    while(slots[index] != NULL) {
+        if(strlen(slots[index]) == length && _strnicmp(slots[index], path, length) == 0)
+            break;
+
+        index = (index + 1) & (capacity - 1);
+    }
+
+    return &slots[index];
+}
+
+/*----------------------------------------------------------------------------
+ * Doubles the capacity of the set. Returns FALSE if out of memory.
+ *--------------------------------------------------------------------------*/
+static BOOL GrowCache(DIR_CACHE *cache) {
+    DWORD   capacity = cache->capacity * 2;
+    char    **slots;
+    DWORD   i;
+
+    if((slots = (char **)calloc(capacity, sizeof(char *))) == NULL)
+        return FALSE;
+
+    for(i = 0; i < cache->capacity; ++i) {
+        if(cache->slots[i] != NULL)
+            *FindSlot(slots, capacity, cache->slots[i], strlen(cache->slots[i])) = cache->slots[i];
+    }
+
+    free(cache->slots);
+    cache->slots    = slots;
+    cache->capacity = capacity;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Initializes an empty cache. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *--------------------------------------------------------------------------*/
+BOOL InitDirCache(DIR_CACHE *cache) {
+    if((cache->slots = (char **)calloc(DIR_CACHE_INITIAL_CAPACITY, sizeof(char *))) == NULL)
+        return FALSE;
+
+    cache->capacity = DIR_CACHE_INITIAL_CAPACITY;
+    cache->count    = 0;
+    InitializeCriticalSection(&cache->lock);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Makes sure the directory 'path' and all of its parents exist. Only the
+ * directories that are not in the cache yet are passed to CreateDirectory.
+ * 'path' uses backslashes and has no trailing backslash. Returns FALSE if
+ * the path could not be added to the cache.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *                      path            Directory to create
+ *--------------------------------------------------------------------------*/
+BOOL CreateDirectoryCached(DIR_CACHE *cache, const char *path) {
+    char    prefix[256 + 1];
+    size_t  length = strlen(path);
+    size_t  i;
+    BOOL    result = TRUE;
+
+    if(length == 0 || length >= sizeof(prefix))
+        return FALSE;
+
+    /* The lock is held while creating, so no thread sees a directory in the
+       cache before it exists on the disk */
+    EnterCriticalSection(&cache->lock);
+
+    if(*FindSlot(cache->slots, cache->capacity, path, length) == NULL) {
+        for(i = 1; i <= length && result; ++i) {
+            char **slot;
+
+            if(i < length && path[i] != '\\')
+                continue;
+
+            slot = FindSlot(cache->slots, cache->capacity, path, i);
+
+            if(*slot != NULL)
+                continue;
+
+            memcpy(prefix, path, i);
+            prefix[i] = '\0';
+
+            CreateDirectory(prefix, NULL);
+
+            if((*slot = (char *)malloc(i + 1)) == NULL) {
+                result = FALSE;
+                break;
+            }
+
+            memcpy(*slot, prefix, i + 1);
+
+            /* Keep the load factor under one half */
+            if(++cache->count * 2 >= cache->capacity)
+                result = GrowCache(cache);
+        }
+    }
+
+    LeaveCriticalSection(&cache->lock);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Drops leading and repeated backslashes from 'path', in place, so that the
+ * same directory is always spelled the same way. Returns the new length.
+ *
+ *  Arguments:          path            Path to clean up
+ *--------------------------------------------------------------------------*/
+size_t NormalizePath(char *path) {
+    size_t  length = 0;
+    char    *read;
+
+    for(read = path; *read != '\0'; ++read) {
+        if(*read == '\\' && (length == 0 || path[length - 1] == '\\'))
+            continue;
+
+        path[length++] = *read;
+    }
+
+    path[length] = '\0';
+
+    return length;
+}
+
+/*----------------------------------------------------------------------------
+ * Creates the directory that 'filename' will be written to, see
+ * CreateDirectoryCached. 'filename' must already be normalized. Does
+ * nothing if the file has no directory.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *                      filename        Path of a file
+ *--------------------------------------------------------------------------*/
+BOOL CreateParentDirectory(DIR_CACHE *cache, const char *filename) {
+    char        path[256 + 1];
+    const char  *separator = strrchr(filename, '\\');
+    size_t      length;
+
+    if(separator == NULL || separator == filename)
+        return TRUE;
+
+    length = separator - filename;
+
+    if(length >= sizeof(path))
+        return FALSE;
+
+    memcpy(path, filename, length);
+    path[length] = '\0';
+
+    return CreateDirectoryCached(cache, path);
+}
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the cache. The directories are left alone.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *--------------------------------------------------------------------------*/
+void ReleaseDirCache(DIR_CACHE *cache) {
+    DWORD i;
+
+    for(i = 0; i < cache->capacity; ++i)
+        free(cache->slots[i]);
+
+    free(cache->slots);
+    cache->slots = NULL;
+    DeleteCriticalSection(&cache->lock);
+}
@@ -0,0 +1,68 @@
+/*  Description:
+ *      A set of the directories already created during this run. WriteToFile
+ *      asks the cache for the parent directory of every file, so each
+ *      directory is created once instead of once per file. The set is guarded
+ *      by a critical section and can be shared between threads.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DIR_CACHE_H_
+#define DIR_CACHE_H_
+
+#include <windows.h>
+
+/*
+ * Open-addressed hash set of directory paths. Paths are compared without
+ * regard to case, like the file system does.
+ */
+typedef struct t_dircache {
+    CRITICAL_SECTION    lock;
+    char                **slots;
+    DWORD               capacity;       /* Always a power of two */
+    DWORD               count;
+} DIR_CACHE;
+
+/*----------------------------------------------------------------------------
+ * Initializes an empty cache. Returns TRUE if successful, FALSE otherwise.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *--------------------------------------------------------------------------*/
+BOOL InitDirCache(DIR_CACHE *cache);
+
+/*----------------------------------------------------------------------------
+ * Makes sure the directory 'path' and all of its parents exist. Only the
+ * directories that are not in the cache yet are passed to CreateDirectory.
+ * 'path' uses backslashes and has no trailing backslash. Returns FALSE if
+ * the path could not be added to the cache.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *                      path            Directory to create
+ *--------------------------------------------------------------------------*/
+BOOL CreateDirectoryCached(DIR_CACHE *cache, const char *path);
+
+/*----------------------------------------------------------------------------
+ * Drops leading and repeated backslashes from 'path', in place, so that the
+ * same directory is always spelled the same way. Returns the new length.
+ *
+ *  Arguments:          path            Path to clean up
+ *--------------------------------------------------------------------------*/
+size_t NormalizePath(char *path);
+
+/*----------------------------------------------------------------------------
+ * Creates the directory that 'filename' will be written to, see
+ * CreateDirectoryCached. 'filename' must already be normalized. Does
+ * nothing if the file has no directory.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *                      filename        Path of a file
+ *--------------------------------------------------------------------------*/
+BOOL CreateParentDirectory(DIR_CACHE *cache, const char *filename);
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the cache. The directories are left alone.
+ *
+ *  Arguments:          cache           Pointer to the cache
+ *--------------------------------------------------------------------------*/
+void ReleaseDirCache(DIR_CACHE *cache);
+
+#endif
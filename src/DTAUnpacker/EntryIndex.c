@@ -0,0 +1,189 @@
+/*  Description:
+ *      Implementation of the entry index. The arrays share one allocation and
+ *      the names are copied into a single pool, so an index of a large
+ *      archive is only two allocations no matter how many entries it has.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EntryIndex.h"
+#include "Glob.h"
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'name' matches any of the 'count' patterns.
+ *--------------------------------------------------------------------------*/
+static BOOL MatchAny(char * const patterns[], DWORD count, const char *name) {
+    DWORD i;
+
+    for(i = 0; i < count; ++i) {
+        if(MatchGlob(patterns[i], name))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * Allocates the arrays of an index of up to 'count' entries in one block.
+ * Returns FALSE if there is no memory for them.
+ *--------------------------------------------------------------------------*/
+static BOOL AllocateEntries(ENTRY_INDEX *index, DWORD count) {
+    DWORD *arena = (DWORD *)malloc(sizeof(DWORD) * 6 * count + 1);
+
+    if(arena == NULL)
+        return FALSE;
+
+    index->arena        = arena;
+    index->entries      = arena;
+    index->fileOffsets  = arena + count;
+    index->dataOffsets  = arena + count * 2;
+    index->fileSizes    = arena + count * 3;
+    index->nameOffsets  = arena + count * 4;
+    index->storedSizes  = arena + count * 5;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'index' with every entry of 'archive', in archive order. If any
+ * errors occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      archive         Archive opened through libdta
+ *                  index           Index to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL BuildEntryIndex(const DTA_ARCHIVE *archive, ENTRY_INDEX *index, char error[ERROR_LENGTH]) {
+    DWORD           count = DtaGetEntryCount(archive);
+    DTA_ITERATOR    iterator;
+    DTA_ENTRY_INFO  info;
+
+    memset(index, 0, sizeof(ENTRY_INDEX));
+
+    index->archive = archive;
+
+    /* Size the pool first, the names are copied in one pass */
+    DtaBeginEntries(archive, &iterator);
+
+    while(DtaNextEntry(&iterator, &info))
+        index->namesSize += (DWORD)strlen(info.name) + 1;
+
+    index->names = (char *)malloc(index->namesSize + 1);
+
+    if(!AllocateEntries(index, count) || index->names == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the entry index", ERROR_LENGTH);
+        ReleaseEntryIndex(index);
+        return FALSE;
+    }
+
+    index->namesSize = 0;
+    DtaBeginEntries(archive, &iterator);
+
+    while(DtaNextEntry(&iterator, &info)) {
+        DWORD entry     = index->count++;
+        DWORD length    = (DWORD)strlen(info.name) + 1;
+
+        index->entries[entry]       = iterator.next - 1;
+        index->fileOffsets[entry]   = info.fileOffset;
+        index->dataOffsets[entry]   = info.dataOffset;
+        index->fileSizes[entry]     = info.fileSize;
+        index->storedSizes[entry]   = info.storedSize;
+        index->nameOffsets[entry]   = index->namesSize;
+
+        memcpy(index->names + index->namesSize, info.name, length);
+        index->namesSize += length;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the libdta entry at position 'entry', for reading it
+ * through the archive.
+ *
+ *  Arguments:      index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+void GetEntryInfo(const ENTRY_INDEX *index, DWORD entry, DTA_ENTRY_INFO *info) {
+    DtaGetEntry(index->archive, index->entries[entry], info);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'name' matches one of the include patterns (or there are
+ * none) and none of the exclude patterns.
+ *
+ *  Arguments:      data            APP_DATA holding the patterns
+ *                  name            Name of an entry
+ *--------------------------------------------------------------------------*/
+BOOL IsEntrySelected(const APP_DATA *data, const char *name) {
+    if(data->numOfIncludes > 0 && !MatchAny(data->includes, data->numOfIncludes, name))
+        return FALSE;
+
+    return !MatchAny(data->excludes, data->numOfExcludes, name);
+}
+
+/*----------------------------------------------------------------------------
+ * Keeps only the entries that match one of the include patterns (all of
+ * them if there are none) and none of the exclude patterns. What is left
+ * stays sorted by file offset, so the data is read front to back.
+ *
+ *  Arguments:      index           Index to filter
+ *                  data            APP_DATA holding the patterns
+ *--------------------------------------------------------------------------*/
+void SelectEntries(ENTRY_INDEX *index, const APP_DATA *data) {
+    DWORD kept = 0;
+    DWORD i;
+
+    /* Nothing to drop, leave the arrays alone */
+    if(data->numOfIncludes == 0 && data->numOfExcludes == 0)
+        return;
+
+    for(i = 0; i < index->count; ++i) {
+        if(IsEntrySelected(data, ENTRY_NAME(index, i)))
+            MoveEntry(index, kept++, i);
+    }
+
+    index->count = kept;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies every field of the entry at 'from' to the position 'to', for
+ * filters that compact the index in place.
+ *
+ *  Arguments:      index           Index being compacted
+ *                  to              Position to fill
+ *                  from            Position of the entry to keep
+ *--------------------------------------------------------------------------*/
+void MoveEntry(ENTRY_INDEX *index, DWORD to, DWORD from) {
+    index->entries[to]      = index->entries[from];
+    index->fileOffsets[to]  = index->fileOffsets[from];
+    index->dataOffsets[to]  = index->dataOffsets[from];
+    index->fileSizes[to]    = index->fileSizes[from];
+    index->storedSizes[to]  = index->storedSizes[from];
+    index->nameOffsets[to]  = index->nameOffsets[from];
+}
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the index.
+ *
+ *  Arguments:      index           Index to release
+ *--------------------------------------------------------------------------*/
+void ReleaseEntryIndex(ENTRY_INDEX *index) {
+    free(index->arena);
+    free(index->names);
+
+    index->arena        = NULL;
+    index->entries      = NULL;
+    index->fileOffsets  = NULL;
+    index->dataOffsets  = NULL;
+    index->fileSizes    = NULL;
+    index->storedSizes  = NULL;
+    index->nameOffsets  = NULL;
+    index->names        = NULL;
+    index->count        = 0;
+}
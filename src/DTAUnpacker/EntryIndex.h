@@ -0,0 +1,97 @@
+/*  Description:
+ *      In-memory index of the entries inside an archive. It is built from the
+ *      entries libdta read when the archive was opened, so it never touches
+ *      the archive itself, and it can be filtered before anything is
+ *      extracted.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef ENTRY_INDEX_H_
+#define ENTRY_INDEX_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/*
+ * All entries of an archive, sorted by file offset. An entry is a position
+ * in the arrays below; each array holds one field of every entry, so a scan
+ * over sizes or offsets only touches the memory of that field. The arrays
+ * are carved out of a single allocation, and the names of all entries are
+ * packed into one pool.
+ */
+typedef struct t_entryindex {
+    const DTA_ARCHIVE   *archive;       /* Archive the entries belong to */
+    DWORD               *entries;       /* Number of each entry inside 'archive' */
+    DWORD               *fileOffsets;   /* Offset of each DTA_FILE_HEADER */
+    DWORD               *dataOffsets;   /* Offset of each file's first block, right after its name */
+    DWORD               *fileSizes;     /* Size of each file once decoded */
+    DWORD               *storedSizes;   /* Bytes from each file's first block up to the next entry */
+    DWORD               *nameOffsets;   /* Offset of each name inside 'names' */
+    DWORD               count;
+    char                *names;         /* Zero-terminated names, one after another */
+    DWORD               namesSize;
+    void                *arena;         /* Holds the arrays */
+} ENTRY_INDEX;
+
+/* Name of the entry at position 'i' */
+#define ENTRY_NAME(index, i)        ((index)->names + (index)->nameOffsets[i])
+
+/*----------------------------------------------------------------------------
+ * Fills 'index' with every entry of 'archive', in archive order. If any
+ * errors occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      archive         Archive opened through libdta
+ *                  index           Index to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL BuildEntryIndex(const DTA_ARCHIVE *archive, ENTRY_INDEX *index, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the libdta entry at position 'entry', for reading it
+ * through the archive.
+ *
+ *  Arguments:      index           Index holding the entry
+ *                  entry           Position of the entry
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+void GetEntryInfo(const ENTRY_INDEX *index, DWORD entry, DTA_ENTRY_INFO *info);
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'name' matches one of the include patterns (or there are
+ * none) and none of the exclude patterns.
+ *
+ *  Arguments:      data            APP_DATA holding the patterns
+ *                  name            Name of an entry
+ *--------------------------------------------------------------------------*/
+BOOL IsEntrySelected(const APP_DATA *data, const char *name);
+
+/*----------------------------------------------------------------------------
+ * Keeps only the entries that match one of the include patterns (all of
+ * them if there are none) and none of the exclude patterns. What is left
+ * stays sorted by file offset, so the data is read front to back.
+ *
+ *  Arguments:      index           Index to filter
+ *                  data            APP_DATA holding the patterns
+ *--------------------------------------------------------------------------*/
+void SelectEntries(ENTRY_INDEX *index, const APP_DATA *data);
+
+/*----------------------------------------------------------------------------
+ * Copies every field of the entry at 'from' to the position 'to', for
+ * filters that compact the index in place.
+ *
+ *  Arguments:      index           Index being compacted
+ *                  to              Position to fill
+ *                  from            Position of the entry to keep
+ *--------------------------------------------------------------------------*/
+void MoveEntry(ENTRY_INDEX *index, DWORD to, DWORD from);
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the index.
+ *
+ *  Arguments:      index           Index to release
+ *--------------------------------------------------------------------------*/
+void ReleaseEntryIndex(ENTRY_INDEX *index);
+
+#endif
@@ -0,0 +1,519 @@
+/*  Description:
+ *      Implementation of the writer threads. Every thread has a lane: a ring
+ *      of full batches driven by two semaphores, like the pipeline, and the
+ *      batch that is being filled for it. A batch is a single buffer leased
+ *      from the pool, a small header followed by the queued files, each one a
+ *      WRITER_RECORD, its name and its data.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <process.h>
+#include "FileWriter.h"
+#include "BufferPool.h"
+#include "Container.h"
+#include "Hash.h"
+#include "Trace.h"
+
+/* Records are kept 8-byte aligned */
+#define ALIGN8(n)               (((n) + 7) & ~(size_t)7)
+
+/*
+ * Header of a batch, the records follow at BATCH_RECORDS.
+ */
+typedef struct t_writerbatch {
+    size_t  size;                   /* Leased size of the whole batch */
+    size_t  used;                   /* Bytes of records */
+    DWORD   numOfFiles;
+} WRITER_BATCH;
+
+#define BATCH_HEADER            ALIGN8(sizeof(WRITER_BATCH))
+#define BATCH_RECORDS(batch)    ((char *)(batch) + BATCH_HEADER)
+
+/*
+ * A queued file, followed by its zero-terminated name and its data.
+ */
+typedef struct t_writerrecord {
+    DWORD           size;
+    DWORD           nameLength;     /* Including the terminating zero */
+    LONG volatile   *failed;        /* Bumped if the file can't be written, may be NULL */
+} WRITER_RECORD;
+
+#define RECORD_LENGTH(nameLength, size) ALIGN8(sizeof(WRITER_RECORD) + (size_t)(nameLength) + (size_t)(size))
+
+/*
+ * A writer thread and its queue. The ring is filled only while the lock of
+ * the writer is held, and emptied only by the thread.
+ */
+typedef struct t_writerlane {
+    struct t_filewriter *writer;
+    HANDLE              hThread;
+    HANDLE              hQueued;        /* Counts batches in the ring */
+    HANDLE              hFree;          /* Counts free places in the ring */
+    HANDLE              hIdle;          /* Set while nothing is queued or being written */
+    CRITICAL_SECTION    lock;           /* Guards 'pending' along with hIdle */
+    WRITER_BATCH        *ring[WRITER_MAX_BATCHES];
+    DWORD               head;
+    DWORD               tail;
+    DWORD               pending;        /* Batches queued or being written */
+    WRITER_BATCH        *current;       /* Batch being filled */
+} WRITER_LANE;
+
+struct t_filewriter {
+    DIR_CACHE           *dirs;
+    BOOL                flush;
+    DWORD               numOfThreads;
+    CRITICAL_SECTION    lock;           /* Held while a batch is filled or handed over */
+    WRITER_LANE         lanes[WRITER_MAX_THREADS];
+    LONG                files;
+    LONG                batches;
+    LONG                failed;
+    CRITICAL_SECTION    failedLock;     /* Guards the names below, the threads add to them */
+    char                *failedNames;   /* Zero-terminated names of the files that failed since the last flush */
+    size_t              failedSize;
+    DWORD               numOfFailedNames;
+};
+
+/*----------------------------------------------------------------------------
+ * Returns the lane that writes 'filename'. Names that end up as the same
+ * file on the disk always get the same lane.
+ *--------------------------------------------------------------------------*/
+static WRITER_LANE *PickLane(FILE_WRITER *writer, const char *filename) {
+    char    path[256 + 1];
+    size_t  length;
+    size_t  i;
+
+    strncpy_s(path, sizeof(path), filename, _TRUNCATE);
+    length = NormalizePath(path);
+
+    /* The file system doesn't care about case either */
+    for(i = 0; i < length; ++i)
+        path[i] = (char)tolower((unsigned char)path[i]);
+
+    return &writer->lanes[Hash64(path, length, 0) % writer->numOfThreads];
+}
+
+/*----------------------------------------------------------------------------
+ * Creates a single file and writes 'n' bytes to it. Returns FALSE if that
+ * failed.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteSmallFile(FILE_WRITER *writer, char *filename, const char *buf, DWORD n) {
+    DWORD   written = 0;
+    HANDLE  hFile;
+    BOOL    result;
+    __int64 started = BeginTrace();
+
+    hFile = CreateOutputFile(filename, writer->dirs);
+    EndTrace(TRACE_CREATE, started, 0);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    started = BeginTrace();
+    result  = WriteFile(hFile, buf, n, &written, NULL) && written == n;
+    EndTrace(TRACE_WRITE, started, written);
+
+    if(writer->flush && !FlushFileBuffers(hFile))
+        result = FALSE;
+
+    CloseHandle(hFile);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Counts a file that could not be written and keeps its name until the
+ * next PrintFailedFiles. Any thread may call it.
+ *--------------------------------------------------------------------------*/
+static void AddFailedFile(FILE_WRITER *writer, WRITER_RECORD *header, const char *name) {
+    char *names;
+
+    InterlockedIncrement(&writer->failed);
+
+    if(header->failed != NULL)
+        InterlockedIncrement(header->failed);
+
+    EnterCriticalSection(&writer->failedLock);
+
+    /* Without memory the file is still counted, only its name is lost */
+    names = (char *)realloc(writer->failedNames, writer->failedSize + header->nameLength);
+
+    if(names != NULL) {
+        memcpy(names + writer->failedSize, name, header->nameLength);
+
+        writer->failedNames     = names;
+        writer->failedSize     += header->nameLength;
+        ++writer->numOfFailedNames;
+    }
+
+    LeaveCriticalSection(&writer->failedLock);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes every file of 'batch'.
+ *--------------------------------------------------------------------------*/
+static void WriteBatch(FILE_WRITER *writer, WRITER_BATCH *batch) {
+    char    *record = BATCH_RECORDS(batch);
+    DWORD   i;
+
+    for(i = 0; i < batch->numOfFiles; ++i) {
+        WRITER_RECORD   *header = (WRITER_RECORD *)record;
+        char            *name   = record + sizeof(WRITER_RECORD);
+
+        if(!WriteSmallFile(writer, name, name + header->nameLength, header->size))
+            AddFailedFile(writer, header, name);
+
+        record += RECORD_LENGTH(header->nameLength, header->size);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Writer thread. Writes the batches of its lane in order until it takes a
+ * NULL batch.
+ *
+ *  Arguments:      param           Pointer to the WRITER_LANE
+ *--------------------------------------------------------------------------*/
+static unsigned __stdcall WriterProc(void *param) {
+    WRITER_LANE *lane = (WRITER_LANE *)param;
+
+    for(;;) {
+        WRITER_BATCH    *batch;
+
+        WaitForSingleObject(lane->hQueued, INFINITE);
+
+        batch       = lane->ring[lane->head];
+        lane->head  = (lane->head + 1) % WRITER_MAX_BATCHES;
+        ReleaseSemaphore(lane->hFree, 1, NULL);
+
+        if(batch == NULL) {
+            FlushBufferCache();
+            return 0;
+        }
+
+        WriteBatch(lane->writer, batch);
+        ReturnBuffer((char *)batch, batch->size);
+
+        EnterCriticalSection(&lane->lock);
+
+        if(--lane->pending == 0)
+            SetEvent(lane->hIdle);
+
+        LeaveCriticalSection(&lane->lock);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Hands the batch being filled for 'lane' to its thread, or tells the
+ * thread to stop if there is none. Waits while the ring is full. The lock
+ * of the writer must be held.
+ *--------------------------------------------------------------------------*/
+static void SubmitBatch(FILE_WRITER *writer, WRITER_LANE *lane) {
+    WRITER_BATCH *batch = lane->current;
+
+    lane->current = NULL;
+
+    WaitForSingleObject(lane->hFree, INFINITE);
+
+    EnterCriticalSection(&lane->lock);
+
+    if(lane->pending++ == 0)
+        ResetEvent(lane->hIdle);
+
+    LeaveCriticalSection(&lane->lock);
+
+    lane->ring[lane->tail]  = batch;
+    lane->tail              = (lane->tail + 1) % WRITER_MAX_BATCHES;
+    ReleaseSemaphore(lane->hQueued, 1, NULL);
+
+    if(batch != NULL)
+        ++writer->batches;
+}
+
+/*----------------------------------------------------------------------------
+ * Creates the events of 'lane' and starts its thread. Returns FALSE if that
+ * failed, nothing is left to clean up then.
+ *--------------------------------------------------------------------------*/
+static BOOL StartLane(FILE_WRITER *writer, WRITER_LANE *lane) {
+    lane->writer    = writer;
+    lane->hQueued   = CreateSemaphore(NULL, 0, WRITER_MAX_BATCHES, NULL);
+    lane->hFree     = CreateSemaphore(NULL, WRITER_MAX_BATCHES, WRITER_MAX_BATCHES, NULL);
+    lane->hIdle     = CreateEvent(NULL, TRUE, TRUE, NULL);
+
+    if(lane->hQueued != NULL && lane->hFree != NULL && lane->hIdle != NULL) {
+        InitializeCriticalSection(&lane->lock);
+
+        if((lane->hThread = (HANDLE)_beginthreadex(NULL, 0, WriterProc, lane, 0, NULL)) != NULL)
+            return TRUE;
+
+        DeleteCriticalSection(&lane->lock);
+    }
+
+    if(lane->hQueued != NULL)
+        CloseHandle(lane->hQueued);
+
+    if(lane->hFree != NULL)
+        CloseHandle(lane->hFree);
+
+    if(lane->hIdle != NULL)
+        CloseHandle(lane->hIdle);
+
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * Starts 'numOfThreads' writer threads. Returns NULL if they could not be
+ * started, files are then written directly.
+ *
+ *  Arguments:      dirs            Directories created so far
+ *                  numOfThreads    Number of threads
+ *                  flush           Flush every file to the disk before
+ *                                  closing it
+ *--------------------------------------------------------------------------*/
+FILE_WRITER *StartFileWriter(DIR_CACHE *dirs, DWORD numOfThreads, BOOL flush) {
+    FILE_WRITER *writer;
+    DWORD       i;
+
+    if((writer = (FILE_WRITER *)calloc(1, sizeof(FILE_WRITER))) == NULL)
+        return NULL;
+
+    writer->dirs    = dirs;
+    writer->flush   = flush;
+
+    InitializeCriticalSection(&writer->lock);
+    InitializeCriticalSection(&writer->failedLock);
+
+    numOfThreads = max(1, min(numOfThreads, WRITER_MAX_THREADS));
+
+    /* Only the lanes that started are counted, so StopFileWriter can undo them */
+    for(i = 0; i < numOfThreads; ++i) {
+        if(!StartLane(writer, &writer->lanes[i])) {
+            StopFileWriter(writer);
+            return NULL;
+        }
+
+        writer->numOfThreads = i + 1;
+    }
+
+    return writer;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies a file of at most WRITER_SMALL_FILE bytes into the queue of its
+ * thread. Waits if that thread is too far behind. Returns FALSE if the file
+ * is too large, it has to be written directly then. If the thread can't
+ * write the file, 'failed' is incremented and the name is kept for
+ * PrintFailedFiles.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  filename        Name of the file inside the archive
+ *                  buf             File data
+ *                  n               Size of the file
+ *                  failed          Counter of failed files, may be NULL
+ *--------------------------------------------------------------------------*/
+BOOL QueueFile(FILE_WRITER *writer, const char *filename, const void *buf, DWORD n, LONG volatile *failed) {
+    DWORD           nameLength  = (DWORD)strlen(filename) + 1;
+    size_t          length      = RECORD_LENGTH(nameLength, n);
+    WRITER_LANE     *lane;
+    WRITER_BATCH    *batch;
+    WRITER_RECORD   *record;
+
+    if(n > WRITER_SMALL_FILE || length > WRITER_BATCH_SIZE - BATCH_HEADER)
+        return FALSE;
+
+    lane = PickLane(writer, filename);
+
+    EnterCriticalSection(&writer->lock);
+
+    if(lane->current != NULL && lane->current->used + length > lane->current->size - BATCH_HEADER)
+        SubmitBatch(writer, lane);
+
+    if(lane->current == NULL) {
+        size_t size;
+
+        if((batch = (WRITER_BATCH *)LeaseBuffer(WRITER_BATCH_SIZE, &size)) == NULL) {
+            LeaveCriticalSection(&writer->lock);
+            return FALSE;
+        }
+
+        batch->size         = size;
+        batch->used         = 0;
+        batch->numOfFiles   = 0;
+        lane->current       = batch;
+    }
+
+    batch   = lane->current;
+    record  = (WRITER_RECORD *)(BATCH_RECORDS(batch) + batch->used);
+
+    record->size        = n;
+    record->nameLength  = nameLength;
+    record->failed      = failed;
+    memcpy((char *)record + sizeof(WRITER_RECORD), filename, nameLength);
+    memcpy((char *)record + sizeof(WRITER_RECORD) + nameLength, buf, n);
+
+    batch->used += length;
+    ++batch->numOfFiles;
+    ++writer->files;
+
+    LeaveCriticalSection(&writer->lock);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Waits until every file queued for the thread of 'filename' is written,
+ * so that the file can be written directly without being overwritten by an
+ * older entry of the same name.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  filename        Name of the file inside the archive
+ *--------------------------------------------------------------------------*/
+void WaitForFileWriter(FILE_WRITER *writer, const char *filename) {
+    WRITER_LANE *lane = PickLane(writer, filename);
+
+    EnterCriticalSection(&writer->lock);
+
+    if(lane->current != NULL)
+        SubmitBatch(writer, lane);
+
+    LeaveCriticalSection(&writer->lock);
+
+    WaitForSingleObject(lane->hIdle, INFINITE);
+}
+
+/*----------------------------------------------------------------------------
+ * Waits until every queued file is written.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void FlushFileWriter(FILE_WRITER *writer) {
+    DWORD i;
+
+    /* Hand everything over first, so the threads work at the same time */
+    EnterCriticalSection(&writer->lock);
+
+    for(i = 0; i < writer->numOfThreads; ++i) {
+        if(writer->lanes[i].current != NULL)
+            SubmitBatch(writer, &writer->lanes[i]);
+    }
+
+    LeaveCriticalSection(&writer->lock);
+
+    for(i = 0; i < writer->numOfThreads; ++i)
+        WaitForSingleObject(writer->lanes[i].hIdle, INFINITE);
+}
+
+/*----------------------------------------------------------------------------
+ * Prints the name of every queued file that could not be written since the
+ * last call to stderr. Call it after FlushFileWriter.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *
+ *  Returns the number of names printed.
+ *--------------------------------------------------------------------------*/
+DWORD PrintFailedFiles(FILE_WRITER *writer) {
+    const char  *name;
+    DWORD       count;
+    DWORD       i;
+
+    EnterCriticalSection(&writer->failedLock);
+
+    name = writer->failedNames;
+
+    for(i = 0; i < writer->numOfFailedNames; ++i) {
+        fprintf(stderr, "Could not extract %s: The file could not be written to the disk\n", name);
+        name += strlen(name) + 1;
+    }
+
+    count = writer->numOfFailedNames;
+
+    free(writer->failedNames);
+    writer->failedNames         = NULL;
+    writer->failedSize          = 0;
+    writer->numOfFailedNames    = 0;
+
+    LeaveCriticalSection(&writer->failedLock);
+
+    return count;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the writer.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void GetFileWriterStats(FILE_WRITER *writer, FILE_WRITER_STATS *stats) {
+    EnterCriticalSection(&writer->lock);
+
+    stats->threads  = writer->numOfThreads;
+    stats->files    = (DWORD)writer->files;
+    stats->batches  = (DWORD)writer->batches;
+    stats->failed   = (DWORD)writer->failed;
+
+    LeaveCriticalSection(&writer->lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Prints the counters of the writer to stderr. Does nothing if 'writer' is
+ * NULL.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void PrintFileWriterStats(FILE_WRITER *writer) {
+    FILE_WRITER_STATS stats;
+
+    if(writer == NULL)
+        return;
+
+    GetFileWriterStats(writer, &stats);
+
+    fprintf(stderr, "Writer: %u small files in %u batches on %u threads, %u failed\n",
+            stats.files, stats.batches, stats.threads, stats.failed);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes every queued file, stops the threads and frees the writer. Does
+ * nothing if 'writer' is NULL.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void StopFileWriter(FILE_WRITER *writer) {
+    DWORD i;
+
+    if(writer == NULL)
+        return;
+
+    /* The batches still being filled go first, then a NULL batch stops the thread */
+    EnterCriticalSection(&writer->lock);
+
+    for(i = 0; i < writer->numOfThreads; ++i) {
+        if(writer->lanes[i].current != NULL)
+            SubmitBatch(writer, &writer->lanes[i]);
+
+        SubmitBatch(writer, &writer->lanes[i]);
+    }
+
+    LeaveCriticalSection(&writer->lock);
+
+    for(i = 0; i < writer->numOfThreads; ++i) {
+        WRITER_LANE *lane = &writer->lanes[i];
+
+        WaitForSingleObject(lane->hThread, INFINITE);
+        CloseHandle(lane->hThread);
+        CloseHandle(lane->hQueued);
+        CloseHandle(lane->hFree);
+        CloseHandle(lane->hIdle);
+        DeleteCriticalSection(&lane->lock);
+    }
+
+    /* The files written last were never flushed */
+    PrintFailedFiles(writer);
+
+    DeleteCriticalSection(&writer->failedLock);
+    DeleteCriticalSection(&writer->lock);
+    free(writer);
+}
@@ -0,0 +1,132 @@
+/*  Description:
+ *      Writer threads for small files. Creating, writing and closing a file
+ *      of a few KB costs far more time than the data does, so the files of
+ *      archives like Scripts.dta and Missions.dta are handed to a few threads
+ *      of their own instead of being created one after the other by the
+ *      thread that reads them:
+ *
+ *          if(size <= WRITER_SMALL_FILE && QueueFile(writer, name, buf, size, &failed))
+ *              return;
+ *
+ *      Queued files are copied into batches of WRITER_BATCH_SIZE bytes, and a
+ *      full batch is handed over as a whole, so the threads only meet once
+ *      per batch. Every path always goes to the same thread, which keeps two
+ *      entries with the same name in archive order. A file a thread can't
+ *      write bumps the counter it was queued with, and PrintFailedFiles
+ *      names it once the queue is flushed.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef FILE_WRITER_H_
+#define FILE_WRITER_H_
+
+#include <windows.h>
+#include "DirCache.h"
+
+/* Files up to this size are queued, larger ones are written directly */
+#define WRITER_SMALL_FILE       (64 * 1024)
+
+/* Size of a batch of queued files */
+#define WRITER_BATCH_SIZE       (1024 * 1024)
+
+/* Full batches that may wait for each thread */
+#define WRITER_MAX_BATCHES      4
+
+/* Writer threads started for the file sink */
+#define WRITER_DEFAULT_THREADS  4
+#define WRITER_MAX_THREADS      16
+
+/*
+ * The writer threads and their queues. The members are private to
+ * FileWriter.c.
+ */
+typedef struct t_filewriter FILE_WRITER;
+
+/*
+ * Counters of the writer.
+ */
+typedef struct t_filewriterstats {
+    DWORD   threads;
+    DWORD   files;                  /* Files queued */
+    DWORD   batches;                /* Batches handed to the threads */
+    DWORD   failed;                 /* Files that could not be written */
+} FILE_WRITER_STATS;
+
+/*----------------------------------------------------------------------------
+ * Starts 'numOfThreads' writer threads. Returns NULL if they could not be
+ * started, files are then written directly.
+ *
+ *  Arguments:      dirs            Directories created so far
+ *                  numOfThreads    Number of threads
+ *                  flush           Flush every file to the disk before
+ *                                  closing it
+ *--------------------------------------------------------------------------*/
+FILE_WRITER *StartFileWriter(DIR_CACHE *dirs, DWORD numOfThreads, BOOL flush);
+
+/*----------------------------------------------------------------------------
+ * Copies a file of at most WRITER_SMALL_FILE bytes into the queue of its
+ * thread. Waits if that thread is too far behind. Returns FALSE if the file
+ * is too large, it has to be written directly then. If the thread can't
+ * write the file, 'failed' is incremented and the name is kept for
+ * PrintFailedFiles.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  filename        Name of the file inside the archive
+ *                  buf             File data
+ *                  n               Size of the file
+ *                  failed          Counter of failed files, may be NULL
+ *--------------------------------------------------------------------------*/
+BOOL QueueFile(FILE_WRITER *writer, const char *filename, const void *buf, DWORD n, LONG volatile *failed);
+
+/*----------------------------------------------------------------------------
+ * Waits until every file queued for the thread of 'filename' is written,
+ * so that the file can be written directly without being overwritten by an
+ * older entry of the same name.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  filename        Name of the file inside the archive
+ *--------------------------------------------------------------------------*/
+void WaitForFileWriter(FILE_WRITER *writer, const char *filename);
+
+/*----------------------------------------------------------------------------
+ * Waits until every queued file is written.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void FlushFileWriter(FILE_WRITER *writer);
+
+/*----------------------------------------------------------------------------
+ * Prints the name of every queued file that could not be written since the
+ * last call to stderr. Call it after FlushFileWriter.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *
+ *  Returns the number of names printed.
+ *--------------------------------------------------------------------------*/
+DWORD PrintFailedFiles(FILE_WRITER *writer);
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the writer.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *                  stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void GetFileWriterStats(FILE_WRITER *writer, FILE_WRITER_STATS *stats);
+
+/*----------------------------------------------------------------------------
+ * Prints the counters of the writer to stderr. Does nothing if 'writer' is
+ * NULL.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void PrintFileWriterStats(FILE_WRITER *writer);
+
+/*----------------------------------------------------------------------------
+ * Writes every queued file, stops the threads and frees the writer. Does
+ * nothing if 'writer' is NULL.
+ *
+ *  Arguments:      writer          Writer from StartFileWriter
+ *--------------------------------------------------------------------------*/
+void StopFileWriter(FILE_WRITER *writer);
+
+#endif
@@ -0,0 +1,82 @@
+/*  Description:
+ *      Implementation of the wildcard matching. Stars are matched by trying
+ *      every possible length, which is plenty for paths of at most 255
+ *      characters.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <string.h>
+#include <ctype.h>
+#include "Glob.h"
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'c' separates directories in a pattern.
+ *--------------------------------------------------------------------------*/
+static BOOL IsSeparator(char c) {
+    return c == '\\' || c == '/';
+}
+
+/*----------------------------------------------------------------------------
+ * Matches the rest of 'pattern' against the rest of 'name'.
+ *--------------------------------------------------------------------------*/
+static BOOL MatchFrom(const char *pattern, const char *name) {
+    for(; *pattern != '\0'; ++pattern, ++name) {
+        if(*pattern == '*') {
+            BOOL deep = pattern[1] == '*';
+
+            if(deep)
+                ++pattern;
+
+            /* "**\" may also match no directory at all */
+            if(deep && IsSeparator(pattern[1]) && MatchFrom(pattern + 2, name))
+                return TRUE;
+
+            for(;;) {
+                if(MatchFrom(pattern + 1, name))
+                    return TRUE;
+
+                if(*name == '\0' || (!deep && *name == '\\'))
+                    return FALSE;
+
+                ++name;
+            }
+        }
+
+        if(*name == '\0')
+            return FALSE;
+
+        if(*pattern == '?') {
+            if(*name == '\\')
+                return FALSE;
+        } else if(IsSeparator(*pattern)) {
+            if(*name != '\\')
+                return FALSE;
+        } else if(tolower((unsigned char)*pattern) != tolower((unsigned char)*name))
+            return FALSE;
+    }
+
+    return *name == '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'name' matches 'pattern'.
+ *
+ *  Arguments:      pattern         Wildcard pattern
+ *                  name            Path inside the archive
+ *--------------------------------------------------------------------------*/
+BOOL MatchGlob(const char *pattern, const char *name) {
+    const char *separator;
+
+    /* Archive names sometimes start with a backslash */
+    while(*name == '\\')
+        ++name;
+
+    while(IsSeparator(*pattern))
+        ++pattern;
+
+    if(strpbrk(pattern, "\\/") == NULL && (separator = strrchr(name, '\\')) != NULL)
+        name = separator + 1;
+
+    return MatchFrom(pattern, name);
+}
@@ -0,0 +1,27 @@
+/*  Description:
+ *      Wildcard matching for the --include and --exclude options. Matching
+ *      ignores case, and '/' in a pattern stands for '\'.
+ *
+ *          ?       Any single character except '\'
+ *          *       Any run of characters except '\'
+ *          **      Any run of characters, '\' included
+ *
+ *      A pattern without any separator is matched against the file name
+ *      alone, so "*.wav" finds every .wav file in every directory.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef GLOB_H_
+#define GLOB_H_
+
+#include <windows.h>
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'name' matches 'pattern'.
+ *
+ *  Arguments:      pattern         Wildcard pattern
+ *                  name            Path inside the archive
+ *--------------------------------------------------------------------------*/
+BOOL MatchGlob(const char *pattern, const char *name);
+
+#endif
@@ -0,0 +1,190 @@
+/*  Description:
+ *      Implementation of XXH64. Input is consumed in stripes of 32 bytes by
+ *      four accumulators; what is left at the end is mixed in 8, 4 and 1
+ *      bytes at a time.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <string.h>
+#include "Hash.h"
+
+#define PRIME64_1   ((unsigned __int64)0x9E3779B185EBCA87)
+#define PRIME64_2   ((unsigned __int64)0xC2B2AE3D27D4EB4F)
+#define PRIME64_3   ((unsigned __int64)0x165667B19E3779F9)
+#define PRIME64_4   ((unsigned __int64)0x85EBCA77C2B2AE63)
+#define PRIME64_5   ((unsigned __int64)0x27D4EB2F165667C5)
+
+#define ROTL64(x, r)    (((x) << (r)) | ((x) >> (64 - (r))))
+
+/*----------------------------------------------------------------------------
+ * Reads little endian values, the input may be unaligned.
+ *--------------------------------------------------------------------------*/
+static unsigned __int64 Read64(const unsigned char *p) {
+    unsigned __int64 value;
+
+    memcpy(&value, p, sizeof(value));
+
+    return value;
+}
+
+static unsigned int Read32(const unsigned char *p) {
+    unsigned int value;
+
+    memcpy(&value, p, sizeof(value));
+
+    return value;
+}
+
+/*----------------------------------------------------------------------------
+ * Mixes 8 bytes into an accumulator.
+ *--------------------------------------------------------------------------*/
+static unsigned __int64 Round(unsigned __int64 acc, unsigned __int64 input) {
+    acc += input * PRIME64_2;
+    acc  = ROTL64(acc, 31);
+
+    return acc * PRIME64_1;
+}
+
+/*----------------------------------------------------------------------------
+ * Folds an accumulator into the hash.
+ *--------------------------------------------------------------------------*/
+static unsigned __int64 MergeRound(unsigned __int64 acc, unsigned __int64 value) {
+    acc ^= Round(0, value);
+
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+/*----------------------------------------------------------------------------
+ * Consumes whole stripes of 'data' and returns the bytes used.
+ *--------------------------------------------------------------------------*/
+static size_t ConsumeStripes(HASH64_STATE *state, const unsigned char *data, size_t n) {
+    const unsigned char *p = data;
+
+    while(n - (size_t)(p - data) >= 32) {
+        state->v[0] = Round(state->v[0], Read64(p));
+        state->v[1] = Round(state->v[1], Read64(p + 8));
+        state->v[2] = Round(state->v[2], Read64(p + 16));
+        state->v[3] = Round(state->v[3], Read64(p + 24));
+        p += 32;
+    }
+
+    return (size_t)(p - data);
+}
+
+/*----------------------------------------------------------------------------
+ * Starts a new hash.
+ *
+ *  Arguments:          state           State to initialize
+ *                      seed            Seed of the hash, usually 0
+ *--------------------------------------------------------------------------*/
+void InitHash64(HASH64_STATE *state, unsigned __int64 seed) {
+    memset(state, 0, sizeof(HASH64_STATE));
+
+    state->seed = seed;
+    state->v[0] = seed + PRIME64_1 + PRIME64_2;
+    state->v[1] = seed + PRIME64_2;
+    state->v[2] = seed;
+    state->v[3] = seed - PRIME64_1;
+}
+
+/*----------------------------------------------------------------------------
+ * Feeds 'n' bytes of 'data' into the hash.
+ *
+ *  Arguments:          state           State of the hash
+ *                      data            Data to hash
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+void UpdateHash64(HASH64_STATE *state, const void *data, size_t n) {
+    const unsigned char *p = (const unsigned char *)data;
+    size_t              used;
+
+    state->totalLength += n;
+
+    /* Finish the stripe started by an earlier call first */
+    if(state->pendingSize > 0) {
+        size_t fill = min(n, 32 - state->pendingSize);
+
+        memcpy(state->pending + state->pendingSize, p, fill);
+        state->pendingSize += (DWORD)fill;
+        p += fill;
+        n -= fill;
+
+        if(state->pendingSize < 32)
+            return;
+
+        ConsumeStripes(state, state->pending, 32);
+        state->pendingSize = 0;
+    }
+
+    used = ConsumeStripes(state, p, n);
+
+    /* Keep the rest for the next call */
+    memcpy(state->pending, p + used, n - used);
+    state->pendingSize = (DWORD)(n - used);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the hash of everything fed so far. The state is not changed, so
+ * more data may still follow.
+ *
+ *  Arguments:          state           State of the hash
+ *--------------------------------------------------------------------------*/
+unsigned __int64 FinishHash64(const HASH64_STATE *state) {
+    const unsigned char *p      = state->pending;
+    const unsigned char *end    = state->pending + state->pendingSize;
+    unsigned __int64    hash;
+
+    if(state->totalLength >= 32) {
+        hash = ROTL64(state->v[0], 1) + ROTL64(state->v[1], 7) + ROTL64(state->v[2], 12) + ROTL64(state->v[3], 18);
+        hash = MergeRound(hash, state->v[0]);
+        hash = MergeRound(hash, state->v[1]);
+        hash = MergeRound(hash, state->v[2]);
+        hash = MergeRound(hash, state->v[3]);
+    } else {
+        hash = state->seed + PRIME64_5;
+    }
+
+    hash += state->totalLength;
+
+    for(; end - p >= 8; p += 8) {
+        hash ^= Round(0, Read64(p));
+        hash  = ROTL64(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+
+    if(end - p >= 4) {
+        hash ^= (unsigned __int64)Read32(p) * PRIME64_1;
+        hash  = ROTL64(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+
+    for(; p < end; ++p) {
+        hash ^= *p * PRIME64_5;
+        hash  = ROTL64(hash, 11) * PRIME64_1;
+    }
+
+    /* Avalanche */
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the hash of 'n' bytes of 'data' in one go.
+ *
+ *  Arguments:          data            Data to hash
+ *                      n               Size of data
+ *                      seed            Seed of the hash, usually 0
+ *--------------------------------------------------------------------------*/
+unsigned __int64 Hash64(const void *data, size_t n, unsigned __int64 seed) {
+    HASH64_STATE state;
+
+    InitHash64(&state, seed);
+    UpdateHash64(&state, data, n);
+
+    return FinishHash64(&state);
+}
@@ -0,0 +1,57 @@
+/*  Description:
+ *      Streaming XXH64 hash. The result is the same as the reference xxHash
+ *      implementation gives, so manifests can be checked with other tools.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <windows.h>
+
+/*
+ * State of a hash that is fed in pieces.
+ */
+typedef struct t_hash64state {
+    unsigned __int64    totalLength;
+    unsigned __int64    v[4];
+    unsigned char       pending[32];    /* Bytes that didn't fill a stripe yet */
+    DWORD               pendingSize;
+    unsigned __int64    seed;
+} HASH64_STATE;
+
+/*----------------------------------------------------------------------------
+ * Starts a new hash.
+ *
+ *  Arguments:          state           State to initialize
+ *                      seed            Seed of the hash, usually 0
+ *--------------------------------------------------------------------------*/
+void InitHash64(HASH64_STATE *state, unsigned __int64 seed);
+
+/*----------------------------------------------------------------------------
+ * Feeds 'n' bytes of 'data' into the hash.
+ *
+ *  Arguments:          state           State of the hash
+ *                      data            Data to hash
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+void UpdateHash64(HASH64_STATE *state, const void *data, size_t n);
+
+/*----------------------------------------------------------------------------
+ * Returns the hash of everything fed so far. The state is not changed, so
+ * more data may still follow.
+ *
+ *  Arguments:          state           State of the hash
+ *--------------------------------------------------------------------------*/
+unsigned __int64 FinishHash64(const HASH64_STATE *state);
+
+/*----------------------------------------------------------------------------
+ * Returns the hash of 'n' bytes of 'data' in one go.
+ *
+ *  Arguments:          data            Data to hash
+ *                      n               Size of data
+ *                      seed            Seed of the hash, usually 0
+ *--------------------------------------------------------------------------*/
+unsigned __int64 Hash64(const void *data, size_t n, unsigned __int64 seed);
+
+#endif
@@ -0,0 +1,178 @@
+/*  Description:
+ *      Implementation of the key detection. The header is decrypted for all
+ *      candidates at once, one XOR per field, and only the candidates whose
+ *      header is plausible go on to read the content table.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include "KeyDetect.h"
+
+/* Largest number of key pairs tried, the table has fewer */
+#define DETECT_MAX_CANDIDATES   64
+
+/*----------------------------------------------------------------------------
+ * Reads 'n' bytes at 'offset' of 'hFile' into 'buffer'. Returns FALSE if
+ * fewer bytes could be read.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadAt(HANDLE hFile, DWORD offset, void *buffer, DWORD n) {
+    OVERLAPPED  position;
+    DWORD       read;
+
+    memset(&position, 0, sizeof(OVERLAPPED));
+    position.Offset = offset;
+
+    return ReadFile(hFile, buffer, n, &read, &position) && read == n;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if all 'n' characters of 'name' are printable.
+ *--------------------------------------------------------------------------*/
+static BOOL IsPrintable(const char *name, DWORD n) {
+    DWORD i;
+
+    for(i = 0; i < n; ++i) {
+        if((unsigned char)name[i] < 0x20 || (unsigned char)name[i] > 0x7E)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Scores the keys 'candidate' for an archive of 'archiveSize' bytes, whose
+ * header decrypted with them is 'header'. Returns 0 if the keys can't be
+ * right.
+ *--------------------------------------------------------------------------*/
+static DWORD ScoreCandidate(HANDLE hFile, DWORD archiveSize, const DTA_HEADER *header, const ARCHIVE_KEYS *candidate) {
+    DTA_CONTENT_HEADER  table[DETECT_TABLE_ENTRIES];
+    DTA_FILE_HEADER     fileHeader;
+    char                name[256];
+    DWORD               count   = min(header->numOfFiles, DETECT_TABLE_ENTRIES);
+    DWORD               score   = 1;
+    DWORD               i;
+
+    if(!DtaIsHeaderPlausible(header, archiveSize))
+        return 0;
+
+    if(header->contentSize == header->numOfFiles * sizeof(DTA_CONTENT_HEADER))
+        ++score;
+
+    if(count == 0 || archiveSize < header->contentOffset + sizeof(DTA_FILE_HEADER) ||
+       !ReadAt(hFile, header->contentOffset, table, count * sizeof(DTA_CONTENT_HEADER)))
+        return score;
+
+    Decrypt((void *)table, count * sizeof(DTA_CONTENT_HEADER), candidate->key1, candidate->key2);
+
+    /* Every entry has to start inside the archive */
+    for(i = 0; i < count; ++i) {
+        if(table[i].fileOffset < sizeof(int) + sizeof(DTA_HEADER) || table[i].fileOffset > archiveSize - sizeof(DTA_FILE_HEADER))
+            return score;
+    }
+
+    score += 2;
+
+    if(!ReadAt(hFile, table[0].fileOffset, &fileHeader, sizeof(DTA_FILE_HEADER)))
+        return score;
+
+    Decrypt((void *)&fileHeader, sizeof(DTA_FILE_HEADER), candidate->key1, candidate->key2);
+
+    /* And the first one has to have a name */
+    if(DTA_FILENAME_LENGTH(&fileHeader) == 0 || DTA_FILENAME_LENGTH(&fileHeader) > sizeof(name) ||
+       !ReadAt(hFile, table[0].fileOffset + sizeof(DTA_FILE_HEADER), name, DTA_FILENAME_LENGTH(&fileHeader)))
+        return score;
+
+    Decrypt((void *)name, DTA_FILENAME_LENGTH(&fileHeader), candidate->key1, candidate->key2);
+
+    if(IsPrintable(name, DTA_FILENAME_LENGTH(&fileHeader)))
+        score += 4;
+
+    return score;
+}
+
+/*----------------------------------------------------------------------------
+ * Finds the pair of the key table that decrypts 'filename'. If several
+ * pairs score the same, the one listed under the archive's own name is
+ * preferred. If no pair fits, 'error' string is set and the function
+ * returns NULL.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  error           Error string
+ *
+ *  Returns the matching entry of the key table, NULL otherwise.
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *DetectArchiveKeys(const char *filename, char error[ERROR_LENGTH]) {
+    const ARCHIVE_KEYS  *candidates;
+    const ARCHIVE_KEYS  *named  = FindArchiveKeys(filename);
+    const ARCHIVE_KEYS  *best   = NULL;
+    DTA_HEADER          headers[DETECT_MAX_CANDIDATES];
+    DWORD               raw[1 + sizeof(DTA_HEADER) / sizeof(DWORD)];
+    DWORD               bestScore = 0;
+    DWORD               count;
+    DWORD               i;
+    DWORD               j;
+    HANDLE              hFile;
+    LARGE_INTEGER       size;
+
+    candidates  = GetKnownArchives(&count);
+    count       = min(count, DETECT_MAX_CANDIDATES);
+
+    hFile = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE) {
+        strncpy_s(error, ERROR_LENGTH, "Failed to open the requested .dta file", ERROR_LENGTH);
+        return NULL;
+    }
+
+    if(!GetFileSizeEx(hFile, &size) || size.QuadPart > 0xFFFFFFFF || !ReadAt(hFile, 0, raw, sizeof(raw))) {
+        strncpy_s(error, ERROR_LENGTH, "The file is too small or too large to be an archive", ERROR_LENGTH);
+        CloseHandle(hFile);
+        return NULL;
+    }
+
+    if(raw[0] != TRUE_DTA_IDENTIFIER) {
+        strncpy_s(error, ERROR_LENGTH, "File did not begin with \"ISD0\"", ERROR_LENGTH);
+        CloseHandle(hFile);
+        return NULL;
+    }
+
+    /* The pattern is key2 then key1, so every field is a single XOR */
+    for(i = 0; i < count; ++i) {
+        headers[i].numOfFiles       = raw[1] ^ candidates[i].key2;
+        headers[i].contentOffset    = raw[2] ^ candidates[i].key1;
+        headers[i].contentSize      = raw[3] ^ candidates[i].key2;
+        headers[i].extra            = raw[4] ^ candidates[i].key1;
+    }
+
+    for(i = 0; i < count; ++i) {
+        const ARCHIVE_KEYS  *match = &candidates[i];
+        DWORD               score;
+
+        /* Several archives share their keys */
+        for(j = 0; j < i; ++j) {
+            if(candidates[j].key1 == candidates[i].key1 && candidates[j].key2 == candidates[i].key2)
+                break;
+        }
+
+        if(j < i || (score = ScoreCandidate(hFile, (DWORD)size.QuadPart, &headers[i], &candidates[i])) == 0)
+            continue;
+
+        if(named != NULL && named->key1 == match->key1 && named->key2 == match->key2) {
+            match = named;
+            ++score;
+        }
+
+        if(score > bestScore) {
+            best        = match;
+            bestScore   = score;
+        }
+    }
+
+    CloseHandle(hFile);
+
+    if(best == NULL)
+        strncpy_s(error, ERROR_LENGTH, "None of the known keys fit the archive", ERROR_LENGTH);
+
+    return best;
+}
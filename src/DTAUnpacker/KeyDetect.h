@@ -0,0 +1,38 @@
+/*  Description:
+ *      Finds the keys of an archive by trial-decrypting its header with every
+ *      pair in the key table. Every candidate is scored with cheap checks:
+ *      the header has to describe a content table inside the archive, the
+ *      first entries of that table have to point inside the archive, and the
+ *      first entry has to have a printable name. The pair with the highest
+ *      score wins.
+ *
+ *      Only the 16-byte header, a few hundred bytes of the table and one
+ *      entry header are read, all into buffers on the stack, so a wrong pair
+ *      is rejected before anything is allocated.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef KEY_DETECT_H_
+#define KEY_DETECT_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "KeyTable.h"
+
+/* Number of content table entries checked for each candidate */
+#define DETECT_TABLE_ENTRIES    16
+
+/*----------------------------------------------------------------------------
+ * Finds the pair of the key table that decrypts 'filename'. If several
+ * pairs score the same, the one listed under the archive's own name is
+ * preferred. If no pair fits, 'error' string is set and the function
+ * returns NULL.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  error           Error string
+ *
+ *  Returns the matching entry of the key table, NULL otherwise.
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *DetectArchiveKeys(const char *filename, char error[ERROR_LENGTH]);
+
+#endif
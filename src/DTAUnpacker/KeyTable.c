@@ -0,0 +1,69 @@
+/*  Description:
+ *      Implementation of the key table. The table is small enough that a
+ *      lookup simply walks all of it.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <string.h>
+#include "KeyTable.h"
+
+#define GAME_HD2    "Hidden & Dangerous 2"
+#define GAME_MAFIA  "Mafia"
+
+static const ARCHIVE_KEYS knownArchives[] = {
+    { GAME_HD2,     "Maps.dta",     0xF26527FA, 0xB438D0A5 },
+    { GAME_HD2,     "Missions.dta", 0x22BCDA98, 0x7654A3F0 },
+    { GAME_HD2,     "Models.dta",   0x10ACB252, 0x5D805259 },
+    { GAME_HD2,     "Others.dta",   0x65F7AB23, 0xEA85902A },
+    { GAME_HD2,     "Sounds.dta",   0x8D2965CA, 0x4FE85106 },
+    { GAME_HD2,     "Scripts.dta",  0xCF761298, 0x0AB4E72D },
+    { GAME_MAFIA,   "A0.dta",       0xD8D0A975, 0x467ACDE0 },
+    { GAME_MAFIA,   "A1.dta",       0x3D98766C, 0xDE7009CD },
+    { GAME_MAFIA,   "A2.dta",       0x82A1C97B, 0x2D5085D4 },
+    { GAME_MAFIA,   "A3.dta",       0x43876FEA, 0x900CDBA8 },
+    { GAME_MAFIA,   "A4.dta",       0x43876FEA, 0x900CDBA8 },
+    { GAME_MAFIA,   "A5.dta",       0xDEAC5342, 0x760CE652 },
+    { GAME_MAFIA,   "A6.dta",       0x64CD8D0A, 0x4BC97B2D },
+    { GAME_MAFIA,   "A7.dta",       0xD6FEA900, 0xCDB76CE6 },
+    { GAME_MAFIA,   "A8.dta",       0xD8DD8FAC, 0x5324ACE5 },
+    { GAME_MAFIA,   "A9.dta",       0x6FEE6324, 0xACDA4783 },
+    { GAME_MAFIA,   "AA.dta",       0x5342760C, 0xEDEAC652 },
+    { GAME_MAFIA,   "AB.dta",       0xD8D0A975, 0x467ACDE0 },
+    { GAME_MAFIA,   "AC.dta",       0x43876FEA, 0x900CDBA8 }
+};
+
+/*----------------------------------------------------------------------------
+ * Returns the table of known archives, grouped by game, and stores the
+ * number of entries in 'count'.
+ *
+ *  Arguments:      count           Receives the number of entries
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *GetKnownArchives(DWORD *count) {
+    *count = sizeof(knownArchives) / sizeof(knownArchives[0]);
+
+    return knownArchives;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the keys of the archive 'filename', or NULL if it isn't known.
+ *
+ *  Arguments:      filename        Path of the archive
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *FindArchiveKeys(const char *filename) {
+    const char  *name = filename;
+    const char  *c;
+    DWORD       i;
+
+    for(c = filename; *c != '\0'; ++c) {
+        if(*c == '\\' || *c == '/' || *c == ':')
+            name = c + 1;
+    }
+
+    for(i = 0; i < sizeof(knownArchives) / sizeof(knownArchives[0]); ++i) {
+        if(_stricmp(name, knownArchives[i].archive) == 0)
+            return &knownArchives[i];
+    }
+
+    return NULL;
+}
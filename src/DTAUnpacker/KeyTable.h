@@ -0,0 +1,38 @@
+/*  Description:
+ *      The decryption keys of every archive shipped with Hidden & Dangerous 2
+ *      and Mafia, looked up by archive name. Names are compared without
+ *      regard to case, and only the file name part of a path is used.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef KEY_TABLE_H_
+#define KEY_TABLE_H_
+
+#include <windows.h>
+
+/*
+ * A known archive and its keys.
+ */
+typedef struct t_archivekeys {
+    const char      *game;
+    const char      *archive;
+    unsigned int    key1;
+    unsigned int    key2;
+} ARCHIVE_KEYS;
+
+/*----------------------------------------------------------------------------
+ * Returns the table of known archives, grouped by game, and stores the
+ * number of entries in 'count'.
+ *
+ *  Arguments:      count           Receives the number of entries
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *GetKnownArchives(DWORD *count);
+
+/*----------------------------------------------------------------------------
+ * Returns the keys of the archive 'filename', or NULL if it isn't known.
+ *
+ *  Arguments:      filename        Path of the archive
+ *--------------------------------------------------------------------------*/
+const ARCHIVE_KEYS *FindArchiveKeys(const char *filename);
+
+#endif
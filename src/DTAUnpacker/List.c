@@ -0,0 +1,99 @@
+/*  Description:
+ *      Implementation of the listing. The entries are walked in archive order
+ *      through libdta, which read them when the archive was opened, and only
+ *      the file header of a listed entry is read again for its unknown fields.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include "List.h"
+#include "EntryIndex.h"
+
+/*----------------------------------------------------------------------------
+ * Prints 'name' as a JSON string. Archive names aren't UTF-8, so bytes
+ * above 127 are written as the code points of the same value.
+ *--------------------------------------------------------------------------*/
+static void PrintJsonString(const char *name) {
+    const unsigned char *c;
+
+    putchar('"');
+
+    for(c = (const unsigned char *)name; *c != '\0'; ++c) {
+        if(*c == '"' || *c == '\\')
+            printf("\\%c", *c);
+        else if(*c < 0x20 || *c > 0x7E)
+            printf("\\u%04x", *c);
+        else
+            putchar(*c);
+    }
+
+    putchar('"');
+}
+
+/*----------------------------------------------------------------------------
+ * Prints a single entry in the format of 'data->listFormat'.
+ *--------------------------------------------------------------------------*/
+static void PrintEntry(const APP_DATA *data, const DTA_FILE_HEADER *fileHeader, const DTA_ENTRY_INFO *info, BOOL first) {
+    char    extra6[sizeof(fileHeader->extra6) * 2 + 1];
+    DWORD   i;
+
+    for(i = 0; i < sizeof(fileHeader->extra6); ++i)
+        sprintf(extra6 + i * 2, "%02x", (unsigned char)fileHeader->extra6[i]);
+
+    if(data->listFormat == LIST_JSON) {
+        printf("%s\n  {\"name\": ", first ? "" : ",");
+        PrintJsonString(info->name);
+        printf(", \"fileSize\": %u, \"dataOffset\": %u, \"headerOffset\": %u, \"blocks\": %u, \"encrypted\": %s, "
+               "\"extra1\": %u, \"extra2\": %u, \"extra3\": %u, \"extra4\": %u, \"extra6\": \"%s\"}",
+               info->fileSize, info->dataOffset, info->fileOffset, info->numOfBlocks, info->encrypted ? "true" : "false",
+               fileHeader->extra1, fileHeader->extra2, fileHeader->extra3, fileHeader->extra4, extra6);
+    } else {
+        printf("%10u %10u %6u %-3s %08X %08X %08X %08X %s %s\n",
+               info->fileSize, info->dataOffset, info->numOfBlocks, info->encrypted ? "yes" : "no",
+               fileHeader->extra1, fileHeader->extra2, fileHeader->extra3, fileHeader->extra4, extra6, info->name);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Prints every entry matching the --include and --exclude patterns to
+ * stdout, in archive order and in the format set in --list. If any errors
+ * occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to list
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ListDTAFiles(ARCHIVE_JOB *job, char error[ERROR_LENGTH]) {
+    APP_DATA        *data   = job->data;
+    DTA_ITERATOR    iterator;
+    DTA_ENTRY_INFO  info;
+    DWORD           listed  = 0;
+
+    if(data->listFormat == LIST_JSON)
+        printf("[");
+    else
+        printf("%10s %10s %6s %-3s %-8s %-8s %-8s %-8s %-12s %s\n",
+               "size", "offset", "blocks", "enc", "extra1", "extra2", "extra3", "extra4", "extra6", "name");
+
+    DtaBeginEntries(job->archive, &iterator);
+
+    while(DtaNextEntry(&iterator, &info)) {
+        DTA_FILE_HEADER fileHeader;
+
+        if(!IsEntrySelected(data, info.name))
+            continue;
+
+        /* Skip what can't be read, like extraction does */
+        if(!DtaGetFileHeader(job->archive, &info, &fileHeader))
+            continue;
+
+        PrintEntry(data, &fileHeader, &info, listed++ == 0);
+    }
+
+    if(data->listFormat == LIST_JSON)
+        printf("%s]\n", listed ? "\n" : "");
+
+    return TRUE;
+}
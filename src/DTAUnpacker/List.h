@@ -0,0 +1,31 @@
+/*  Description:
+ *      Listing of the entries inside an archive. Only the entries libdta read
+ *      when the archive was opened and the header of every listed entry are
+ *      used; the file data is never touched.
+ *
+ *      Text output has one line per entry, JSON output is an array with one
+ *      object per entry. Besides the sizes and offsets, the number of blocks
+ *      and whether they are encrypted are printed, and the unknown fields of
+ *      DTA_FILE_HEADER are included as they are, extra6 as a hex string.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef LIST_H_
+#define LIST_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+
+/*----------------------------------------------------------------------------
+ * Prints every entry matching the --include and --exclude patterns to
+ * stdout, in archive order and in the format set in --list. If any errors
+ * occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive to list
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ListDTAFiles(ARCHIVE_JOB *job, char error[ERROR_LENGTH]);
+
+#endif
@@ -0,0 +1,563 @@
+/*  Description:
+ *      Implementation of the extraction manifest. The manifest of the last
+ *      run is read into memory as a whole; the new one is written to a
+ *      temporary file first and renamed over the old one, like the .dtaidx
+ *      sidecar.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "Manifest.h"
+#include "Hash.h"
+#include "DirCache.h"
+#include "FileWriter.h"
+
+/* Piece of an output file read at once when it has to be hashed */
+#define MANIFEST_READ_SIZE  (1024 * 1024)
+
+/*----------------------------------------------------------------------------
+ * qsort/bsearch callback, orders manifest entries by data offset.
+ *--------------------------------------------------------------------------*/
+static int CompareDataOffsets(const void *a, const void *b) {
+    DWORD left  = ((const MANIFEST_ENTRY *)a)->dataOffset;
+    DWORD right = ((const MANIFEST_ENTRY *)b)->dataOffset;
+
+    return left < right ? -1 : left > right;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the name of the manifest into 'path'. The manifest goes into the
+ * current directory, where the files are extracted to. Returns FALSE if the
+ * name doesn't fit.
+ *--------------------------------------------------------------------------*/
+static BOOL GetManifestName(ARCHIVE_JOB *job, char *path, size_t size, const char *suffix) {
+    const char  *name = job->dtaFile;
+    const char  *c;
+    int         length;
+
+    for(c = job->dtaFile; *c != '\0'; ++c) {
+        if(*c == '\\' || *c == '/' || *c == ':')
+            name = c + 1;
+    }
+
+    length = _snprintf(path, size - 1, "%s%s%s", name, MANIFEST_EXTENSION, suffix);
+    path[size - 1] = '\0';
+
+    return length >= 0 && (size_t)length < size - 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills the part of 'header' that identifies the archive and its keys.
+ * Returns FALSE if the archive can't be queried.
+ *--------------------------------------------------------------------------*/
+static BOOL GetArchiveKey(ARCHIVE_JOB *job, MANIFEST_HEADER *header) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    if(!GetFileAttributesEx(job->dtaFile, GetFileExInfoStandard, &attributes))
+        return FALSE;
+
+    memset(header, 0, sizeof(MANIFEST_HEADER));
+
+    header->identifier      = MANIFEST_IDENTIFIER;
+    header->version         = MANIFEST_VERSION;
+    header->archiveSizeLow  = attributes.nFileSizeLow;
+    header->archiveSizeHigh = attributes.nFileSizeHigh;
+    header->archiveTime     = attributes.ftLastWriteTime;
+    header->key1            = job->key1;
+    header->key2            = job->key2;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the checksum of the entries and names following a header.
+ *--------------------------------------------------------------------------*/
+static DWORD GetChecksum(const MANIFEST_ENTRY *entries, DWORD count, const char *names, DWORD namesSize) {
+    HASH64_STATE state;
+
+    InitHash64(&state, 0);
+    UpdateHash64(&state, entries, sizeof(MANIFEST_ENTRY) * count);
+    UpdateHash64(&state, names, namesSize);
+
+    return (DWORD)FinishHash64(&state);
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the manifest of the last run into 'manifest'. Returns FALSE if
+ * there is none, or it was made with other keys.
+ *--------------------------------------------------------------------------*/
+static BOOL LoadManifest(ARCHIVE_JOB *job, MANIFEST *manifest) {
+    MANIFEST_HEADER key;
+    MANIFEST_HEADER *header;
+    char            path[MAX_PATH];
+    char            *file;
+    HANDLE          hFile;
+    LARGE_INTEGER   size;
+    DWORD           read;
+    DWORD           i;
+
+    if(!GetArchiveKey(job, &key) || !GetManifestName(job, path, sizeof(path), ""))
+        return FALSE;
+
+    hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if(!GetFileSizeEx(hFile, &size) || size.QuadPart < sizeof(MANIFEST_HEADER) || size.QuadPart > 0x7FFFFFFF ||
+       (file = (char *)malloc((size_t)size.QuadPart)) == NULL) {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    if(!ReadFile(hFile, file, (DWORD)size.QuadPart, &read, NULL) || read != (DWORD)size.QuadPart) {
+        CloseHandle(hFile);
+        free(file);
+        return FALSE;
+    }
+
+    CloseHandle(hFile);
+    header = (MANIFEST_HEADER *)file;
+
+    /* The archive may have changed since, its entries are compared one by one */
+    if(header->identifier != key.identifier || header->version != key.version ||
+       header->key1 != key.key1 || header->key2 != key.key2 ||
+       size.QuadPart != sizeof(MANIFEST_HEADER) + (__int64)header->count * sizeof(MANIFEST_ENTRY) + header->namesSize) {
+        free(file);
+        return FALSE;
+    }
+
+    manifest->file      = file;
+    manifest->entries   = (MANIFEST_ENTRY *)(file + sizeof(MANIFEST_HEADER));
+    manifest->names     = file + sizeof(MANIFEST_HEADER) + sizeof(MANIFEST_ENTRY) * header->count;
+    manifest->count     = header->count;
+    manifest->namesSize = header->namesSize;
+
+    /* Everything up to 'count' is the same, so is the data of every entry */
+    manifest->sameArchive = memcmp(header, &key, offsetof(MANIFEST_HEADER, count)) == 0;
+
+    /* Never hand out a name that runs past the end of the pool */
+    if(GetChecksum(manifest->entries, manifest->count, manifest->names, manifest->namesSize) != header->checksum ||
+       (manifest->namesSize > 0 && manifest->names[manifest->namesSize - 1] != '\0')) {
+        ReleaseManifest(job, manifest);
+        return FALSE;
+    }
+
+    for(i = 0; i < manifest->count; ++i) {
+        if(manifest->entries[i].nameOffset >= manifest->namesSize) {
+            ReleaseManifest(job, manifest);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the entry of the last run with the data offset and name of the
+ * entry at position 'entry', or NULL if there is none.
+ *--------------------------------------------------------------------------*/
+static MANIFEST_ENTRY *FindEntry(MANIFEST *manifest, ENTRY_INDEX *index, DWORD entry) {
+    DWORD           dataOffset = index->dataOffsets[entry];
+    MANIFEST_ENTRY  key;
+    MANIFEST_ENTRY  *found;
+
+    if(manifest->count == 0)
+        return NULL;
+
+    key.dataOffset  = dataOffset;
+    found           = (MANIFEST_ENTRY *)bsearch(&key, manifest->entries, manifest->count, sizeof(MANIFEST_ENTRY), CompareDataOffsets);
+
+    if(found == NULL)
+        return NULL;
+
+    /* Several names may share the same data */
+    while(found > manifest->entries && found[-1].dataOffset == dataOffset)
+        --found;
+
+    for(; found < manifest->entries + manifest->count && found->dataOffset == dataOffset; ++found) {
+        if(strcmp(manifest->names + found->nameOffset, ENTRY_NAME(index, entry)) == 0)
+            return found;
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the name of the output file of 'filename' into 'path', cleaned up
+ * the way CreateOutputFile does it.
+ *--------------------------------------------------------------------------*/
+static void GetOutputName(const char *filename, char path[256 + 1]) {
+    strncpy_s(path, 256 + 1, filename, _TRUNCATE);
+    NormalizePath(path);
+}
+
+/*----------------------------------------------------------------------------
+ * Stores the XXH64 of the file at 'path' in 'hash'. Returns FALSE if the
+ * file can't be read.
+ *--------------------------------------------------------------------------*/
+static BOOL HashOutputFile(const char *path, unsigned __int64 *hash) {
+    HASH64_STATE    state;
+    char            *buffer;
+    HANDLE          hFile;
+    DWORD           read;
+    BOOL            result;
+
+    hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if((buffer = (char *)malloc(MANIFEST_READ_SIZE)) == NULL) {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    InitHash64(&state, 0);
+
+    while((result = ReadFile(hFile, buffer, MANIFEST_READ_SIZE, &read, NULL)) && read > 0)
+        UpdateHash64(&state, buffer, read);
+
+    free(buffer);
+    CloseHandle(hFile);
+
+    *hash = FinishHash64(&state);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Stores the XXH64 of the stored bytes of the entry at position 'entry' in
+ * 'hash', read through 'buffer' of MANIFEST_READ_SIZE bytes. Returns FALSE
+ * if the archive ends before them.
+ *--------------------------------------------------------------------------*/
+static BOOL HashStoredData(ENTRY_INDEX *index, DWORD entry, char *buffer, unsigned __int64 *hash) {
+    HASH64_STATE    state;
+    DWORD           offset  = index->dataOffsets[entry];
+    DWORD           left    = index->storedSizes[entry];
+
+    InitHash64(&state, 0);
+
+    while(left > 0) {
+        DWORD size = min(left, MANIFEST_READ_SIZE);
+        DWORD read = DtaReadRaw(index->archive, offset, buffer, size);
+
+        if(read < size)
+            return FALSE;
+
+        UpdateHash64(&state, buffer, read);
+
+        offset  += read;
+        left    -= read;
+    }
+
+    *hash = FinishHash64(&state);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if the entry at position 'entry' still has the size and
+ * blocks 'record' was made from. Unless the whole archive is unchanged, its
+ * stored bytes are hashed and compared too.
+ *--------------------------------------------------------------------------*/
+static BOOL IsEntryUnchanged(MANIFEST *manifest, ENTRY_INDEX *index, DWORD entry, const MANIFEST_ENTRY *record, char *buffer) {
+    DTA_ENTRY_INFO      info;
+    unsigned __int64    hash;
+
+    GetEntryInfo(index, entry, &info);
+
+    if(record->fileSize != info.fileSize || record->storedSize != info.storedSize ||
+       record->numOfBlocks != info.numOfBlocks || record->encrypted != (DWORD)(info.encrypted != FALSE))
+        return FALSE;
+
+    if(manifest->sameArchive)
+        return TRUE;
+
+    return HashStoredData(index, entry, buffer, &hash) && hash == record->storedHash;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if the output file of 'record' is still the one that was
+ * written. A file that only got a new time but has the right hash counts as
+ * intact, and its new time is stored in 'record'. Without a hash nothing
+ * proves the file was ever complete, so it is extracted again.
+ *--------------------------------------------------------------------------*/
+static BOOL IsOutputIntact(const char *filename, MANIFEST_ENTRY *record) {
+    WIN32_FILE_ATTRIBUTE_DATA   attributes;
+    char                        path[256 + 1];
+    unsigned __int64            hash;
+
+    if(!(record->flags & MANIFEST_HASHED))
+        return FALSE;
+
+    GetOutputName(filename, path);
+
+    if(!GetFileAttributesEx(path, GetFileExInfoStandard, &attributes) ||
+       (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ||
+       attributes.nFileSizeHigh != 0 || attributes.nFileSizeLow != record->fileSize)
+        return FALSE;
+
+    if(CompareFileTime(&attributes.ftLastWriteTime, &record->outputTime) == 0)
+        return TRUE;
+
+    if(!HashOutputFile(path, &hash) || hash != record->hash)
+        return FALSE;
+
+    record->outputTime = attributes.ftLastWriteTime;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Loads the manifest of the last run, if it belongs to the same archive and
+ * keys, and removes every entry from 'index' that doesn't have to be
+ * extracted again. 'job->manifest' is pointed at 'manifest', so that the
+ * writers can record the hashes. If any errors occur, 'error' string is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Selected entries, sorted by file offset
+ *                  manifest        Manifest to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SkipUnchangedEntries(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest, char error[ERROR_LENGTH]) {
+    char    *buffer = NULL;
+    DWORD   kept    = 0;
+    DWORD   i;
+
+    memset(manifest, 0, sizeof(MANIFEST));
+
+    /* Without a usable manifest everything is extracted */
+    LoadManifest(job, manifest);
+
+    manifest->records = (MANIFEST_ENTRY *)calloc(index->count + 1, sizeof(MANIFEST_ENTRY));
+
+    /* The stored bytes are only read if the archive changed */
+    if(manifest->records == NULL || (manifest->count > 0 && !manifest->sameArchive &&
+                                     (buffer = (char *)malloc(MANIFEST_READ_SIZE)) == NULL)) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the manifest", ERROR_LENGTH);
+        ReleaseManifest(job, manifest);
+        return FALSE;
+    }
+
+    for(i = 0; i < index->count; ++i) {
+        MANIFEST_ENTRY  *old    = FindEntry(manifest, index, i);
+        MANIFEST_ENTRY  *record;
+
+        if(old != NULL) {
+            if(IsEntryUnchanged(manifest, index, i, old, buffer) && IsOutputIntact(ENTRY_NAME(index, i), old))
+                continue;
+
+            old->flags |= MANIFEST_STALE;
+        }
+
+        record              = &manifest->records[kept];
+        record->fileSize    = index->fileSizes[i];
+        record->dataOffset  = index->dataOffsets[i];
+        record->nameOffset  = index->nameOffsets[i];
+
+        MoveEntry(index, kept++, i);
+    }
+
+    free(buffer);
+
+    index->count            = kept;
+    manifest->numOfRecords  = kept;
+    job->manifest           = manifest;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns where the hash of 'entry' goes in 'job->manifest', or NULL if
+ * there is no manifest. The record is marked as hashed, so the caller has
+ * to store the hash of everything it writes there.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  entry           Position of the entry in that index
+ *--------------------------------------------------------------------------*/
+unsigned __int64 *GetManifestHash(ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD entry) {
+    MANIFEST_ENTRY *record;
+
+    if(job->manifest == NULL)
+        return NULL;
+
+    record          = &job->manifest->records[entry];
+    record->flags  |= MANIFEST_HASHED;
+
+    return &record->hash;
+}
+
+/*----------------------------------------------------------------------------
+ * Marks 'entry' as written completely. Only marked entries are saved, so
+ * the writers call this once the whole file is on the disk. Does nothing if
+ * there is no manifest.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  entry           Position of the entry in that index
+ *--------------------------------------------------------------------------*/
+void SetManifestWritten(ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD entry) {
+    if(job->manifest != NULL)
+        job->manifest->records[entry].flags |= MANIFEST_WRITTEN;
+}
+
+/*----------------------------------------------------------------------------
+ * Appends 'record' with the name 'name' to the entries and names being
+ * saved.
+ *--------------------------------------------------------------------------*/
+static void AddEntry(MANIFEST_ENTRY *entries, DWORD *count, char *names, DWORD *namesSize, const MANIFEST_ENTRY *record, const char *name) {
+    size_t length = strlen(name) + 1;
+
+    entries[*count]             = *record;
+    entries[*count].nameOffset  = *namesSize;
+    entries[*count].flags      &= MANIFEST_HASHED;
+
+    memcpy(names + *namesSize, name, length);
+
+    *namesSize += (DWORD)length;
+    ++*count;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the manifest of this run: the entries of the last run that weren't
+ * extracted again, and every file marked by SetManifestWritten whose output
+ * still has its size and whose stored bytes can be hashed. Failing to write it is not an error, the next run
+ * simply extracts everything.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  manifest        Manifest filled by SkipUnchangedEntries
+ *
+ *  Returns TRUE if the manifest was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SaveManifest(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest) {
+    MANIFEST_HEADER header;
+    MANIFEST_ENTRY  *entries;
+    char            *names;
+    char            path[MAX_PATH];
+    char            tempPath[MAX_PATH];
+    char            *buffer;
+    HANDLE          hFile;
+    DWORD           written;
+    DWORD           i;
+    BOOL            result;
+    BOOL            queueFailed = FALSE;
+
+    if(!GetArchiveKey(job, &header) ||
+       !GetManifestName(job, path, sizeof(path), "") ||
+       !GetManifestName(job, tempPath, sizeof(tempPath), ".tmp"))
+        return FALSE;
+
+    entries = (MANIFEST_ENTRY *)malloc(sizeof(MANIFEST_ENTRY) * (manifest->count + manifest->numOfRecords) + 1);
+    names   = (char *)malloc(manifest->namesSize + index->namesSize + 1);
+    buffer  = (char *)malloc(MANIFEST_READ_SIZE);
+
+    if(entries == NULL || names == NULL || buffer == NULL) {
+        free(entries);
+        free(names);
+        free(buffer);
+        return FALSE;
+    }
+
+    for(i = 0; i < manifest->count; ++i) {
+        if(!(manifest->entries[i].flags & MANIFEST_STALE))
+            AddEntry(entries, &header.count, names, &header.namesSize, &manifest->entries[i], manifest->names + manifest->entries[i].nameOffset);
+    }
+
+    /* Queued files are written later; if any of them failed, none is trusted */
+    if(job->data->sink.writer != NULL) {
+        FILE_WRITER_STATS stats;
+
+        GetFileWriterStats(job->data->sink.writer, &stats);
+        queueFailed = stats.failed > 0;
+    }
+
+    for(i = 0; i < manifest->numOfRecords; ++i) {
+        WIN32_FILE_ATTRIBUTE_DATA   attributes;
+        DTA_ENTRY_INFO              info;
+        MANIFEST_ENTRY              *record = &manifest->records[i];
+        char                        output[256 + 1];
+
+        /* A file that wasn't written is tried again next time */
+        if(!(record->flags & MANIFEST_WRITTEN) || (queueFailed && record->fileSize <= WRITER_SMALL_FILE))
+            continue;
+
+        GetOutputName(ENTRY_NAME(index, i), output);
+
+        if(!GetFileAttributesEx(output, GetFileExInfoStandard, &attributes) ||
+           attributes.nFileSizeHigh != 0 || attributes.nFileSizeLow != record->fileSize)
+            continue;
+
+        /* Ranges of split files were written out of order, hash what is on the disk */
+        if(!(record->flags & MANIFEST_HASHED)) {
+            if(!HashOutputFile(output, &record->hash))
+                continue;
+
+            record->flags |= MANIFEST_HASHED;
+        }
+
+        /* The next run compares the entry with these if the archive changes */
+        if(!HashStoredData(index, i, buffer, &record->storedHash))
+            continue;
+
+        GetEntryInfo(index, i, &info);
+
+        record->storedSize  = info.storedSize;
+        record->numOfBlocks = info.numOfBlocks;
+        record->encrypted   = info.encrypted != FALSE;
+        record->outputTime  = attributes.ftLastWriteTime;
+        AddEntry(entries, &header.count, names, &header.namesSize, record, ENTRY_NAME(index, i));
+    }
+
+    free(buffer);
+
+    qsort(entries, header.count, sizeof(MANIFEST_ENTRY), CompareDataOffsets);
+    header.checksum = GetChecksum(entries, header.count, names, header.namesSize);
+
+    hFile = CreateFile(tempPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE) {
+        free(entries);
+        free(names);
+        return FALSE;
+    }
+
+    result = WriteFile(hFile, &header, sizeof(header), &written, NULL) && written == sizeof(header) &&
+             WriteFile(hFile, entries, sizeof(MANIFEST_ENTRY) * header.count, &written, NULL) &&
+             written == sizeof(MANIFEST_ENTRY) * header.count &&
+             WriteFile(hFile, names, header.namesSize, &written, NULL) && written == header.namesSize;
+
+    CloseHandle(hFile);
+    free(entries);
+    free(names);
+
+    if(!result || !MoveFileEx(tempPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFile(tempPath);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the manifest and clears 'job->manifest'.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  manifest        Manifest to release
+ *--------------------------------------------------------------------------*/
+void ReleaseManifest(ARCHIVE_JOB *job, MANIFEST *manifest) {
+    free(manifest->file);
+    free(manifest->records);
+
+    memset(manifest, 0, sizeof(MANIFEST));
+    job->manifest = NULL;
+}
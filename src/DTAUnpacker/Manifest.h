@@ -0,0 +1,165 @@
+/*  Description:
+ *      Manifest of an extraction, used by --incremental. After extracting,
+ *      "<archive>.dtamanifest" is written into the output directory with the
+ *      size, data offset, block layout and XXH64 hash of every file, the
+ *      XXH64 of its stored bytes, and the size and modification time its
+ *      output file had afterwards.
+ *
+ *      The next run skips every entry whose name, size, data offset and
+ *      block layout are the recorded ones and whose output file is still
+ *      intact. An output file is intact if its size and modification time
+ *      are the recorded ones; if only the time differs, the file is hashed
+ *      and compared. A manifest of other keys is not used at all.
+ *
+ *      If the size and modification time of the archive are the recorded
+ *      ones too, its data is trusted as it is, so an unchanged archive costs
+ *      about as much as --list. Otherwise the stored bytes of every entry
+ *      are hashed and compared as well, so only the entries that changed
+ *      inside a rewritten archive are extracted again.
+ *
+ *      The hash is taken from the decrypted data as it is written, so the
+ *      archive is never read twice. Ranges of files split across threads
+ *      can't be hashed in order; those files are hashed from the disk when
+ *      the manifest is saved. Only files that were written completely are
+ *      recorded, and a record without a hash is never trusted.
+ *
+ *      Layout of a .dtamanifest file:
+ *
+ *          MANIFEST_HEADER
+ *          MANIFEST_ENTRY[count]   Sorted by data offset
+ *          char[namesSize]         Zero-terminated names
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef MANIFEST_H_
+#define MANIFEST_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "EntryIndex.h"
+
+/* The 4-byte sequence that a .dtamanifest file begins with */
+#define MANIFEST_IDENTIFIER     (('D') + ('M' << 8) + ('A' << 16) + ('N' << 24))
+
+/* Bumped whenever MANIFEST_ENTRY or the header changes */
+#define MANIFEST_VERSION        3
+
+/* Appended to the archive name */
+#define MANIFEST_EXTENSION      ".dtamanifest"
+
+/* Flags of a MANIFEST_ENTRY */
+#define MANIFEST_HASHED         1       /* 'hash' holds the hash of the file */
+#define MANIFEST_STALE          2       /* Extracted again, not saved (in memory only) */
+#define MANIFEST_WRITTEN        4       /* Written completely (in memory only) */
+
+/*
+ * Header of a .dtamanifest file. Everything up to 'count' identifies the
+ * archive that was extracted; only the keys have to match for the entries
+ * to be used.
+ */
+typedef struct t_manifestheader {
+    DWORD           identifier;
+    DWORD           version;
+    DWORD           archiveSizeLow;
+    DWORD           archiveSizeHigh;
+    FILETIME        archiveTime;
+    unsigned int    key1;
+    unsigned int    key2;
+    DWORD           count;
+    DWORD           namesSize;
+    DWORD           checksum;           /* Hash of everything after the header */
+    DWORD           reserved;
+} MANIFEST_HEADER;
+
+/*
+ * A single extracted file.
+ */
+typedef struct t_manifestentry {
+    DWORD               fileSize;
+    DWORD               dataOffset;
+    DWORD               storedSize;     /* Bytes from 'dataOffset' up to the next entry */
+    DWORD               numOfBlocks;
+    DWORD               encrypted;
+    DWORD               nameOffset;
+    DWORD               flags;
+    DWORD               reserved;
+    unsigned __int64    hash;           /* XXH64 of the file data */
+    unsigned __int64    storedHash;     /* XXH64 of the 'storedSize' bytes in the archive */
+    FILETIME            outputTime;     /* Modification time of the output file */
+} MANIFEST_ENTRY;
+
+/*
+ * The manifest of the last run, and the records of this one.
+ */
+typedef struct t_manifest {
+    void                *file;          /* The last run's file, the two below point into it */
+    MANIFEST_ENTRY      *entries;       /* Last run, sorted by data offset */
+    char                *names;
+    DWORD               count;
+    DWORD               namesSize;
+    BOOL                sameArchive;    /* The archive has the recorded size and time */
+    MANIFEST_ENTRY      *records;       /* One per entry left to extract */
+    DWORD               numOfRecords;
+} MANIFEST;
+
+/*----------------------------------------------------------------------------
+ * Loads the manifest of the last run, if it was made with the same keys,
+ * and removes every entry from 'index' that doesn't have to be
+ * extracted again. 'job->manifest' is pointed at 'manifest', so that the
+ * writers can record the hashes. If any errors occur, 'error' string is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Selected entries, sorted by file offset
+ *                  manifest        Manifest to fill
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SkipUnchangedEntries(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Returns where the hash of 'entry' goes in 'job->manifest', or NULL if
+ * there is no manifest. The record is marked as hashed, so the caller has
+ * to store the hash of everything it writes there.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  entry           Position of the entry in that index
+ *--------------------------------------------------------------------------*/
+unsigned __int64 *GetManifestHash(ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD entry);
+
+/*----------------------------------------------------------------------------
+ * Marks 'entry' as written completely. Only marked entries are saved, so
+ * the writers call this once the whole file is on the disk. Does nothing if
+ * there is no manifest.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  entry           Position of the entry in that index
+ *--------------------------------------------------------------------------*/
+void SetManifestWritten(ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD entry);
+
+/*----------------------------------------------------------------------------
+ * Writes the manifest of this run: the entries of the last run that weren't
+ * extracted again, and every file marked by SetManifestWritten whose output
+ * still has its size and whose stored bytes can be hashed. Failing to write it is not an error, the next run
+ * simply extracts everything.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  index           Index passed to SkipUnchangedEntries
+ *                  manifest        Manifest filled by SkipUnchangedEntries
+ *
+ *  Returns TRUE if the manifest was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SaveManifest(ARCHIVE_JOB *job, ENTRY_INDEX *index, MANIFEST *manifest);
+
+/*----------------------------------------------------------------------------
+ * Releases the memory used by the manifest and clears 'job->manifest'.
+ *
+ *  Arguments:      job             Archive being extracted
+ *                  manifest        Manifest to release
+ *--------------------------------------------------------------------------*/
+void ReleaseManifest(ARCHIVE_JOB *job, MANIFEST *manifest);
+
+#endif
@@ -0,0 +1,439 @@
+/*  Description:
+ *      Implementation of the output sinks. The tar headers follow the POSIX
+ *      ustar layout; only regular files are written, directories are implied
+ *      by the paths.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "OutputSink.h"
+#include "Trace.h"
+
+/*
+ * POSIX ustar header, exactly one block.
+ */
+typedef struct t_tarheader {
+    char    name[100];
+    char    mode[8];
+    char    uid[8];
+    char    gid[8];
+    char    size[12];
+    char    mtime[12];
+    char    checksum[8];
+    char    typeflag;
+    char    linkname[100];
+    char    magic[6];
+    char    version[2];
+    char    uname[32];
+    char    gname[32];
+    char    devmajor[8];
+    char    devminor[8];
+    char    prefix[155];
+    char    padding[12];
+} TAR_HEADER;
+
+/* Type flags */
+#define TAR_REGULAR     '0'
+#define TAR_PAX         'x'
+
+static const char zeros[TAR_BLOCK_SIZE] = { 0 };
+
+/*----------------------------------------------------------------------------
+ * Writes 'n' bytes to the tar stream. Returns FALSE if writing failed.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteOutput(OUTPUT_SINK *sink, const void *buf, DWORD n) {
+    DWORD written;
+
+    return WriteFile(sink->hOutput, buf, n, &written, NULL) && written == n;
+}
+
+/*----------------------------------------------------------------------------
+ * Pads the tar stream after 'size' bytes of data to the next block.
+ *--------------------------------------------------------------------------*/
+static BOOL PadOutput(OUTPUT_SINK *sink, DWORD size) {
+    DWORD rest = size % TAR_BLOCK_SIZE;
+
+    return rest == 0 || WriteOutput(sink, zeros, TAR_BLOCK_SIZE - rest);
+}
+
+/*----------------------------------------------------------------------------
+ * Sets the size of a newly created file to 'size' and moves back to its
+ * start. Returns FALSE if the size could not be set.
+ *--------------------------------------------------------------------------*/
+static BOOL PreallocateFile(HANDLE hFile, DWORD size) {
+    LARGE_INTEGER   end;
+    LARGE_INTEGER   start;
+    BOOL            result;
+
+    end.QuadPart    = size;
+    start.QuadPart  = 0;
+
+    result = SetFilePointerEx(hFile, end, NULL, FILE_BEGIN) && SetEndOfFile(hFile);
+    SetFilePointerEx(hFile, start, NULL, FILE_BEGIN);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Stores 'value' as a zero-terminated octal number filling 'field'.
+ *--------------------------------------------------------------------------*/
+static void WriteOctal(char *field, size_t size, DWORD value) {
+    char digits[16];
+
+    sprintf(digits, "%0*o", (int)(size - 1), value);
+    memcpy(field, digits, size - 1);
+    field[size - 1] = '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * Fills in everything of 'header' but the name, then its checksum.
+ *--------------------------------------------------------------------------*/
+static void FinishHeader(OUTPUT_SINK *sink, TAR_HEADER *header, char typeflag, DWORD size) {
+    const unsigned char *bytes = (const unsigned char *)header;
+    DWORD               checksum = 0;
+    DWORD               i;
+
+    WriteOctal(header->mode, sizeof(header->mode), 0644);
+    WriteOctal(header->uid, sizeof(header->uid), 0);
+    WriteOctal(header->gid, sizeof(header->gid), 0);
+    WriteOctal(header->size, sizeof(header->size), size);
+    WriteOctal(header->mtime, sizeof(header->mtime), sink->mtime);
+
+    header->typeflag = typeflag;
+    memcpy(header->magic, "ustar", 6);
+    memcpy(header->version, "00", 2);
+
+    /* The checksum is taken with its own field set to spaces */
+    memset(header->checksum, ' ', sizeof(header->checksum));
+
+    for(i = 0; i < sizeof(TAR_HEADER); ++i)
+        checksum += bytes[i];
+
+    sprintf(header->checksum, "%06o", checksum);
+    header->checksum[7] = ' ';
+}
+
+/*----------------------------------------------------------------------------
+ * Stores 'path' in the name and prefix fields of 'header'. Returns FALSE if
+ * it doesn't fit, which means a pax header is needed.
+ *--------------------------------------------------------------------------*/
+static BOOL SetUstarName(TAR_HEADER *header, const char *path) {
+    size_t length = strlen(path);
+    size_t split;
+
+    if(length <= sizeof(header->name)) {
+        memcpy(header->name, path, length);
+        return TRUE;
+    }
+
+    /* Look for a slash that leaves both halves short enough */
+    for(split = min(length - 1, sizeof(header->prefix)); split > 0; --split) {
+        if(path[split] == '/' && length - split - 1 <= sizeof(header->name) && length - split - 1 > 0) {
+            memcpy(header->prefix, path, split);
+            memcpy(header->name, path + split + 1, length - split - 1);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes a pax extended header holding 'path' for the entry that follows.
+ *--------------------------------------------------------------------------*/
+static BOOL WritePaxPath(OUTPUT_SINK *sink, const char *path) {
+    TAR_HEADER  header;
+    char        record[512];
+    int         length  = (int)strlen(path) + (int)sizeof(" path=\n") - 1;
+    int         digits  = 1;
+
+    /* The length of a record counts its own digits */
+    while(length + digits >= (digits == 1 ? 10 : digits == 2 ? 100 : 1000))
+        ++digits;
+
+    length += digits;
+    sprintf(record, "%d path=%s\n", length, path);
+
+    memset(&header, 0, sizeof(header));
+    strncpy(header.name, "PaxHeader", sizeof(header.name));
+    FinishHeader(sink, &header, TAR_PAX, length);
+
+    return WriteOutput(sink, &header, sizeof(header)) &&
+           WriteOutput(sink, record, length) &&
+           PadOutput(sink, length);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the header of a tar entry for 'filename'.
+ *--------------------------------------------------------------------------*/
+static BOOL WriteTarHeader(OUTPUT_SINK *sink, char *filename, DWORD size) {
+    TAR_HEADER  header;
+    char        path[256 + 1];
+    char        *c;
+    size_t      length;
+
+    /* Same clean-up the files on the disk get, then POSIX separators */
+    strncpy_s(path, sizeof(path), filename, _TRUNCATE);
+    length = NormalizePath(path);
+
+    /* CreateOutputFile refuses these as well */
+    if(length == 0 || path[length - 1] == '\\')
+        return FALSE;
+
+    for(c = path; *c != '\0'; ++c) {
+        if(*c == '\\')
+            *c = '/';
+    }
+
+    memset(&header, 0, sizeof(header));
+
+    if(!SetUstarName(&header, path)) {
+        if(!WritePaxPath(sink, path))
+            return FALSE;
+
+        /* Readers that skip pax headers still get most of the name */
+        memcpy(header.name, path, sizeof(header.name));
+    }
+
+    FinishHeader(sink, &header, TAR_REGULAR, size);
+
+    return WriteOutput(sink, &header, sizeof(header));
+}
+
+/*----------------------------------------------------------------------------
+ * Opens a sink. If 'tarFile' is NULL the files are created on the disk,
+ * otherwise they are written into a tar stream created at 'tarFile', or
+ * written to stdout if it is "-". Returns FALSE if the tar file could not
+ * be created.
+ *
+ *  Arguments:          sink            Sink to open
+ *                      tarFile         Tar output, or NULL
+ *                      dirs            Directories created so far
+ *                      writerThreads   Writer threads for small files, 0
+ *                                      writes every file directly
+ *                      flush           Flush every file to the disk before
+ *                                      closing it
+ *--------------------------------------------------------------------------*/
+BOOL OpenSink(OUTPUT_SINK *sink, const char *tarFile, DIR_CACHE *dirs, DWORD writerThreads, BOOL flush) {
+    memset(sink, 0, sizeof(OUTPUT_SINK));
+
+    sink->dirs  = dirs;
+    sink->flush = flush;
+
+    if(tarFile == NULL) {
+        sink->type = SINK_FILES;
+
+        /* Without the threads every file is simply written directly */
+        if(writerThreads > 0)
+            sink->writer = StartFileWriter(dirs, writerThreads, flush);
+
+        return TRUE;
+    }
+
+    sink->type  = SINK_TAR;
+    sink->mtime = (DWORD)time(NULL);
+
+    if(strcmp(tarFile, "-") == 0) {
+        sink->hOutput       = GetStdHandle(STD_OUTPUT_HANDLE);
+        sink->ownsOutput    = FALSE;
+    } else {
+        sink->hOutput       = CreateFile(tarFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        sink->ownsOutput    = TRUE;
+    }
+
+    if(sink->hOutput == INVALID_HANDLE_VALUE || sink->hOutput == NULL) {
+        sink->dirs = NULL;
+        return FALSE;
+    }
+
+    InitializeCriticalSection(&sink->lock);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Starts the file 'filename' of 'size' bytes. Exactly 'size' bytes should
+ * be written before EndSinkEntry is called. Returns FALSE if the file could
+ * not be started, in which case EndSinkEntry must not be called.
+ *
+ *  Arguments:          sink            Sink to write to
+ *                      filename        Name of the file inside the archive
+ *                      size            Size of the file
+ *                      entry           Receives the started file
+ *--------------------------------------------------------------------------*/
+BOOL BeginSinkEntry(OUTPUT_SINK *sink, char *filename, DWORD size, SINK_ENTRY *entry) {
+    entry->sink         = sink;
+    entry->size         = size;
+    entry->written      = 0;
+    entry->preallocated = FALSE;
+
+    if(sink->type == SINK_FILES) {
+        __int64 started;
+
+        /* An older entry of the same name may still be queued */
+        if(sink->writer != NULL)
+            WaitForFileWriter(sink->writer, filename);
+
+        started         = BeginTrace();
+        entry->hFile    = CreateOutputFile(filename, sink->dirs);
+        EndTrace(TRACE_CREATE, started, 0);
+
+        if(entry->hFile == INVALID_HANDLE_VALUE)
+            return FALSE;
+
+        if(size >= SINK_PREALLOCATE_MIN)
+            entry->preallocated = PreallocateFile(entry->hFile, size);
+
+        return TRUE;
+    }
+
+    EnterCriticalSection(&sink->lock);
+    entry->hFile = sink->hOutput;
+
+    if(!WriteTarHeader(sink, filename, size)) {
+        LeaveCriticalSection(&sink->lock);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Appends 'n' bytes to a started file. Bytes past the size given to
+ * BeginSinkEntry are dropped. Returns FALSE if writing failed.
+ *
+ *  Arguments:          entry           File started by BeginSinkEntry
+ *                      buf             Data to write
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+BOOL WriteSinkEntry(SINK_ENTRY *entry, const void *buf, DWORD n) {
+    DWORD   written = 0;
+    __int64 started = BeginTrace();
+    BOOL    result;
+
+    /* A tar entry can't grow past its header */
+    if(entry->sink->type == SINK_TAR)
+        n = min(n, entry->size - entry->written);
+
+    result = WriteFile(entry->hFile, buf, n, &written, NULL);
+    EndTrace(TRACE_WRITE, started, written);
+
+    if(!result)
+        return FALSE;
+
+    entry->written += written;
+
+    return written == n;
+}
+
+/*----------------------------------------------------------------------------
+ * Finishes a started file. In a tar stream, a file that is shorter than
+ * announced is filled up with zeros so that the stream stays readable. On
+ * the disk, it is cut back to what was written.
+ *
+ *  Arguments:          entry           File started by BeginSinkEntry
+ *--------------------------------------------------------------------------*/
+void EndSinkEntry(SINK_ENTRY *entry) {
+    OUTPUT_SINK *sink = entry->sink;
+
+    if(sink->type == SINK_FILES) {
+        /* The file pointer is right after the written bytes */
+        if(entry->preallocated && entry->written < entry->size)
+            SetEndOfFile(entry->hFile);
+
+        if(sink->flush)
+            FlushFileBuffers(entry->hFile);
+
+        CloseHandle(entry->hFile);
+        return;
+    }
+
+    while(entry->written < entry->size) {
+        DWORD n = min(entry->size - entry->written, TAR_BLOCK_SIZE);
+
+        if(!WriteOutput(sink, zeros, n))
+            break;
+
+        entry->written += n;
+    }
+
+    PadOutput(sink, entry->size);
+    LeaveCriticalSection(&sink->lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes a whole file of 'n' bytes at once. A small file may only be queued
+ * for the writer threads; if they fail to write it, 'failed' is incremented
+ * and FlushSink prints its name. Returns FALSE if the file was written
+ * directly and that failed, TRUE otherwise.
+ *
+ *  Arguments:          sink            Sink to write to
+ *                      filename        Name of the file inside the archive
+ *                      buf             File data
+ *                      n               Size of the file
+ *                      failed          Counter of files that failed in the
+ *                                      writer threads
+ *--------------------------------------------------------------------------*/
+BOOL WriteSinkFile(OUTPUT_SINK *sink, char *filename, const void *buf, DWORD n, LONG volatile *failed) {
+    SINK_ENTRY  entry;
+    BOOL        result;
+
+    /* The copy in the queue is all that is needed, 'buf' can be reused right away */
+    if(sink->type == SINK_FILES && sink->writer != NULL && QueueFile(sink->writer, filename, buf, n, failed))
+        return TRUE;
+
+    if(!BeginSinkEntry(sink, filename, n, &entry))
+        return FALSE;
+
+    result = WriteSinkEntry(&entry, buf, n);
+    EndSinkEntry(&entry);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Waits until every file queued by WriteSinkFile is written, and prints the
+ * names of the ones that could not be.
+ *
+ *  Arguments:          sink            Sink to flush
+ *--------------------------------------------------------------------------*/
+void FlushSink(OUTPUT_SINK *sink) {
+    if(sink->writer != NULL) {
+        FlushFileWriter(sink->writer);
+        PrintFailedFiles(sink->writer);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Closes a sink opened by OpenSink, after writing the queued files. A tar
+ * stream gets its two closing zero blocks. Does nothing if the sink was
+ * never opened.
+ *
+ *  Arguments:          sink            Sink to close
+ *--------------------------------------------------------------------------*/
+void CloseSink(OUTPUT_SINK *sink) {
+    if(sink->dirs == NULL)
+        return;
+
+    StopFileWriter(sink->writer);
+    sink->writer = NULL;
+
+    if(sink->type == SINK_TAR) {
+        WriteOutput(sink, zeros, TAR_BLOCK_SIZE);
+        WriteOutput(sink, zeros, TAR_BLOCK_SIZE);
+
+        if(sink->ownsOutput) {
+            if(sink->flush)
+                FlushFileBuffers(sink->hOutput);
+
+            CloseHandle(sink->hOutput);
+        }
+
+        DeleteCriticalSection(&sink->lock);
+    }
+
+    sink->dirs = NULL;
+}
@@ -0,0 +1,147 @@
+/*  Description:
+ *      Where extracted files go. The default sink creates every file on the
+ *      disk, like WriteToFile does. The tar sink writes all of them into a
+ *      single POSIX tar stream instead, either a file or stdout, so that no
+ *      file or directory is created per entry:
+ *
+ *          DTAUnpacker --tar - Models.dta KEY1 KEY2 | tool
+ *
+ *      Every entry is a ustar header followed by the data, padded to 512
+ *      bytes. Names that don't fit the 100 + 155 bytes of a ustar header get
+ *      a pax extended header with their path first. Backslashes in names
+ *      become slashes.
+ *
+ *      An entry is started with its final size, which every writer knows
+ *      from the entry index. The tar sink keeps a lock from BeginSinkEntry
+ *      to EndSinkEntry, so entries from several threads never interleave.
+ *
+ *      The file sink sets the size of a file of at least SINK_PREALLOCATE_MIN
+ *      bytes before writing it, so the file system can place it in one piece.
+ *      Small files given to WriteSinkFile go to the writer threads of
+ *      FileWriter.h, if the sink was opened with any. FlushSink waits until
+ *      they are on the disk and names the ones that failed; they were
+ *      already counted against their archive.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef OUTPUT_SINK_H_
+#define OUTPUT_SINK_H_
+
+#include <windows.h>
+#include "Container.h"
+#include "FileWriter.h"
+
+/* Kinds of sinks */
+#define SINK_FILES      0
+#define SINK_TAR        1
+
+/* Size of a tar block, headers and data are padded to it */
+#define TAR_BLOCK_SIZE  512
+
+/* Files at least this large get their size set before they are written */
+#define SINK_PREALLOCATE_MIN    (64 * 1024)
+
+/*
+ * Destination of the extracted files.
+ */
+typedef struct t_outputsink {
+    DWORD               type;
+    DIR_CACHE           *dirs;          /* Directories created so far, for SINK_FILES */
+    FILE_WRITER         *writer;        /* Writer threads for small files, may be NULL */
+    BOOL                flush;          /* Flush files to the disk before closing them */
+    HANDLE              hOutput;        /* Tar stream, for SINK_TAR */
+    BOOL                ownsOutput;     /* FALSE if the stream is stdout */
+    CRITICAL_SECTION    lock;           /* Held while a tar entry is written */
+    DWORD               mtime;          /* Modification time of the tar entries */
+} OUTPUT_SINK;
+
+/*
+ * A single file being written to a sink.
+ */
+typedef struct t_sinkentry {
+    OUTPUT_SINK     *sink;
+    HANDLE          hFile;
+    DWORD           size;
+    DWORD           written;
+    BOOL            preallocated;       /* The file already has its final size */
+} SINK_ENTRY;
+
+/*----------------------------------------------------------------------------
+ * Opens a sink. If 'tarFile' is NULL the files are created on the disk,
+ * otherwise they are written into a tar stream created at 'tarFile', or
+ * written to stdout if it is "-". Returns FALSE if the tar file could not
+ * be created.
+ *
+ *  Arguments:          sink            Sink to open
+ *                      tarFile         Tar output, or NULL
+ *                      dirs            Directories created so far
+ *                      writerThreads   Writer threads for small files, 0
+ *                                      writes every file directly
+ *                      flush           Flush every file to the disk before
+ *                                      closing it
+ *--------------------------------------------------------------------------*/
+BOOL OpenSink(OUTPUT_SINK *sink, const char *tarFile, DIR_CACHE *dirs, DWORD writerThreads, BOOL flush);
+
+/*----------------------------------------------------------------------------
+ * Starts the file 'filename' of 'size' bytes. Exactly 'size' bytes should
+ * be written before EndSinkEntry is called. Returns FALSE if the file could
+ * not be started, in which case EndSinkEntry must not be called.
+ *
+ *  Arguments:          sink            Sink to write to
+ *                      filename        Name of the file inside the archive
+ *                      size            Size of the file
+ *                      entry           Receives the started file
+ *--------------------------------------------------------------------------*/
+BOOL BeginSinkEntry(OUTPUT_SINK *sink, char *filename, DWORD size, SINK_ENTRY *entry);
+
+/*----------------------------------------------------------------------------
+ * Appends 'n' bytes to a started file. Bytes past the size given to
+ * BeginSinkEntry are dropped. Returns FALSE if writing failed.
+ *
+ *  Arguments:          entry           File started by BeginSinkEntry
+ *                      buf             Data to write
+ *                      n               Size of data
+ *--------------------------------------------------------------------------*/
+BOOL WriteSinkEntry(SINK_ENTRY *entry, const void *buf, DWORD n);
+
+/*----------------------------------------------------------------------------
+ * Finishes a started file. In a tar stream, a file that is shorter than
+ * announced is filled up with zeros so that the stream stays readable.
+ *
+ *  Arguments:          entry           File started by BeginSinkEntry
+ *--------------------------------------------------------------------------*/
+void EndSinkEntry(SINK_ENTRY *entry);
+
+/*----------------------------------------------------------------------------
+ * Writes a whole file of 'n' bytes at once. A small file may only be queued
+ * for the writer threads; if they fail to write it, 'failed' is incremented
+ * and FlushSink prints its name. Returns FALSE if the file was written
+ * directly and that failed, TRUE otherwise.
+ *
+ *  Arguments:          sink            Sink to write to
+ *                      filename        Name of the file inside the archive
+ *                      buf             File data
+ *                      n               Size of the file
+ *                      failed          Counter of files that failed in the
+ *                                      writer threads
+ *--------------------------------------------------------------------------*/
+BOOL WriteSinkFile(OUTPUT_SINK *sink, char *filename, const void *buf, DWORD n, LONG volatile *failed);
+
+/*----------------------------------------------------------------------------
+ * Waits until every file queued by WriteSinkFile is written, and prints the
+ * names of the ones that could not be.
+ *
+ *  Arguments:          sink            Sink to flush
+ *--------------------------------------------------------------------------*/
+void FlushSink(OUTPUT_SINK *sink);
+
+/*----------------------------------------------------------------------------
+ * Closes a sink opened by OpenSink, after writing the queued files. A tar
+ * stream gets its two closing zero blocks. Does nothing if the sink was
+ * never opened.
+ *
+ *  Arguments:          sink            Sink to close
+ *--------------------------------------------------------------------------*/
+void CloseSink(OUTPUT_SINK *sink);
+
+#endif
@@ -0,0 +1,475 @@
+/*  Description:
+ *      Implementation of the multi-threaded extraction. The workers share a
+ *      counter of started work items and take the next one with an
+ *      interlocked increment, so large and small files balance out across
+ *      threads. A work item is either a whole entry or one range of a split
+ *      file, of any of the archives.
+ *
+ *      A worker reserves the memory its buffer needs for an item from the
+ *      budget before it starts, and waits while the others hold too much of
+ *      it. A buffer of up to an even share of the budget is kept for the next
+ *      item, a larger one is freed once the item is done.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <process.h>
+#include "Parallel.h"
+#include "Container.h"
+#include "BufferPool.h"
+#include "Manifest.h"
+#include "Trace.h"
+
+/*
+ * A whole entry, or the range of a split entry starting at 'offset'.
+ */
+typedef struct t_workitem {
+    ARCHIVE_JOB     *job;
+    ENTRY_INDEX     *index;
+    DWORD           entry;              /* Position in 'index' */
+    DWORD           offset;
+    DWORD           length;
+    BOOL            isRange;
+    BOOL            written;            /* Extracted completely */
+} WORK_ITEM;
+
+/*
+ * State shared by all workers.
+ */
+typedef struct t_workqueue {
+    APP_DATA            *data;
+    WORK_ITEM           *items;
+    DWORD               count;
+    LONG volatile       next;
+
+    CRITICAL_SECTION    lock;           /* Guards 'reserved' */
+    HANDLE              hReleased;      /* Set whenever memory is given back */
+    unsigned __int64    reserved;       /* Bytes reserved by all workers */
+    unsigned __int64    budget;
+    DWORD               share;          /* Largest buffer a worker keeps */
+} WORK_QUEUE;
+
+/*
+ * A single worker with its own buffer.
+ */
+typedef struct t_worker {
+    WORK_QUEUE      *queue;
+    HANDLE          hThread;
+    BUF_CONTAINER   buffer;
+    DWORD           reserved;           /* Part of the budget held for 'buffer' */
+    char            error[ERROR_LENGTH];
+} WORKER;
+
+/*----------------------------------------------------------------------------
+ * Gives the memory reserved by 'worker' back to the budget and frees its
+ * buffer along with it.
+ *
+ *  Arguments:      worker          Worker holding the memory
+ *--------------------------------------------------------------------------*/
+static void ReleaseWorkerMemory(WORKER *worker) {
+    WORK_QUEUE *queue = worker->queue;
+
+    if(worker->reserved == 0)
+        return;
+
+    ReleaseBuffer(&worker->buffer);
+
+    EnterCriticalSection(&queue->lock);
+    queue->reserved -= worker->reserved;
+    SetEvent(queue->hReleased);
+    LeaveCriticalSection(&queue->lock);
+
+    worker->reserved = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Reserves 'size' bytes of the budget for the buffer of 'worker', waiting
+ * while the other workers hold too much of it. A worker that has to wait
+ * gives back what it holds first, so that two waiting workers can't block
+ * each other. A single item larger than the budget is still let through
+ * once nothing else is reserved.
+ *
+ *  Arguments:      worker          Worker that needs the memory
+ *                  size            Bytes the buffer has to hold
+ *--------------------------------------------------------------------------*/
+static void ReserveWorkerMemory(WORKER *worker, DWORD size) {
+    WORK_QUEUE *queue = worker->queue;
+
+    if(size <= worker->reserved)
+        return;
+
+    EnterCriticalSection(&queue->lock);
+
+    if(queue->reserved + (size - worker->reserved) > queue->budget && queue->reserved > worker->reserved) {
+        LeaveCriticalSection(&queue->lock);
+        ReleaseWorkerMemory(worker);
+
+        EnterCriticalSection(&queue->lock);
+
+        /* The event is reset under the lock, a release after this sets it again */
+        while(queue->reserved > 0 && queue->reserved + size > queue->budget) {
+            ResetEvent(queue->hReleased);
+            LeaveCriticalSection(&queue->lock);
+            WaitForSingleObject(queue->hReleased, INFINITE);
+            EnterCriticalSection(&queue->lock);
+        }
+    }
+
+    queue->reserved     += size - worker->reserved;
+    worker->reserved    = size;
+    LeaveCriticalSection(&queue->lock);
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts 'item->length' bytes of a split file, starting at 'item->offset',
+ * into the same place of the preallocated output file. Fails if the range
+ * can't be read or written completely; the rest of the file may already be
+ * written, so the caller has to discard it.
+ *
+ *  Arguments:      data            Pointer to APP_DATA object
+ *                  item            Range to extract
+ *                  buffer          Buffer for the file contents
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+static BOOL ProcessRange(APP_DATA *data, WORK_ITEM *item, BUF_CONTAINER *buffer, char error[ERROR_LENGTH]) {
+    ENTRY_INDEX     *index      = item->index;
+    ENTRY_STREAM    stream;
+    char            *filename   = ENTRY_NAME(index, item->entry);
+    DWORD           position    = item->offset;
+    DWORD           remaining   = item->length;
+    HANDLE          hFile;
+    __int64         started;
+
+    if(!OpenEntryStream(data, index, item->entry, &stream)) {
+        strncpy_s(error, ERROR_LENGTH, "A file inside the archive could not be opened", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    if(!ReserveBuffer(buffer, min(remaining, data->streamWindow))) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+        CloseEntryStream(&stream);
+        return FALSE;
+    }
+
+    started = BeginTrace();
+    hFile   = OpenOutputFile(filename);
+    EndTrace(TRACE_CREATE, started, 0);
+
+    if(hFile == INVALID_HANDLE_VALUE) {
+        strncpy_s(error, ERROR_LENGTH, "A file could not be opened on the disk", ERROR_LENGTH);
+        CloseEntryStream(&stream);
+        return FALSE;
+    }
+
+    /* libdta decodes from any position inside the file, the blocks before it are skipped */
+    SeekEntryStream(&stream, position);
+
+    while(remaining > 0) {
+        DWORD       read;
+        DWORD       written = 0;
+        OVERLAPPED  overlapped;
+        BOOL        result;
+
+        started = BeginTrace();
+        read    = ReadEntryStream(&stream, buffer->buf, min(remaining, (DWORD)buffer->size));
+        EndTrace(TRACE_READ, started, read);
+
+        if(read == 0)
+            break;
+
+        /* Written at the position of the range, like pwrite */
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = position;
+
+        started = BeginTrace();
+        result  = WriteFile(hFile, (void *)buffer->buf, read, &written, &overlapped);
+        EndTrace(TRACE_WRITE, started, written);
+
+        if(!result || written != read) {
+            strncpy_s(error, ERROR_LENGTH, "A file could not be written to the disk", ERROR_LENGTH);
+            CloseHandle(hFile);
+            CloseEntryStream(&stream);
+            return FALSE;
+        }
+
+        position  += read;
+        remaining -= read;
+    }
+
+    CloseHandle(hFile);
+    CloseEntryStream(&stream);
+
+    /* The archive ended early, the rest of the range would stay zero */
+    if(remaining > 0) {
+        strncpy_s(error, ERROR_LENGTH, "A file inside the archive could not be read", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Cuts the preallocated output of a split file that wasn't extracted
+ * completely back to zero bytes, so that it can't pass for a whole file.
+ *
+ *  Arguments:      filename        Name of the file inside the archive
+ *--------------------------------------------------------------------------*/
+static void DiscardOutputFile(char *filename) {
+    HANDLE hFile = OpenOutputFile(filename);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    SetEndOfFile(hFile);
+    CloseHandle(hFile);
+}
+
+/*----------------------------------------------------------------------------
+ * Thread procedure, extracts work items until the queue is empty. A file
+ * that fails is reported and skipped, like it is in ProcessDTAFiles.
+ *
+ *  Arguments:      param           Pointer to the WORKER
+ *--------------------------------------------------------------------------*/
+static unsigned __stdcall WorkerProc(void *param) {
+    WORKER      *worker = (WORKER *)param;
+    WORK_QUEUE  *queue  = worker->queue;
+    LONG        next;
+
+    while((next = InterlockedIncrement(&queue->next) - 1) < (LONG)queue->count) {
+        WORK_ITEM   *item   = &queue->items[next];
+        ARCHIVE_JOB *job    = item->job;
+
+        /* ProcessFile and ProcessRange hold at most a window of the file */
+        ReserveWorkerMemory(worker, max(min(item->length, queue->data->streamWindow), 1));
+
+        if(item->isRange)
+            item->written = ProcessRange(queue->data, item, &worker->buffer, worker->error);
+        else if(ProcessFile(queue->data, item->index, item->entry, &worker->buffer,
+                            GetManifestHash(job, item->index, item->entry), worker->error))
+            SetManifestWritten(job, item->index, item->entry);
+        else
+            ReportFailedFile(job, ENTRY_NAME(item->index, item->entry), worker->error);
+
+        if(worker->reserved > queue->share)
+            ReleaseWorkerMemory(worker);
+    }
+
+    ReleaseWorkerMemory(worker);
+    FlushBufferCache();
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Adds a work item for 'length' bytes of the entry at position 'entry' of
+ * 'index', starting at 'offset', to 'queue'.
+ *--------------------------------------------------------------------------*/
+static void AddWorkItem(WORK_QUEUE *queue, ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD entry, DWORD offset, DWORD length,
+                        BOOL isRange) {
+    WORK_ITEM *item = &queue->items[queue->count++];
+
+    item->job       = job;
+    item->index     = index;
+    item->entry     = entry;
+    item->offset    = offset;
+    item->length    = length;
+    item->isRange   = isRange;
+    item->written   = FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'queue->items' with the work for the entries of every archive.
+ * Files that are split are preallocated here, before any worker writes to
+ * them; if that fails the file is extracted as a whole instead. Returns
+ * FALSE if the items can't be allocated.
+ *
+ *  Arguments:      queue           Queue with 'data' set
+ *                  jobs            Archives holding the entries
+ *                  indexes         Entries to extract, one index per job
+ *                  numOfJobs       Number of jobs
+ *--------------------------------------------------------------------------*/
+static BOOL BuildWorkItems(WORK_QUEUE *queue, ARCHIVE_JOB *jobs, ENTRY_INDEX *indexes, DWORD numOfJobs) {
+    APP_DATA    *data       = queue->data;
+    DWORD       threshold   = data->splitThreshold;
+    DWORD       count       = 0;
+    DWORD       i;
+    DWORD       j;
+    DWORD       k;
+
+    for(k = 0; k < numOfJobs; ++k) {
+        for(i = 0; i < indexes[k].count; ++i) {
+            DWORD fileSize = indexes[k].fileSizes[i];
+
+            if(threshold > 0 && fileSize >= threshold)
+                count += (fileSize + SPLIT_RANGE_SIZE - 1) / SPLIT_RANGE_SIZE;
+            else
+                ++count;
+        }
+    }
+
+    queue->items = (WORK_ITEM *)malloc(sizeof(WORK_ITEM) * max(count, 1));
+    queue->count = 0;
+
+    if(queue->items == NULL)
+        return FALSE;
+
+    /* Large files go first, so the small ones fill up the end */
+    for(k = 0; k < numOfJobs; ++k) {
+        ENTRY_INDEX *index = &indexes[k];
+
+        for(i = 0; i < index->count; ++i) {
+            DWORD fileSize = index->fileSizes[i];
+
+            if(threshold == 0 || fileSize < threshold)
+                continue;
+
+            if(!PreallocateOutputFile(ENTRY_NAME(index, i), fileSize, &data->dirCache)) {
+                AddWorkItem(queue, &jobs[k], index, i, 0, fileSize, FALSE);
+                continue;
+            }
+
+            for(j = 0; j < fileSize; j += SPLIT_RANGE_SIZE)
+                AddWorkItem(queue, &jobs[k], index, i, j, min(fileSize - j, SPLIT_RANGE_SIZE), TRUE);
+        }
+    }
+
+    for(k = 0; k < numOfJobs; ++k) {
+        ENTRY_INDEX *index = &indexes[k];
+
+        for(i = 0; i < index->count; ++i) {
+            DWORD fileSize = index->fileSizes[i];
+
+            if(threshold == 0 || fileSize < threshold)
+                AddWorkItem(queue, &jobs[k], index, i, 0, fileSize, FALSE);
+        }
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the number of processors in the system, used when -j is 0.
+ *--------------------------------------------------------------------------*/
+DWORD GetProcessorCount(void) {
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'indexes[i]' out of the archive of 'jobs[i]', for
+ * all 'count' archives at once, using 'data->numOfThreads' worker threads.
+ * The ranges of split files are started first, the other entries follow in
+ * index order, one archive after the other. A file that fails is counted
+ * in the job of its archive. If any errors occur, 'error' string is set and
+ * the function returns FALSE.
+ *
+ *  Arguments:      jobs            Archives holding the entries
+ *                  indexes         Entries to extract, one index per job
+ *                  count           Number of jobs
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesParallel(ARCHIVE_JOB *jobs, ENTRY_INDEX *indexes, DWORD count, char error[ERROR_LENGTH]) {
+    APP_DATA    *data           = jobs[0].data;
+    WORK_QUEUE  queue;
+    WORKER      workers[MAX_THREADS];
+    DWORD       numOfWorkers;
+    DWORD       started         = 0;
+    DWORD       i;
+    BOOL        result          = TRUE;
+
+    memset(&queue, 0, sizeof(queue));
+    queue.data      = data;
+    queue.budget    = data->pipelineBudget;
+
+    if(!BuildWorkItems(&queue, jobs, indexes, count)) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the work items", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    if((queue.hReleased = CreateEvent(NULL, TRUE, FALSE, NULL)) == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not create the events of the workers", ERROR_LENGTH);
+        free(queue.items);
+        return FALSE;
+    }
+
+    InitializeCriticalSection(&queue.lock);
+
+    numOfWorkers = min(data->numOfThreads, MAX_THREADS);
+
+    if(numOfWorkers > queue.count)
+        numOfWorkers = max(queue.count, 1);
+
+    queue.share = data->pipelineBudget / numOfWorkers;
+
+    memset(workers, 0, sizeof(workers));
+
+    for(i = 0; i < numOfWorkers; ++i) {
+        WORKER *worker = &workers[i];
+
+        worker->queue = &queue;
+
+        if(!InitBuffer(&worker->buffer, 1024)) {
+            strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+            result = FALSE;
+            break;
+        }
+
+        worker->hThread = (HANDLE)_beginthreadex(NULL, 0, WorkerProc, worker, 0, NULL);
+
+        if(worker->hThread == NULL) {
+            strncpy_s(error, ERROR_LENGTH, "Could not start a worker thread", ERROR_LENGTH);
+            ReleaseBuffer(&worker->buffer);
+            result = FALSE;
+            break;
+        }
+
+        ++started;
+    }
+
+    /* If starting a worker failed, stop the others from taking new items */
+    if(!result)
+        InterlockedExchange(&queue.next, (LONG)queue.count);
+
+    for(i = 0; i < started; ++i) {
+        WaitForSingleObject(workers[i].hThread, INFINITE);
+        CloseHandle(workers[i].hThread);
+
+        ReleaseBuffer(&workers[i].buffer);
+    }
+
+    /* A split file is only whole if every range of it was extracted */
+    for(i = 0; i < queue.count; ++i) {
+        WORK_ITEM   *item       = &queue.items[i];
+        BOOL        written     = TRUE;
+
+        if(!item->isRange)
+            continue;
+
+        for(; i < queue.count && queue.items[i].index == item->index && queue.items[i].entry == item->entry; ++i)
+            written = written && queue.items[i].written;
+
+        --i;
+
+        if(written)
+            SetManifestWritten(item->job, item->index, item->entry);
+        else {
+            DiscardOutputFile(ENTRY_NAME(item->index, item->entry));
+            ReportFailedFile(item->job, ENTRY_NAME(item->index, item->entry), "A range of the file could not be extracted");
+        }
+    }
+
+    DeleteCriticalSection(&queue.lock);
+    CloseHandle(queue.hReleased);
+    free(queue.items);
+
+    return result;
+}
@@ -0,0 +1,57 @@
+/*  Description:
+ *      Multi-threaded extraction. Every worker thread keeps its own buffer
+ *      and takes entries from the index until none are left. Only the native backend can be used
+ *      from several threads; tmp.dll keeps a single stream position.
+ *
+ *      The workers are shared by every archive of a batch: the entries of all
+ *      of them go into one queue, and the buffers of the workers together
+ *      stay within 'data->pipelineBudget' bytes (--budget).
+ *
+ *      Files of at least 'data->splitThreshold' bytes are split into ranges
+ *      of SPLIT_RANGE_SIZE bytes. The output file is preallocated, and every
+ *      range is read, decrypted and written at its own position by whichever
+ *      worker takes it, so a single large file no longer keeps one thread
+ *      busy while the others are idle. If any range of a file fails, the
+ *      file is cut back to zero bytes, so it never passes for a whole one.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "EntryIndex.h"
+
+/* Upper limit for -j, every worker holds a native handle */
+#define MAX_THREADS     32
+
+/* Default for --split, files at least this large are split into ranges */
+#define DEFAULT_SPLIT_THRESHOLD     (32 * 1024 * 1024)
+
+/* Size of a single range of a split file */
+#define SPLIT_RANGE_SIZE            (4 * 1024 * 1024)
+
+/*----------------------------------------------------------------------------
+ * Returns the number of processors in the system, used when -j is 0.
+ *--------------------------------------------------------------------------*/
+DWORD GetProcessorCount(void);
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'indexes[i]' out of the archive of 'jobs[i]', for
+ * all 'count' archives at once, using 'data->numOfThreads' worker threads.
+ * The ranges of split files are started first, the other entries follow in
+ * index order, one archive after the other. A file that fails is counted
+ * in the job of its archive. If any errors occur, 'error' string is set and
+ * the function returns FALSE.
+ *
+ *  Arguments:      jobs            Archives holding the entries
+ *                  indexes         Entries to extract, one index per job
+ *                  count           Number of jobs
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesParallel(ARCHIVE_JOB *jobs, ENTRY_INDEX *indexes, DWORD count, char error[ERROR_LENGTH]);
+
+#endif
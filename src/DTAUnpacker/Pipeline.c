@@ -0,0 +1,345 @@
+/*  Description:
+ *      Implementation of the extraction pipeline. The ring is driven by three
+ *      semaphores: free slots for the reader, read slots for the decryptor and
+ *      decrypted slots for the writer. A slot with 'last' set tells the later
+ *      stages that the reader is done.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <process.h>
+#include "Pipeline.h"
+#include "Container.h"
+#include "BufferPool.h"
+#include "Hash.h"
+#include "Manifest.h"
+#include "Trace.h"
+
+/*
+ * A single entry travelling through the pipeline.
+ */
+typedef struct t_pipelineslot {
+    BUF_CONTAINER   stored;             /* Blocks as they are in the archive */
+    DWORD           storedSize;
+    BUF_CONTAINER   buffer;             /* Decoded file data */
+    DWORD           fileSize;           /* Bytes decoded, short if a block is corrupt */
+    DWORD           reserved;           /* Bytes of the budget held by the slot */
+    BOOL            last;
+    DWORD           entry;              /* Position in the entry index */
+    char            *filename;          /* Points into the entry index */
+    unsigned __int64 *hash;             /* Manifest record, NULL without --incremental */
+} PIPELINE_SLOT;
+
+/*
+ * State shared by the stages.
+ */
+typedef struct t_pipeline {
+    ARCHIVE_JOB     *job;
+    APP_DATA        *data;
+    ENTRY_INDEX     *index;
+    PIPELINE_SLOT   slots[PIPELINE_MAX_DEPTH];
+    DWORD           depth;
+    DWORD           slotLimit;          /* Slot buffers are shrunk back to this */
+
+    HANDLE          hFree;
+    HANDLE          hRead;
+    HANDLE          hDecrypted;
+    HANDLE          hReleased;          /* Signalled whenever bytes leave the pipeline */
+    LONGLONG volatile bytesInFlight;
+
+    double          decryptTime;
+    double          writeTime;
+} PIPELINE;
+
+/*----------------------------------------------------------------------------
+ * Returns the current value of the performance counter in seconds.
+ *--------------------------------------------------------------------------*/
+static double Now(void) {
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/*----------------------------------------------------------------------------
+ * Decrypt stage. Decrypts and decodes the stored blocks the reader copied
+ * into every slot, and hashes the file data for the manifest, in order.
+ *
+ *  Arguments:      param           Pointer to the PIPELINE
+ *--------------------------------------------------------------------------*/
+static unsigned __stdcall DecryptProc(void *param) {
+    PIPELINE    *pipeline   = (PIPELINE *)param;
+    DWORD       index       = 0;
+
+    for(;;) {
+        PIPELINE_SLOT   *slot = &pipeline->slots[index];
+        double          start;
+        __int64         started;
+        BOOL            last;
+
+        WaitForSingleObject(pipeline->hRead, INFINITE);
+
+        /* Once the writer has the slot the reader may fill it again */
+        last = slot->last;
+
+        if(!last) {
+            ENTRY_INDEX     *entries = pipeline->index;
+            DTA_ENTRY_INFO  info;
+
+            start = Now();
+
+            GetEntryInfo(entries, slot->entry, &info);
+
+            started         = BeginTrace();
+            slot->fileSize  = DtaDecodeEntry(entries->archive, &info, slot->stored.buf, slot->storedSize, slot->buffer.buf,
+                                             entries->fileSizes[slot->entry]);
+            EndTrace(TRACE_DECRYPT, started, slot->fileSize);
+
+            if(slot->hash != NULL) {
+                started = BeginTrace();
+                *slot->hash = Hash64(slot->buffer.buf, slot->fileSize, 0);
+                EndTrace(TRACE_HASH, started, slot->fileSize);
+            }
+
+            pipeline->decryptTime += Now() - start;
+        }
+
+        ReleaseSemaphore(pipeline->hDecrypted, 1, NULL);
+
+        if(last)
+            return 0;
+
+        index = (index + 1) % pipeline->depth;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Write stage. Writes every slot to the output sink in order, then hands
+ * the slot back to the reader.
+ *
+ *  Arguments:      param           Pointer to the PIPELINE
+ *--------------------------------------------------------------------------*/
+static unsigned __stdcall WriteProc(void *param) {
+    PIPELINE    *pipeline   = (PIPELINE *)param;
+    DWORD       index       = 0;
+
+    for(;;) {
+        PIPELINE_SLOT   *slot = &pipeline->slots[index];
+        double          start;
+
+        WaitForSingleObject(pipeline->hDecrypted, INFINITE);
+
+        /* Buffers released here are leased again by the reader */
+        if(slot->last) {
+            FlushBufferCache();
+            return 0;
+        }
+
+        start = Now();
+
+        /* A file that could not be decoded whole is not written at all */
+        if(slot->fileSize < pipeline->index->fileSizes[slot->entry])
+            ReportFailedFile(pipeline->job, slot->filename, "A file inside the archive could not be decoded");
+        else if(WriteSinkFile(&pipeline->data->sink, slot->filename, slot->buffer.buf, slot->fileSize,
+                              &pipeline->job->failedFiles))
+            SetManifestWritten(pipeline->job, pipeline->index, slot->entry);
+        else
+            ReportFailedFile(pipeline->job, slot->filename, "The file could not be written to the disk");
+
+        pipeline->writeTime += Now() - start;
+
+        /* Don't let one large file keep its memory for the rest of the run */
+        if(slot->buffer.size > pipeline->slotLimit)
+            ReleaseBuffer(&slot->buffer);
+
+        if(slot->stored.size > pipeline->slotLimit)
+            ReleaseBuffer(&slot->stored);
+
+        InterlockedExchangeAdd64(&pipeline->bytesInFlight, -(LONGLONG)slot->reserved);
+        SetEvent(pipeline->hReleased);
+        ReleaseSemaphore(pipeline->hFree, 1, NULL);
+
+        index = (index + 1) % pipeline->depth;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Read stage. Copies the stored blocks of the entry at position 'entry'
+ * into 'slot', as they are in the archive, and makes room for the decoded
+ * data. Returns FALSE if there is no memory for it.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadEntry(PIPELINE *pipeline, PIPELINE_SLOT *slot, ENTRY_INDEX *index, DWORD entry, char error[ERROR_LENGTH]) {
+    APP_DATA        *data       = pipeline->data;
+    DWORD           fileSize    = index->fileSizes[entry];
+    DTA_ENTRY_INFO  info;
+    LONGLONG        inFlight;
+    ULONGLONG       reserved;
+    __int64         started;
+
+    GetEntryInfo(index, entry, &info);
+
+    /* Both the stored and the decoded bytes stay in the slot until it is written */
+    reserved = (ULONGLONG)info.storedSize + fileSize;
+
+    /* Stay within the budget, unless nothing else is in flight */
+    while((inFlight = InterlockedExchangeAdd64(&pipeline->bytesInFlight, 0)) > 0 &&
+          (ULONGLONG)inFlight + reserved > data->pipelineBudget)
+        WaitForSingleObject(pipeline->hReleased, INFINITE);
+
+    if(!ReserveBuffer(&slot->stored, max(info.storedSize, 1)) || !ReserveBuffer(&slot->buffer, max(fileSize, 1))) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    InterlockedExchangeAdd64(&pipeline->bytesInFlight, (LONGLONG)reserved);
+
+    slot->entry     = entry;
+    slot->filename  = ENTRY_NAME(index, entry);
+    slot->hash      = GetManifestHash(pipeline->job, index, entry);
+    slot->reserved  = (DWORD)reserved;
+
+    started             = BeginTrace();
+    slot->storedSize    = DtaReadRaw(index->archive, info.dataOffset, slot->stored.buf, info.storedSize);
+    EndTrace(TRACE_READ, started, slot->storedSize);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'index' through the pipeline,
+ * using 'data->pipelineDepth' buffers and at most 'data->pipelineBudget'
+ * bytes of file data in flight (a single larger file is still let through).
+ * If any errors occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive holding the entries
+ *                  index           Entries to extract
+ *                  stats           Receives the stage timings
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesPipelined(ARCHIVE_JOB *job, ENTRY_INDEX *index, PIPELINE_STATS *stats, char error[ERROR_LENGTH]) {
+    APP_DATA    *data       = job->data;
+    PIPELINE    *pipeline;
+    HANDLE      hThreads[2];
+    DWORD       numOfFiles  = index->count;
+    DWORD       next        = 0;
+    DWORD       slot        = 0;
+    DWORD       i;
+    double      start       = Now();
+    BOOL        result      = TRUE;
+
+    if((pipeline = (PIPELINE *)calloc(1, sizeof(PIPELINE))) == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the pipeline", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    pipeline->job       = job;
+    pipeline->data      = data;
+    pipeline->index     = index;
+    pipeline->depth     = max(2, min(data->pipelineDepth, PIPELINE_MAX_DEPTH));
+    pipeline->slotLimit = max(1024, data->pipelineBudget / pipeline->depth);
+
+    for(i = 0; i < pipeline->depth; ++i) {
+        if(!InitBuffer(&pipeline->slots[i].buffer, 1024) || !InitBuffer(&pipeline->slots[i].stored, 1024)) {
+            strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+            ReleaseBuffer(&pipeline->slots[i].buffer);
+
+            while(i--) {
+                ReleaseBuffer(&pipeline->slots[i].buffer);
+                ReleaseBuffer(&pipeline->slots[i].stored);
+            }
+
+            free(pipeline);
+            return FALSE;
+        }
+    }
+
+    pipeline->hFree         = CreateSemaphore(NULL, pipeline->depth, pipeline->depth, NULL);
+    pipeline->hRead         = CreateSemaphore(NULL, 0, pipeline->depth, NULL);
+    pipeline->hDecrypted    = CreateSemaphore(NULL, 0, pipeline->depth, NULL);
+    pipeline->hReleased     = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    hThreads[0] = (HANDLE)_beginthreadex(NULL, 0, DecryptProc, pipeline, 0, NULL);
+    hThreads[1] = (HANDLE)_beginthreadex(NULL, 0, WriteProc, pipeline, 0, NULL);
+
+    if(hThreads[0] == NULL || hThreads[1] == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not start the pipeline threads", ERROR_LENGTH);
+        result = FALSE;
+        numOfFiles = 0;
+    }
+
+    memset(stats, 0, sizeof(PIPELINE_STATS));
+
+    /* The reader runs on this thread, in index order */
+    for(next = 0; next < numOfFiles; ++next) {
+        double readStart;
+
+        WaitForSingleObject(pipeline->hFree, INFINITE);
+
+        readStart = Now();
+        pipeline->slots[slot].last = FALSE;
+
+        if(!ReadEntry(pipeline, &pipeline->slots[slot], index, next, error)) {
+            /* Nothing was queued, the slot is still free */
+            ReleaseSemaphore(pipeline->hFree, 1, NULL);
+            result = FALSE;
+            break;
+        }
+
+        stats->readTime += Now() - readStart;
+
+        ReleaseSemaphore(pipeline->hRead, 1, NULL);
+        slot = (slot + 1) % pipeline->depth;
+    }
+
+    /* Tell the stages that run that there is nothing left; without the decryptor the writer gets it directly */
+    if(hThreads[0] != NULL || hThreads[1] != NULL) {
+        WaitForSingleObject(pipeline->hFree, INFINITE);
+        pipeline->slots[slot].last = TRUE;
+        ReleaseSemaphore(hThreads[0] != NULL ? pipeline->hRead : pipeline->hDecrypted, 1, NULL);
+    }
+
+    for(i = 0; i < 2; ++i) {
+        if(hThreads[i] != NULL) {
+            WaitForSingleObject(hThreads[i], INFINITE);
+            CloseHandle(hThreads[i]);
+        }
+    }
+
+    stats->decryptTime  = pipeline->decryptTime;
+    stats->writeTime    = pipeline->writeTime;
+    stats->wallTime     = Now() - start;
+
+    for(i = 0; i < pipeline->depth; ++i) {
+        ReleaseBuffer(&pipeline->slots[i].buffer);
+        ReleaseBuffer(&pipeline->slots[i].stored);
+    }
+
+    CloseHandle(pipeline->hFree);
+    CloseHandle(pipeline->hRead);
+    CloseHandle(pipeline->hDecrypted);
+    CloseHandle(pipeline->hReleased);
+    free(pipeline);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Prints the stage timings to stderr. The overlap is the busy time of all
+ * stages divided by the wall time: 1.0 means nothing overlapped, 3.0 means
+ * all three stages were busy the whole time.
+ *
+ *  Arguments:      stats           Timings from ProcessDTAFilesPipelined
+ *--------------------------------------------------------------------------*/
+void PrintPipelineStats(const PIPELINE_STATS *stats) {
+    double busy = stats->readTime + stats->decryptTime + stats->writeTime;
+
+    fprintf(stderr, "Pipeline: read %.3fs, decrypt %.3fs, write %.3fs, wall %.3fs, overlap %.2fx\n",
+            stats->readTime, stats->decryptTime, stats->writeTime, stats->wallTime,
+            stats->wallTime > 0.0 ? busy / stats->wallTime : 0.0);
+}
@@ -0,0 +1,59 @@
+/*  Description:
+ *      Pipelined extraction. Reading, decrypting and writing run on their own
+ *      threads and pass entries through a bounded ring of buffers, so that
+ *      reading entry N+1, decrypting entry N and writing entry N-1 overlap.
+ *
+ *      The read stage only copies the stored blocks of an entry out of the
+ *      archive with DtaReadRaw, so the pipeline needs the native backend. The
+ *      decrypt stage decrypts and decodes them with DtaDecodeEntry and hashes
+ *      the result for the manifest, the write stage hands it to the output.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "EntryIndex.h"
+
+/* Defaults for --depth and --budget */
+#define PIPELINE_DEFAULT_DEPTH      4
+#define PIPELINE_DEFAULT_BUDGET     (64 * 1024 * 1024)
+#define PIPELINE_MAX_DEPTH          64
+
+/*
+ * Time spent by each stage, used to report how well the stages overlapped.
+ */
+typedef struct t_pipelinestats {
+    double  readTime;
+    double  decryptTime;
+    double  writeTime;
+    double  wallTime;
+} PIPELINE_STATS;
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'index' through the pipeline,
+ * using 'data->pipelineDepth' buffers and at most 'data->pipelineBudget'
+ * bytes of file data in flight (a single larger file is still let through).
+ * If any errors occur, 'error' string is set and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive holding the entries
+ *                  index           Entries to extract
+ *                  stats           Receives the stage timings
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesPipelined(ARCHIVE_JOB *job, ENTRY_INDEX *index, PIPELINE_STATS *stats, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Prints the stage timings to stderr. The overlap is the busy time of all
+ * stages divided by the wall time: 1.0 means nothing overlapped, 3.0 means
+ * all three stages were busy the whole time.
+ *
+ *  Arguments:      stats           Timings from ProcessDTAFilesPipelined
+ *--------------------------------------------------------------------------*/
+void PrintPipelineStats(const PIPELINE_STATS *stats);
+
+#endif
@@ -0,0 +1,206 @@
+/*  Description:
+ *      Implementation of the run scheduler. Runs are found one at a time
+ *      while walking the sorted index, so nothing has to be allocated for
+ *      them.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include "Scheduler.h"
+#include "Container.h"
+#include "Hash.h"
+#include "Manifest.h"
+#include "Trace.h"
+
+/*----------------------------------------------------------------------------
+ * Returns the index of the entry after the run starting at 'first'. The
+ * decoded size of the run goes to 'runSize' and the stored bytes it covers
+ * in the archive to 'runSpan'. A run always holds at least one entry.
+ *
+ *  Arguments:      index           Sorted entries
+ *                  first           First entry of the run
+ *                  limit           Largest decoded size of a run
+ *                  runSize         Receives the decoded size of the run
+ *                  runSpan         Receives the stored size of the run
+ *--------------------------------------------------------------------------*/
+static DWORD FindRun(ENTRY_INDEX *index, DWORD first, DWORD limit, DWORD *runSize, DWORD *runSpan) {
+    DWORD start = index->dataOffsets[first];
+    DWORD end   = start + index->storedSizes[first];
+    DWORD size  = index->fileSizes[first];
+    DWORD next;
+
+    for(next = first + 1; next < index->count; ++next) {
+        DWORD dataOffset = index->dataOffsets[next];
+
+        /* An entry listed twice shares its blocks, it is read on its own again */
+        if(dataOffset < end || dataOffset - end > SCHEDULE_MAX_GAP)
+            break;
+
+        if(size > limit || index->fileSizes[next] > limit - size)
+            break;
+
+        size   += index->fileSizes[next];
+        end     = dataOffset + index->storedSizes[next];
+    }
+
+    *runSize = size;
+    *runSpan = end - start;
+
+    return next;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies the 'span' stored bytes of the run from 'first' up to 'last' into
+ * 'stored' with a single DtaReadRaw, then decodes its entries out of them
+ * one after the other into 'buffer'. 'read' receives the number of bytes
+ * decoded. Returns the first entry that could not be decoded completely,
+ * 'last' if there is none.
+ *--------------------------------------------------------------------------*/
+static DWORD ReadRun(ENTRY_INDEX *index, DWORD first, DWORD last, DWORD span, char *stored, char *buffer, DWORD *read) {
+    DWORD   start   = index->dataOffsets[first];
+    DWORD   valid   = 0;
+    DWORD   copied;
+    DWORD   i;
+    __int64 started;
+
+    started = BeginTrace();
+    copied  = DtaReadRaw(index->archive, start, stored, span);
+    EndTrace(TRACE_READ, started, copied);
+
+    started = BeginTrace();
+
+    for(i = first; i < last; ++i) {
+        DTA_ENTRY_INFO  info;
+        DWORD           fileSize    = index->fileSizes[i];
+        DWORD           offset      = index->dataOffsets[i] - start;
+        DWORD           storedSize  = 0;
+
+        GetEntryInfo(index, i, &info);
+
+        /* The end of the archive may cut the run short */
+        if(offset < copied)
+            storedSize = min(index->storedSizes[i], copied - offset);
+
+        if(DtaDecodeEntry(index->archive, &info, stored + offset, storedSize, buffer + valid, fileSize) < fileSize)
+            break;
+
+        valid += fileSize;
+    }
+
+    EndTrace(TRACE_DECRYPT, started, valid);
+
+    *read = valid;
+
+    return i;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the entries 'first' up to 'last' out of the run read into 'buffer'
+ * by ReadRun to 'data->sink'.
+ *--------------------------------------------------------------------------*/
+static void WriteRun(ARCHIVE_JOB *job, ENTRY_INDEX *index, DWORD first, DWORD last, char *buffer) {
+    APP_DATA    *data       = job->data;
+    DWORD       position    = 0;
+    DWORD       i;
+
+    for(i = first; i < last; ++i) {
+        DWORD               fileSize    = index->fileSizes[i];
+        char                *bytes      = buffer + position;
+        unsigned __int64    *hash;
+        __int64             started;
+
+        position += fileSize;
+
+        if((hash = GetManifestHash(job, index, i)) != NULL) {
+            started = BeginTrace();
+            *hash = Hash64(bytes, fileSize, 0);
+            EndTrace(TRACE_HASH, started, fileSize);
+        }
+
+        if(WriteSinkFile(&data->sink, ENTRY_NAME(index, i), bytes, fileSize, &job->failedFiles))
+            SetManifestWritten(job, index, i);
+        else
+            ReportFailedFile(job, ENTRY_NAME(index, i), "The file could not be written to the disk");
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'index', which must be sorted by file offset, in
+ * runs of neighbouring entries. If any errors occur, 'error' string is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive holding the entries
+ *                  index           Entries to extract
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesScheduled(ARCHIVE_JOB *job, ENTRY_INDEX *index, char error[ERROR_LENGTH]) {
+    APP_DATA        *data   = job->data;
+    BUF_CONTAINER   stored;
+    DWORD           first   = 0;
+
+    /* tmp.dll is asked for every file by its name */
+    if(!data->useNative) {
+        for(first = 0; first < index->count; ++first) {
+            if(ProcessFile(data, index, first, &data->buffer, GetManifestHash(job, index, first), error))
+                SetManifestWritten(job, index, first);
+            else
+                ReportFailedFile(job, ENTRY_NAME(index, first), error);
+        }
+
+        return TRUE;
+    }
+
+    if(!InitBuffer(&stored, 1024)) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    while(first < index->count) {
+        DWORD runSize;
+        DWORD runSpan;
+        DWORD nextSize;
+        DWORD nextSpan;
+        DWORD last = FindRun(index, first, data->streamWindow, &runSize, &runSpan);
+        DWORD broken;
+        DWORD read;
+
+        /* Let the system fetch the next run while this one is handled */
+        if(last < index->count) {
+            FindRun(index, last, data->streamWindow, &nextSize, &nextSpan);
+            DtaPrefetch(index->archive, index->dataOffsets[last], nextSpan);
+        }
+
+        if(runSize > data->streamWindow) {
+            /* A single entry larger than the window is streamed on its own */
+            if(ProcessFile(data, index, first, &data->buffer, GetManifestHash(job, index, first), error))
+                SetManifestWritten(job, index, first);
+            else
+                ReportFailedFile(job, ENTRY_NAME(index, first), error);
+        } else {
+            if(!ReserveBuffer(&data->buffer, max(runSize, 1)) || !ReserveBuffer(&stored, max(runSpan, 1))) {
+                strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+                ReleaseBuffer(&stored);
+                return FALSE;
+            }
+
+            broken = ReadRun(index, first, last, runSpan, stored.buf, data->buffer.buf, &read);
+
+            WriteRun(job, index, first, broken, data->buffer.buf);
+
+            /* The entries after a broken one start the next run */
+            if(broken < last) {
+                ReportFailedFile(job, ENTRY_NAME(index, broken), "A file inside the archive could not be decoded");
+                last = broken + 1;
+            }
+        }
+
+        first = last;
+    }
+
+    ReleaseBuffer(&stored);
+
+    return TRUE;
+}
@@ -0,0 +1,43 @@
+/*  Description:
+ *      Single-threaded extraction that reads the archive front to back in
+ *      large pieces. Neighbouring entries are merged into runs: a run starts
+ *      at the blocks of one entry and is extended over the following entries
+ *      as long as the gap between them (their headers and names, or data
+ *      that wasn't selected) is at most SCHEDULE_MAX_GAP bytes and the
+ *      decoded run fits into 'data->streamWindow'. The stored bytes of a run
+ *      are copied with a single DtaReadRaw, its entries are decoded out of
+ *      them one after the other by DtaDecodeEntry into one buffer, and
+ *      written out of it.
+ *
+ *      Without --native every file is streamed through tmp.dll by
+ *      ProcessFile instead, still in the order of the archive. Entries too
+ *      large for a run are streamed by ProcessFile as well. While a run is
+ *      being written, the stored bytes of the next one are handed to
+ *      DtaPrefetch.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <windows.h>
+#include "DTAFunctions.h"
+#include "EntryIndex.h"
+
+/* Largest number of unused bytes read to join two entries into one run */
+#define SCHEDULE_MAX_GAP    (64 * 1024)
+
+/*----------------------------------------------------------------------------
+ * Extracts every file in 'index', which must be sorted by file offset, in
+ * runs of neighbouring entries. If any errors occur, 'error' string is set
+ * and the function returns FALSE.
+ *
+ *  Arguments:      job             Archive holding the entries
+ *                  index           Entries to extract
+ *                  error           Error string
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessDTAFilesScheduled(ARCHIVE_JOB *job, ENTRY_INDEX *index, char error[ERROR_LENGTH]);
+
+#endif
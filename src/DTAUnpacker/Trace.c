@@ -0,0 +1,305 @@
+/*  Description:
+ *      Implementation of the phase timing. Each thread gets its counters the
+ *      first time it ends a phase, through thread local storage, and they are
+ *      kept in a list until StopTrace so that threads which are gone still
+ *      show up in the results.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Trace.h"
+
+/* Events a thread starts out with room for */
+#define TRACE_INITIAL_EVENTS    4096
+
+/*
+ * Totals of a single phase.
+ */
+typedef struct t_tracecounter {
+    unsigned __int64    calls;
+    unsigned __int64    bytes;
+    __int64             ticks;
+} TRACE_COUNTER;
+
+/*
+ * A single span, kept for the Chrome trace.
+ */
+typedef struct t_traceevent {
+    __int64             start;
+    __int64             duration;
+    unsigned __int64    bytes;
+    DWORD               phase;
+} TRACE_EVENT;
+
+/*
+ * Counters and spans of one thread.
+ */
+typedef struct t_tracethread {
+    DWORD                   threadId;
+    TRACE_COUNTER           counters[TRACE_PHASES];
+    TRACE_EVENT             *events;
+    DWORD                   numOfEvents;
+    DWORD                   maxEvents;
+    DWORD                   dropped;
+    struct t_tracethread    *next;
+} TRACE_THREAD;
+
+/*
+ * Timing of the whole run. Only the thread list is guarded by the lock,
+ * every thread writes to its own counters.
+ */
+static struct {
+    BOOL                enabled;
+    BOOL                keepEvents;
+    DWORD               tlsIndex;
+    CRITICAL_SECTION    lock;
+    TRACE_THREAD        *threads;
+    __int64             origin;
+    __int64             frequency;
+} trace = { FALSE, FALSE, 0 };
+
+static const char *phaseNames[TRACE_PHASES] = {
+    "open", "entries", "index", "directories", "extract", "file",
+    "read", "decrypt", "hash", "buffer", "create", "write"
+};
+
+/*----------------------------------------------------------------------------
+ * Returns the current value of the performance counter.
+ *--------------------------------------------------------------------------*/
+static __int64 ReadCounter(void) {
+    LARGE_INTEGER counter;
+
+    QueryPerformanceCounter(&counter);
+
+    return counter.QuadPart;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the counters of the calling thread, creating them the first time.
+ * Returns NULL if there is no memory for them.
+ *--------------------------------------------------------------------------*/
+static TRACE_THREAD *GetTraceThread(void) {
+    TRACE_THREAD *thread = (TRACE_THREAD *)TlsGetValue(trace.tlsIndex);
+
+    if(thread != NULL)
+        return thread;
+
+    if((thread = (TRACE_THREAD *)calloc(1, sizeof(TRACE_THREAD))) == NULL)
+        return NULL;
+
+    thread->threadId = GetCurrentThreadId();
+    TlsSetValue(trace.tlsIndex, thread);
+
+    EnterCriticalSection(&trace.lock);
+    thread->next    = trace.threads;
+    trace.threads   = thread;
+    LeaveCriticalSection(&trace.lock);
+
+    return thread;
+}
+
+/*----------------------------------------------------------------------------
+ * Keeps a span in the events of 'thread'. Spans that don't fit any more
+ * are only counted.
+ *--------------------------------------------------------------------------*/
+static void KeepEvent(TRACE_THREAD *thread, DWORD phase, __int64 started, __int64 duration, unsigned __int64 bytes) {
+    TRACE_EVENT *event;
+
+    if(thread->numOfEvents == thread->maxEvents) {
+        DWORD       maxEvents   = thread->maxEvents ? thread->maxEvents * 2 : TRACE_INITIAL_EVENTS;
+        TRACE_EVENT *events;
+
+        if(maxEvents > TRACE_MAX_EVENTS ||
+           (events = (TRACE_EVENT *)realloc(thread->events, sizeof(TRACE_EVENT) * maxEvents)) == NULL) {
+            ++thread->dropped;
+            return;
+        }
+
+        thread->events      = events;
+        thread->maxEvents   = maxEvents;
+    }
+
+    event = &thread->events[thread->numOfEvents++];
+
+    event->start    = started;
+    event->duration = duration;
+    event->bytes    = bytes;
+    event->phase    = phase;
+}
+
+/*----------------------------------------------------------------------------
+ * Turns the timing on. Returns FALSE if there is no memory for it.
+ *
+ *  Arguments:      keepEvents      Keep every span for WriteTrace
+ *--------------------------------------------------------------------------*/
+BOOL StartTrace(BOOL keepEvents) {
+    LARGE_INTEGER frequency;
+
+    if((trace.tlsIndex = TlsAlloc()) == TLS_OUT_OF_INDEXES)
+        return FALSE;
+
+    QueryPerformanceFrequency(&frequency);
+    InitializeCriticalSection(&trace.lock);
+
+    trace.frequency     = frequency.QuadPart;
+    trace.origin        = ReadCounter();
+    trace.keepEvents    = keepEvents;
+    trace.threads       = NULL;
+    trace.enabled       = TRUE;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the performance counter at the start of a phase, or 0 if the
+ * timing is off.
+ *--------------------------------------------------------------------------*/
+__int64 BeginTrace(void) {
+    return trace.enabled ? ReadCounter() : 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Ends a phase started with BeginTrace and adds it to the counters of the
+ * calling thread.
+ *
+ *  Arguments:      phase           TRACE_* of the phase
+ *                  started         Value returned by BeginTrace
+ *                  bytes           Bytes handled by the phase
+ *--------------------------------------------------------------------------*/
+void EndTrace(DWORD phase, __int64 started, unsigned __int64 bytes) {
+    TRACE_THREAD    *thread;
+    __int64         duration;
+
+    if(started == 0 || (thread = GetTraceThread()) == NULL)
+        return;
+
+    duration = ReadCounter() - started;
+
+    ++thread->counters[phase].calls;
+    thread->counters[phase].bytes += bytes;
+    thread->counters[phase].ticks += duration;
+
+    if(trace.keepEvents)
+        KeepEvent(thread, phase, started, duration, bytes);
+}
+
+/*----------------------------------------------------------------------------
+ * Prints the calls, bytes, time and throughput of every phase to stderr.
+ * The time of a phase is summed over all threads.
+ *--------------------------------------------------------------------------*/
+void PrintTraceStats(void) {
+    TRACE_COUNTER   totals[TRACE_PHASES];
+    TRACE_THREAD    *thread;
+    DWORD           numOfThreads    = 0;
+    DWORD           dropped         = 0;
+    DWORD           i;
+
+    if(!trace.enabled)
+        return;
+
+    memset(totals, 0, sizeof(totals));
+
+    for(thread = trace.threads; thread != NULL; thread = thread->next) {
+        for(i = 0; i < TRACE_PHASES; ++i) {
+            totals[i].calls += thread->counters[i].calls;
+            totals[i].bytes += thread->counters[i].bytes;
+            totals[i].ticks += thread->counters[i].ticks;
+        }
+
+        dropped += thread->dropped;
+        ++numOfThreads;
+    }
+
+    fprintf(stderr, "%-12s %10s %14s %10s %10s\n", "phase", "calls", "bytes", "time (s)", "MB/s");
+
+    for(i = 0; i < TRACE_PHASES; ++i) {
+        double seconds = (double)totals[i].ticks / (double)trace.frequency;
+
+        if(totals[i].calls == 0)
+            continue;
+
+        fprintf(stderr, "%-12s %10I64u %14I64u %10.3f ", phaseNames[i], totals[i].calls, totals[i].bytes, seconds);
+
+        if(totals[i].bytes > 0 && seconds > 0.0)
+            fprintf(stderr, "%10.1f\n", (double)totals[i].bytes / (1024.0 * 1024.0) / seconds);
+        else
+            fprintf(stderr, "%10s\n", "-");
+    }
+
+    fprintf(stderr, "%u threads, wall %.3fs\n", numOfThreads,
+            (double)(ReadCounter() - trace.origin) / (double)trace.frequency);
+
+    if(dropped > 0)
+        fprintf(stderr, "%u spans did not fit into the trace\n", dropped);
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the kept spans to 'filename' in the Chrome trace event format.
+ * Returns FALSE if the file could not be written.
+ *
+ *  Arguments:      filename        File to write
+ *--------------------------------------------------------------------------*/
+BOOL WriteTrace(const char *filename) {
+    TRACE_THREAD    *thread;
+    FILE            *file;
+    double          toMicroseconds;
+    BOOL            first = TRUE;
+    BOOL            result;
+
+    if(!trace.enabled || fopen_s(&file, filename, "w") != 0)
+        return FALSE;
+
+    toMicroseconds = 1000000.0 / (double)trace.frequency;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for(thread = trace.threads; thread != NULL; thread = thread->next) {
+        DWORD i;
+
+        /* Name the track of the thread */
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",", thread->threadId, thread->threadId);
+        first = FALSE;
+
+        for(i = 0; i < thread->numOfEvents; ++i) {
+            const TRACE_EVENT *event = &thread->events[i];
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bytes\":%I64u}}",
+                    phaseNames[event->phase], thread->threadId,
+                    (double)(event->start - trace.origin) * toMicroseconds,
+                    (double)event->duration * toMicroseconds, event->bytes);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    result = !ferror(file);
+
+    if(fclose(file) != 0)
+        result = FALSE;
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Turns the timing off and releases the counters and spans.
+ *--------------------------------------------------------------------------*/
+void StopTrace(void) {
+    if(!trace.enabled)
+        return;
+
+    trace.enabled = FALSE;
+
+    while(trace.threads != NULL) {
+        TRACE_THREAD *next = trace.threads->next;
+
+        free(trace.threads->events);
+        free(trace.threads);
+        trace.threads = next;
+    }
+
+    TlsFree(trace.tlsIndex);
+    DeleteCriticalSection(&trace.lock);
+}
@@ -0,0 +1,85 @@
+/*  Description:
+ *      Timing of the phases of a run, for --stats and --trace. A phase is
+ *      timed by taking the performance counter with BeginTrace before it and
+ *      handing it to EndTrace after it, along with the bytes it handled:
+ *
+ *          __int64 started = BeginTrace();
+ *          read = ReadEntryStream(&stream, buffer->buf, size);
+ *          EndTrace(TRACE_READ, started, read);
+ *
+ *      Every thread adds to counters of its own, which are only summed up
+ *      when the run is over, so threads never wait on each other. With
+ *      --trace every span is also kept as an event of a Chrome trace, which
+ *      chrome://tracing and Perfetto show as a timeline.
+ *
+ *      Until StartTrace is called, BeginTrace returns 0 without reading the
+ *      counter and EndTrace returns right away.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <windows.h>
+
+/* Phases of a run. Spans of the first ones contain spans of the later ones */
+#define TRACE_OPEN          0       /* ProcessDTAFile */
+#define TRACE_ENTRIES       1       /* Reading the entries through libdta */
+#define TRACE_INDEX         2       /* Building the entry index */
+#define TRACE_DIRECTORIES   3       /* Creating the directory tree */
+#define TRACE_EXTRACT       4       /* ProcessDTAFiles */
+#define TRACE_FILE          5       /* ProcessFile */
+#define TRACE_READ          6       /* Reading file data */
+#define TRACE_DECRYPT       7       /* Decrypting file data */
+#define TRACE_HASH          8       /* Hashing for the manifest */
+#define TRACE_BUFFER        9       /* Growing a buffer */
+#define TRACE_CREATE        10      /* Creating an output file */
+#define TRACE_WRITE         11      /* Writing file data */
+#define TRACE_PHASES        12
+
+/* Events kept for each thread, later spans are only counted */
+#define TRACE_MAX_EVENTS    (1024 * 1024)
+
+/*----------------------------------------------------------------------------
+ * Turns the timing on. Returns FALSE if there is no memory for it.
+ *
+ *  Arguments:      keepEvents      Keep every span for WriteTrace
+ *--------------------------------------------------------------------------*/
+BOOL StartTrace(BOOL keepEvents);
+
+/*----------------------------------------------------------------------------
+ * Returns the performance counter at the start of a phase, or 0 if the
+ * timing is off.
+ *--------------------------------------------------------------------------*/
+__int64 BeginTrace(void);
+
+/*----------------------------------------------------------------------------
+ * Ends a phase started with BeginTrace and adds it to the counters of the
+ * calling thread.
+ *
+ *  Arguments:      phase           TRACE_* of the phase
+ *                  started         Value returned by BeginTrace
+ *                  bytes           Bytes handled by the phase
+ *--------------------------------------------------------------------------*/
+void EndTrace(DWORD phase, __int64 started, unsigned __int64 bytes);
+
+/*----------------------------------------------------------------------------
+ * Prints the calls, bytes, time and throughput of every phase to stderr.
+ * The time of a phase is summed over all threads.
+ *--------------------------------------------------------------------------*/
+void PrintTraceStats(void);
+
+/*----------------------------------------------------------------------------
+ * Writes the kept spans to 'filename' in the Chrome trace event format.
+ * Returns FALSE if the file could not be written.
+ *
+ *  Arguments:      filename        File to write
+ *--------------------------------------------------------------------------*/
+BOOL WriteTrace(const char *filename);
+
+/*----------------------------------------------------------------------------
+ * Turns the timing off and releases the counters and spans.
+ *--------------------------------------------------------------------------*/
+void StopTrace(void);
+
+#endif
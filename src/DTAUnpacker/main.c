@@ -1,200 +1,638 @@
-/*  Description:
- *      The purpose of the program is to allow a user to extra .DTA files,
- *      found in Mafia and Hidden & Dangerous 2. The program allows the
- *      user to specify which file they want to load in, along with the two
- *      decryption keys needed.
- *
- *      Afterwards, the program is opens the DTA file using the DLL functions
- *      from "tmp.dll", and begins decrypting and extracting the files to the
- *      hard drive. A resizable buffer is used to keep memory consumption to a minimum.
- *
- *      After the extraction is completed, the program terminates and the user can
- *      browse the archive. A successful termination gives a return code of 0, otherwise
- *      returns -1 and an error message is printed to standard error.
- *
- *  Special thanks:
- *      MassaSnygga, "Accessing Mafias DTA files", http://www.kamalook.de/Mafia/DTA.html
- *      Lars
- *
- *  Author: Jovan Stanojlovic
- */
-
-#include <stdio.h>
-#include "main.h"
-#include "DTAFunctions.h"
-
-/*----------------------------------------------------------------------------
- * Main entry point. The three arguments that must be specified are:
- *
- *  argv[1] - DTA file
- *  argv[2] - first key (in hex)
- *  argv[3] - second key (in hex)
- *
- *  Returns 0 upon success, -1 otherwise and a message is printed to stderr.
- *--------------------------------------------------------------------------*/
-int main(int argc, char *argv[]) {
-    APP_DATA    data = { 0 };
-    char        error[ERROR_LENGTH];
-
-    if(argc != ARG_LENGTH) {
-        PrintUsage(argv[0]);
-
-        return -1;
-    }
-
-    if(!InitAppData(&data, error)) {
-        printf("Error occured: %s\nExiting...\n", error);
-
-        CleanupAppData(&data);
-        return -1;
-    }
-
-    /* Obtain command-line arguments */
-    strncpy_s(data.dtaFile, 256, argv[1], 256);
-    if(!(data.key1 = strtoul(argv[2], NULL, 16)) || !(data.key2 = strtoul(argv[3], NULL, 16))) {
-        fprintf(stderr, "Invalid keys provided\n");
-        return -1;
-    }
-
-    /* Main routine */
-    if(!ProcessDTAFile(&data, error)) {
-        printf("Error occured: %s\nExiting...\n", error);
-
-        CleanupAppData(&data);
-        return -1;
-    }
-
-    if(!ProcessDTAHeader(&data, error)) {
-        printf("Error occured: %s\nExiting...\n", error);
-
-        CleanupAppData(&data);
-        return -1;
-    }
-
-    if(!ProcessDTAFiles(&data, error)) {
-        printf("Error occured: %s\nExiting...\n", error);
-
-        CleanupAppData(&data);
-        return -1;
-    }
-
-    CleanupAppData(&data);
-
-    return 0;
-}
-
-
-/*----------------------------------------------------------------------------
- * Prints program usage to stderr.
- *
- *  Arguments:          name            Program name
- *--------------------------------------------------------------------------*/
-void PrintUsage(char *name) {
-    fprintf(stderr, "\nUsage: %s [.DTA FILE] [KEY1] [KEY2]\n", name);
-    fprintf(stderr, "Decrypts and unpacks a DTA \"ISD0\" archive using the keys provided.\n\n");
-    fprintf(stderr, "The keys used by Hidden & Dangerous 2 are:\n");
-    fprintf(stderr, "Archive\t\tKey1\t\tKey2\n");
-    fprintf(stderr, "-------\t\t----\t\t----\n");
-    fprintf(stderr, "Maps.dta\t0xF26527FA\t0xB438D0A5\n");
-    fprintf(stderr, "Missions.dta\t0x22BCDA98\t0x7654A3F0\n");
-    fprintf(stderr, "Models.dta\t0x10ACB252\t0x5D805259\n");
-    fprintf(stderr, "Others.dta\t0x65F7AB23\t0xEA85902A\n");
-    fprintf(stderr, "Sounds.dta\t0x8D2965CA\t0x4FE85106\n");
-    fprintf(stderr, "Scripts.dta\t0xCF761298\t0x0AB4E72D\n");
-    fprintf(stderr, "\nThe keys used by Mafia are:\n");
-    fprintf(stderr, "Archive\t\tKey1\t\tKey2\n");
-    fprintf(stderr, "-------\t\t----\t\t----\n");
-    fprintf(stderr, "A0.dta\t\t0xD8D0A975\t0x467ACDE0\n");
-    fprintf(stderr, "A1.dta\t\t0x3D98766C\t0xDE7009CD\n");
-    fprintf(stderr, "A2.dta\t\t0x82A1C97B\t0x2D5085D4\n");
-    fprintf(stderr, "A3.dta\t\t0x43876FEA\t0x900CDBA8\n");
-    fprintf(stderr, "A4.dta\t\t0x43876FEA\t0x900CDBA8\n");
-    fprintf(stderr, "A5.dta\t\t0xDEAC5342\t0x760CE652\n");
-    fprintf(stderr, "A6.dta\t\t0x64CD8D0A\t0x4BC97B2D\n");
-    fprintf(stderr, "A7.dta\t\t0xD6FEA900\t0xCDB76CE6\n");
-    fprintf(stderr, "A8.dta\t\t0xD8DD8FAC\t0x5324ACE5\n");
-    fprintf(stderr, "A9.dta\t\t0x6FEE6324\t0xACDA4783\n");
-    fprintf(stderr, "AA.dta\t\t0x5342760C\t0xEDEAC652\n");
-    fprintf(stderr, "AB.dta\t\t0xD8D0A975\t0x467ACDE0\n");
-    fprintf(stderr, "AC.dta\t\t0x43876FEA\t0x900CDBA8\n");
-}
-
-/*----------------------------------------------------------------------------
- * Initializes the APP_DATA structure that the program uses to manage keys
- * and function pointers. If an error occurs, the function returns FALSE and
- * 'error' is set to indicate the problem.
- *
- *  Arguments:          data            Pointer to the structure
- *                      error           Error message
- *
- *  Returns TRUE if successfully initialized, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL InitAppData(APP_DATA *data, char error[ERROR_LENGTH]) {
-    /* Attempt to load the DLL first */
-    data->hDTADLL = LoadLibrary("tmp.dll");
-
-    if(data->hDTADLL == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "tmp.dll could not be loaded correctly", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    /* Initialize the buffer with a starting 1024 bytes */
-    InitBuffer(&data->buffer, 1024);
-
-    /* Attempt to load functions */
-   if(!LoadFunctions(data, error))
-       return FALSE;
-
-    return TRUE;
-}
-
-/*--------------------------------------------------------------------------
- * Loads the dta* functions found inside of the DLL file. If any error occur,
- * the 'error' string is set, and FALSE is returned.
- *
- *  Arguments:          data            Pointer to the structure
- *                      error           Error message
- *
- *  Returns TRUE if successfully loaded, FALSE otherwise.
- *-------------------------------------------------------------------------*/
-BOOL LoadFunctions(APP_DATA *data, char error[ERROR_LENGTH]) {
-    data->dtaSetDtaFirstForce   = (FPDtaSetDtaFirstForce)GetProcAddress(data->hDTADLL, FUNC_DTASETDTAFIRSTFORCE);
-    data->dtaCreate             = (FPDtaCreate)GetProcAddress(data->hDTADLL, FUNC_DTACREATE);
-    data->dtaOpen               = (FPDtaOpen)GetProcAddress(data->hDTADLL, FUNC_DTAOPEN);
-    data->dtaRead               = (FPDtaRead)GetProcAddress(data->hDTADLL, FUNC_DTAREAD);
-    data->dtaClose              = (FPDtaClose)GetProcAddress(data->hDTADLL, FUNC_DTACLOSE);
-    data->dtaSeek               = (FPDtaSeek)GetProcAddress(data->hDTADLL, FUNC_DTASEEK);
-
-    if(data->dtaSetDtaFirstForce == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaSetDtaFirstForce() function not found", ERROR_LENGTH);
-        return FALSE;
-    } else if(data->dtaCreate == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaCreate() function not found", ERROR_LENGTH);
-        return FALSE;
-    } else if(data->dtaOpen == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaOpen() function not found", ERROR_LENGTH);
-        return FALSE;
-    } else if(data->dtaRead == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaRead() function not found", ERROR_LENGTH);
-        return FALSE;
-    } else if(data->dtaClose == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaClose() function not found", ERROR_LENGTH);
-        return FALSE;
-    } else if(data->dtaSeek == NULL) {
-        strncpy_s(error, ERROR_LENGTH, "dtaSeek() function not found", ERROR_LENGTH);
-        return FALSE;
-    }
-
-    return TRUE;
-}
-
-/*----------------------------------------------------------------------------
- * Cleans up the APP_DATA structure, closing the DLL handle and deleting the
- * list of keys.
- *
- *  Arguments:          data            Pointer to the structure
- *--------------------------------------------------------------------------*/
-void CleanupAppData(APP_DATA *data) {
-    ReleaseBuffer(&data->buffer);
-    FreeLibrary(data->hDTADLL);
-}
+/*  Description:
+ *      The purpose of the program is to allow a user to extra .DTA files,
+ *      found in Mafia and Hidden & Dangerous 2. The program allows the
+ *      user to specify which file they want to load in, along with the two
+ *      decryption keys needed.
+ *
+ *      Afterwards, the program is opens the DTA file through libdta (see Dta.h)
+ *      and reads the files either with the DLL functions from "tmp.dll" or
+ *      through libdta as well, and begins decrypting and extracting the files to the hard drive. A
+ *      resizable buffer is used to keep memory consumption to a minimum.
+ *
+ *      After the extraction is completed, the program terminates and the user can
+ *      browse the archive. A successful termination gives a return code of 0, otherwise
+ *      returns -1 and an error message is printed to standard error.
+ *
+ *  Special thanks:
+ *      MassaSnygga, "Accessing Mafias DTA files", http://www.kamalook.de/Mafia/DTA.html
+ *      Lars
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "DTAFunctions.h"
+#include "EntryIndex.h"
+#include "Manifest.h"
+#include "Parallel.h"
+#include "Pipeline.h"
+#include "List.h"
+#include "KeyDetect.h"
+#include "Compare.h"
+#include "Trace.h"
+#include "BufferPool.h"
+
+/*----------------------------------------------------------------------------
+ * Main entry point. Options may be given first, followed by the three
+ * arguments that must be specified:
+ *
+ *  DTA file
+ *  first key (in hex)
+ *  second key (in hex)
+ *
+ *  The keys may be left out, they are then looked for in the key table.
+ *  With --batch DIR no arguments are given at all.
+ *
+ *  Returns 0 upon success, -1 otherwise and a message is printed to stderr.
+ *--------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+    APP_DATA            data = { 0 };
+    ARCHIVE_JOB         job = { 0 };
+    char                error[ERROR_LENGTH];
+    int                 argIndex;
+    int                 numOfArgs;
+    const ARCHIVE_KEYS  *keys = NULL;
+    BOOL                result;
+
+    argIndex    = ParseOptions(&data, argc, argv);
+    numOfArgs   = argc - argIndex;
+
+    if(argIndex < 0 || (data.batchDir != NULL ? numOfArgs != 0 : numOfArgs != ARG_LENGTH - 1 && numOfArgs != 1)) {
+        PrintUsage(argv[0]);
+
+        return -1;
+    }
+
+    /* Without keys, try every pair on the header */
+    if(data.batchDir == NULL && numOfArgs == 1) {
+        if((keys = DetectArchiveKeys(argv[argIndex], error)) == NULL) {
+            fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+            return -1;
+        }
+
+        fprintf(stderr, "Using the keys of %s from %s\n", keys->archive, keys->game);
+    }
+
+    /* Obtain command-line arguments */
+    if(data.batchDir == NULL) {
+        job.data = &data;
+        strncpy_s(job.dtaFile, 256, argv[argIndex], 256);
+
+        if(keys != NULL) {
+            job.key1 = keys->key1;
+            job.key2 = keys->key2;
+        } else if(!(job.key1 = strtoul(argv[argIndex + 1], NULL, 16)) || !(job.key2 = strtoul(argv[argIndex + 2], NULL, 16))) {
+            fprintf(stderr, "Invalid keys provided\n");
+            return -1;
+        }
+    }
+
+    /* Every buffer of the run is leased from the pool */
+    if(!StartBufferPool())
+        fprintf(stderr, "The buffer pool could not be started, buffers are allocated directly\n");
+
+    if(data.largePages && !EnableLargePages())
+        fprintf(stderr, "Large pages need the \"Lock pages in memory\" right, using normal pages\n");
+
+    if(!InitAppData(&data, error)) {
+        fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+
+        CleanupAppData(&data);
+        return -1;
+    }
+
+    if((data.printStats || data.traceFile != NULL) && !StartTrace(data.traceFile != NULL))
+        fprintf(stderr, "The timing could not be turned on\n");
+
+    /* Main routine */
+    if(data.batchDir != NULL)
+        result = ProcessBatch(&data, error);
+    else
+        result = ProcessArchive(&job, error);
+
+    if(data.printStats) {
+        PrintTraceStats();
+        PrintBufferPoolStats();
+        PrintFileWriterStats(data.sink.writer);
+    }
+
+    if(data.traceFile != NULL && !WriteTrace(data.traceFile))
+        fprintf(stderr, "The trace could not be written to %s\n", data.traceFile);
+
+    if(!result) {
+        fprintf(stderr, "Error occured: %s\nExiting...\n", error);
+
+        CleanupAppData(&data);
+        return -1;
+    }
+
+    CleanupAppData(&data);
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Opens the archive named in 'job->dtaFile' with the keys in 'job', and
+ * either lists or extracts its files. If any errors occur, 'error' string
+ * is set and the function returns FALSE.
+ *
+ *  Arguments:          job             Archive to process
+ *                      error           Error message
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessArchive(ARCHIVE_JOB *job, char error[ERROR_LENGTH]) {
+    APP_DATA    *data   = job->data;
+    __int64     started = BeginTrace();
+    BOOL        result  = ProcessDTAFile(job, error);
+
+    EndTrace(TRACE_OPEN, started, 0);
+
+    if(!result)
+        return FALSE;
+
+    /* Either list the files or extract them */
+    if(data->compareNative) {
+        result = CompareWithNative(job, error);
+    } else if(data->listFormat != LIST_NONE) {
+        result = ListDTAFiles(job, error);
+    } else {
+        started = BeginTrace();
+        result  = ProcessDTAFiles(job, error);
+        EndTrace(TRACE_EXTRACT, started, 0);
+    }
+
+    CloseDTAFile(job);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Extracts the 'count' archives of 'jobs' side by side: all of them are
+ * opened, and their entries go to the same -j workers at once. The jobs of
+ * the archives that open are moved to the front of 'jobs'. Returns the
+ * number of archives that failed, which are reported to stderr.
+ *
+ *  Arguments:          jobs            Archives to extract
+ *                      keys            Key table entry of every job
+ *                      count           Number of jobs
+ *--------------------------------------------------------------------------*/
+static DWORD ExtractArchivesTogether(ARCHIVE_JOB *jobs, const ARCHIVE_KEYS **keys, DWORD count) {
+    APP_DATA    *data       = jobs[0].data;
+    ENTRY_INDEX *indexes    = (ENTRY_INDEX *)malloc(sizeof(ENTRY_INDEX) * count);
+    MANIFEST    *manifests  = (MANIFEST *)malloc(sizeof(MANIFEST) * count);
+    char        error[ERROR_LENGTH] = "";
+    DWORD       ready       = 0;
+    DWORD       failed      = 0;
+    DWORD       i;
+    __int64     started;
+    BOOL        result;
+
+    if(indexes == NULL || manifests == NULL) {
+        fprintf(stderr, "Could not allocate memory for the archives\n");
+        free(indexes);
+        free(manifests);
+        return count;
+    }
+
+    for(i = 0; i < count; ++i) {
+        ARCHIVE_JOB *job = &jobs[ready];
+
+        /* The job keeps pointing at its index and manifest, so it moves first */
+        if(ready != i) {
+            *job        = jobs[i];
+            keys[ready] = keys[i];
+        }
+
+        fprintf(stderr, "%s: %s\n", keys[ready]->game, keys[ready]->archive);
+
+        started = BeginTrace();
+        result  = ProcessDTAFile(job, error);
+        EndTrace(TRACE_OPEN, started, 0);
+
+        if(!result) {
+            fprintf(stderr, "Error occured in %s: %s\n", keys[ready]->archive, error);
+            ++failed;
+            continue;
+        }
+
+        if(!PrepareExtraction(job, &indexes[ready], &manifests[ready], error)) {
+            fprintf(stderr, "Error occured in %s: %s\n", keys[ready]->archive, error);
+            CloseDTAFile(job);
+            ++failed;
+            continue;
+        }
+
+        ++ready;
+    }
+
+    if(ready > 0) {
+        started = BeginTrace();
+        result  = ProcessDTAFilesParallel(jobs, indexes, ready, error);
+        EndTrace(TRACE_EXTRACT, started, 0);
+
+        /* Small files may still be queued for the writer threads */
+        FlushSink(&data->sink);
+    }
+
+    for(i = 0; i < ready; ++i) {
+        char archiveError[ERROR_LENGTH];
+
+        strncpy_s(archiveError, ERROR_LENGTH, error, _TRUNCATE);
+
+        if(!FinishExtraction(&jobs[i], &indexes[i], &manifests[i], result, archiveError)) {
+            fprintf(stderr, "Error occured in %s: %s\n", keys[i]->archive, archiveError);
+            ++failed;
+        }
+
+        CloseDTAFile(&jobs[i]);
+    }
+
+    free(indexes);
+    free(manifests);
+
+    return failed;
+}
+
+/*----------------------------------------------------------------------------
+ * Processes every archive of the key table that exists in 'data->batchDir',
+ * with the DLL, the buffers and the directory cache set up once for all of
+ * them. An archive that fails is reported and the rest are still
+ * processed. If any errors occur, 'error' string is set and the function
+ * returns FALSE.
+ *
+ * With --native and -j the archives are extracted side by side: the -j
+ * workers take the files of all of them from one queue, and --budget
+ * limits the memory of all workers together. The archives of a game hold
+ * different files; should two share an output name while both are being
+ * written, the second can't be created and is reported. tmp.dll keeps the
+ * state of a single archive, so without --native, and for --list and
+ * --compare, the archives are processed one after the other.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if every archive was processed, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessBatch(APP_DATA *data, char error[ERROR_LENGTH]) {
+    const ARCHIVE_KEYS  *archives;
+    const ARCHIVE_KEYS  **keys;
+    ARCHIVE_JOB         *jobs;
+    DWORD               count;
+    DWORD               found   = 0;
+    DWORD               failed  = 0;
+    DWORD               i;
+    BOOL                extract = data->listFormat == LIST_NONE && !data->compareNative;
+
+    archives    = GetKnownArchives(&count);
+    jobs        = (ARCHIVE_JOB *)calloc(count, sizeof(ARCHIVE_JOB));
+    keys        = (const ARCHIVE_KEYS **)malloc(sizeof(ARCHIVE_KEYS *) * count);
+
+    if(jobs == NULL || keys == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "Could not allocate memory for the archives", ERROR_LENGTH);
+        free(jobs);
+        free((void *)keys);
+        return FALSE;
+    }
+
+    for(i = 0; i < count; ++i) {
+        ARCHIVE_JOB *job = &jobs[found];
+
+        _snprintf(job->dtaFile, sizeof(job->dtaFile) - 1, "%s\\%s", data->batchDir, archives[i].archive);
+        job->dtaFile[sizeof(job->dtaFile) - 1] = '\0';
+
+        if(GetFileAttributes(job->dtaFile) == INVALID_FILE_ATTRIBUTES)
+            continue;
+
+        job->data   = data;
+        job->key1   = archives[i].key1;
+        job->key2   = archives[i].key2;
+        keys[found] = &archives[i];
+        ++found;
+    }
+
+    if(found == 0) {
+        strncpy_s(error, ERROR_LENGTH, "No known archives were found in the directory", ERROR_LENGTH);
+        free(jobs);
+        free((void *)keys);
+        return FALSE;
+    }
+
+    if(extract && data->useNative && data->numOfThreads > 1) {
+        failed = ExtractArchivesTogether(jobs, keys, found);
+    } else {
+        for(i = 0; i < found; ++i) {
+            char archiveError[ERROR_LENGTH];
+
+            fprintf(stderr, "%s: %s\n", keys[i]->game, keys[i]->archive);
+
+            if(!ProcessArchive(&jobs[i], archiveError)) {
+                fprintf(stderr, "Error occured in %s: %s\n", keys[i]->archive, archiveError);
+                ++failed;
+            }
+        }
+    }
+
+    free(jobs);
+    free((void *)keys);
+
+    if(failed > 0) {
+        strncpy_s(error, ERROR_LENGTH, "Some of the archives could not be processed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Prints program usage to stderr.
+ *
+ *  Arguments:          name            Program name
+ *--------------------------------------------------------------------------*/
+void PrintUsage(char *name) {
+    const ARCHIVE_KEYS  *archives;
+    const char          *game = NULL;
+    DWORD               count;
+    DWORD               i;
+
+    fprintf(stderr, "\nUsage: %s [OPTIONS] [.DTA FILE] [KEY1] [KEY2]\n", name);
+    fprintf(stderr, "       %s [OPTIONS] --batch DIR\n", name);
+    fprintf(stderr, "Decrypts and unpacks a DTA \"ISD0\" archive using the keys provided.\n");
+    fprintf(stderr, "The keys can be left out for the archives listed below.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "--native\tRead the archive directly instead of going through tmp.dll\n");
+    fprintf(stderr, "-j N\t\tExtract N files at the same time, 0 uses every processor (needs --native)\n");
+    fprintf(stderr, "--split MB\tSplit files of at least MB megabytes across the -j threads (%d)\n", DEFAULT_SPLIT_THRESHOLD / (1024 * 1024));
+    fprintf(stderr, "\t\t0 turns splitting off. Splitting needs --native and -j.\n");
+    fprintf(stderr, "--pipeline\tOverlap reading, decrypting and writing (needs --native)\n");
+    fprintf(stderr, "--depth N\tNumber of buffers in the pipeline (%d)\n", PIPELINE_DEFAULT_DEPTH);
+    fprintf(stderr, "--budget MB\tMemory the pipeline or the -j workers may use for file data (%d)\n", PIPELINE_DEFAULT_BUDGET / (1024 * 1024));
+    fprintf(stderr, "--include PAT\tOnly extract files matching PAT, may be repeated\n");
+    fprintf(stderr, "--exclude PAT\tSkip files matching PAT, may be repeated\n");
+    fprintf(stderr, "\t\tPatterns use ? and *, ** also crosses directories.\n");
+    fprintf(stderr, "--window KB\tLargest piece of a file held in memory (%d)\n", DEFAULT_STREAM_WINDOW / 1024);
+    fprintf(stderr, "--list\t\tPrint the files in the archive instead of extracting them\n");
+    fprintf(stderr, "--json\t\tLike --list, but prints JSON\n");
+    fprintf(stderr, "--no-index\tDon't read or write the .dtaidx file next to the archive\n");
+    fprintf(stderr, "--tar FILE\tWrite the files into a tar archive instead, - writes to stdout\n");
+    fprintf(stderr, "--incremental\tSkip the files a .dtamanifest shows as already extracted\n");
+    fprintf(stderr, "--batch DIR\tProcess every archive of the tables below found in DIR\n");
+    fprintf(stderr, "\t\tWith --native and -j the archives are extracted side by side.\n");
+    fprintf(stderr, "--compare\tList the files tmp.dll returns differently from --native\n");
+    fprintf(stderr, "--stats\t\tPrint the time spent in each phase of the run\n");
+    fprintf(stderr, "--trace FILE\tWrite a timeline of the run to FILE, for chrome://tracing\n");
+    fprintf(stderr, "--large-pages\tBack large buffers with large pages (needs \"Lock pages in memory\")\n");
+    fprintf(stderr, "--fsync\t\tFlush every file to the disk before closing it\n");
+
+    /* The key table, one block per game */
+    archives = GetKnownArchives(&count);
+
+    for(i = 0; i < count; ++i) {
+        if(game == NULL || strcmp(game, archives[i].game) != 0) {
+            game = archives[i].game;
+
+            fprintf(stderr, "\nThe keys used by %s are:\n", game);
+            fprintf(stderr, "Archive\t\tKey1\t\tKey2\n");
+            fprintf(stderr, "-------\t\t----\t\t----\n");
+        }
+
+        fprintf(stderr, "%s%s0x%08X\t0x%08X\n", archives[i].archive, strlen(archives[i].archive) < 8 ? "\t\t" : "\t",
+                archives[i].key1, archives[i].key2);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the options that precede the required arguments and stores them in
+ * 'data'. Returns the index of the first required argument, or -1 if an
+ * unknown option was given.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      argc            Argument count
+ *                      argv            Arguments
+ *--------------------------------------------------------------------------*/
+int ParseOptions(APP_DATA *data, int argc, char *argv[]) {
+    int     i;
+    BOOL    splitGiven = FALSE;
+
+    data->useNative         = DEFAULT_NATIVE;
+    data->numOfThreads      = 1;
+    data->splitThreshold    = DEFAULT_SPLIT_THRESHOLD;
+    data->pipelineDepth     = PIPELINE_DEFAULT_DEPTH;
+    data->pipelineBudget    = PIPELINE_DEFAULT_BUDGET;
+    data->useIndexCache     = TRUE;
+    data->streamWindow      = DEFAULT_STREAM_WINDOW;
+
+    for(i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if(strcmp(argv[i], "--native") == 0)
+            data->useNative = TRUE;
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            data->numOfThreads = strtoul(argv[++i], NULL, 10);
+
+            if(data->numOfThreads == 0)
+                data->numOfThreads = GetProcessorCount();
+        } else if(strcmp(argv[i], "--split") == 0 && i + 1 < argc) {
+            /* Given in megabytes, kept below 4 GB; 0 turns splitting off */
+            data->splitThreshold = strtoul(argv[++i], NULL, 10);
+            data->splitThreshold = min(data->splitThreshold, 4095) * 1024 * 1024;
+            splitGiven = TRUE;
+        } else if(strcmp(argv[i], "--pipeline") == 0)
+            data->usePipeline = TRUE;
+        else if(strcmp(argv[i], "--depth") == 0 && i + 1 < argc)
+            data->pipelineDepth = strtoul(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            /* Given in megabytes, kept below 2 GB */
+            data->pipelineBudget = strtoul(argv[++i], NULL, 10);
+            data->pipelineBudget = min(data->pipelineBudget, 1024) * 1024 * 1024;
+        } else if(strcmp(argv[i], "--include") == 0 && i + 1 < argc && data->numOfIncludes < MAX_PATTERNS)
+            data->includes[data->numOfIncludes++] = argv[++i];
+        else if(strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            /* Given in kilobytes, kept between 4 KB and 1 GB */
+            data->streamWindow = strtoul(argv[++i], NULL, 10);
+            data->streamWindow = max(4, min(data->streamWindow, 1024 * 1024)) * 1024;
+        } else if(strcmp(argv[i], "--list") == 0)
+            data->listFormat = LIST_TEXT;
+        else if(strcmp(argv[i], "--json") == 0)
+            data->listFormat = LIST_JSON;
+        else if(strcmp(argv[i], "--no-index") == 0)
+            data->useIndexCache = FALSE;
+        else if(strcmp(argv[i], "--tar") == 0 && i + 1 < argc)
+            data->tarFile = argv[++i];
+        else if(strcmp(argv[i], "--incremental") == 0)
+            data->useManifest = TRUE;
+        else if(strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            data->batchDir = argv[++i];
+        else if(strcmp(argv[i], "--compare") == 0)
+            data->compareNative = TRUE;
+        else if(strcmp(argv[i], "--stats") == 0)
+            data->printStats = TRUE;
+        else if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            data->traceFile = argv[++i];
+        else if(strcmp(argv[i], "--large-pages") == 0)
+            data->largePages = TRUE;
+        else if(strcmp(argv[i], "--fsync") == 0)
+            data->flushFiles = TRUE;
+        else if(strcmp(argv[i], "--exclude") == 0 && i + 1 < argc && data->numOfExcludes < MAX_PATTERNS)
+            data->excludes[data->numOfExcludes++] = argv[++i];
+        else
+            return -1;
+    }
+
+    /* tmp.dll keeps a single stream position, so it can only be used by one thread */
+    if(data->numOfThreads > 1 && !data->useNative)
+        fprintf(stderr, "-j requires --native, extracting with a single thread\n");
+
+    /* Only the -j workers of the native backend split files */
+    if(splitGiven && data->splitThreshold != 0 && (!data->useNative || data->numOfThreads < 2))
+        fprintf(stderr, "--split only applies with --native and -j, files are not split\n");
+
+    if(data->usePipeline && !data->useNative)
+        fprintf(stderr, "--pipeline requires --native, extracting without it\n");
+
+    /* A tar stream is written one entry after the other */
+    if(data->tarFile != NULL && data->numOfThreads > 1) {
+        fprintf(stderr, "-j can't be used with --tar, extracting with a single thread\n");
+        data->numOfThreads = 1;
+    }
+
+    /* A single tar stream can't hold several archives */
+    if(data->tarFile != NULL && data->batchDir != NULL) {
+        fprintf(stderr, "--batch can't be used with --tar\n");
+        return -1;
+    }
+
+    /* The comparison reads every entry through tmp.dll */
+    if(data->compareNative && data->useNative) {
+        fprintf(stderr, "--compare needs tmp.dll, it can't be used with --native or in 64-bit builds\n");
+        return -1;
+    }
+
+    /* A manifest only knows about files on the disk */
+    if(data->tarFile != NULL && data->useManifest) {
+        fprintf(stderr, "--incremental can't be used with --tar, extracting everything\n");
+        data->useManifest = FALSE;
+    }
+
+    return i;
+}
+
+/*----------------------------------------------------------------------------
+ * Initializes the APP_DATA structure that the program uses to manage keys
+ * and function pointers. If an error occurs, the function returns FALSE and
+ * 'error' is set to indicate the problem.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if successfully initialized, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL InitAppData(APP_DATA *data, char error[ERROR_LENGTH]) {
+    BOOL    extract         = data->listFormat == LIST_NONE && !data->compareNative;
+    DWORD   writerThreads   = WRITER_DEFAULT_THREADS;
+
+    /* Pick the decryption kernel for this CPU */
+    InitDecrypt();
+
+    /* With -j every worker writes its own files already */
+    if(!extract || (data->numOfThreads > 1 && data->useNative))
+        writerThreads = 0;
+
+    if(!InitDirCache(&data->dirCache)) {
+        strncpy_s(error, ERROR_LENGTH, "Allocating memory for the directory cache failed", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* Listing never writes anything */
+    if(!OpenSink(&data->sink, data->listFormat == LIST_NONE ? data->tarFile : NULL, &data->dirCache, writerThreads, data->flushFiles)) {
+        strncpy_s(error, ERROR_LENGTH, "The tar file could not be created", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* libdta reads everything, the DLL isn't needed at all */
+    if(data->useNative) {
+        if(!InitBuffer(&data->buffer, 1024)) {
+            strncpy_s(error, ERROR_LENGTH, "Allocating memory for a buffer failed", ERROR_LENGTH);
+            return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    /* Attempt to load the DLL first */
+    data->hDTADLL = LoadLibrary("tmp.dll");
+
+    if(data->hDTADLL == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "tmp.dll could not be loaded correctly", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* Initialize the buffer with a starting 1024 bytes */
+    InitBuffer(&data->buffer, 1024);
+
+    /* Attempt to load functions */
+   if(!LoadFunctions(data, error))
+       return FALSE;
+
+    return TRUE;
+}
+
+/*--------------------------------------------------------------------------
+ * Loads the dta* functions found inside of the DLL file. If any error occur,
+ * the 'error' string is set, and FALSE is returned.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if successfully loaded, FALSE otherwise.
+ *-------------------------------------------------------------------------*/
+BOOL LoadFunctions(APP_DATA *data, char error[ERROR_LENGTH]) {
+    data->dtaSetDtaFirstForce   = (FPDtaSetDtaFirstForce)GetProcAddress(data->hDTADLL, FUNC_DTASETDTAFIRSTFORCE);
+    data->dtaCreate             = (FPDtaCreate)GetProcAddress(data->hDTADLL, FUNC_DTACREATE);
+    data->dtaOpen               = (FPDtaOpen)GetProcAddress(data->hDTADLL, FUNC_DTAOPEN);
+    data->dtaRead               = (FPDtaRead)GetProcAddress(data->hDTADLL, FUNC_DTAREAD);
+    data->dtaClose              = (FPDtaClose)GetProcAddress(data->hDTADLL, FUNC_DTACLOSE);
+    data->dtaSeek               = (FPDtaSeek)GetProcAddress(data->hDTADLL, FUNC_DTASEEK);
+    data->dtaSetKeys            = DllSetKeys;
+
+    if(data->dtaSetDtaFirstForce == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaSetDtaFirstForce() function not found", ERROR_LENGTH);
+        return FALSE;
+    } else if(data->dtaCreate == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaCreate() function not found", ERROR_LENGTH);
+        return FALSE;
+    } else if(data->dtaOpen == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaOpen() function not found", ERROR_LENGTH);
+        return FALSE;
+    } else if(data->dtaRead == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaRead() function not found", ERROR_LENGTH);
+        return FALSE;
+    } else if(data->dtaClose == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaClose() function not found", ERROR_LENGTH);
+        return FALSE;
+    } else if(data->dtaSeek == NULL) {
+        strncpy_s(error, ERROR_LENGTH, "dtaSeek() function not found", ERROR_LENGTH);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Cleans up the APP_DATA structure, closing the DLL handle and deleting the
+ * list of keys.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *--------------------------------------------------------------------------*/
+void CleanupAppData(APP_DATA *data) {
+    ReleaseBuffer(&data->buffer);
+    CloseSink(&data->sink);
+    StopTrace();
+    StopBufferPool();
+
+    if(data->dirCache.slots != NULL)
+        ReleaseDirCache(&data->dirCache);
+
+    if(data->hDTADLL != NULL)
+        FreeLibrary(data->hDTADLL);
+}
@@ -1,54 +1,111 @@
-/*  Description:
- *      Declarations of functions that are used in conjugation with the APP_DATA
- *      struct. The struct is used to avoid too many global variables, and
- *      contains function pointers to the DLL functions, amongs other things.
- *
- *  Author: Jovan Stanojlovic
- */
-#ifndef MAIN_H_
-#define MAIN_H_
-
-#include "DTAFunctions.h"
-
-/* Number of required arguments */
-#define ARG_LENGTH      4
-
-/*----------------------------------------------------------------------------
- * Prints program usage to stderr.
- *
- *  Arguments:          name            Program name
- *--------------------------------------------------------------------------*/
-void PrintUsage(char *name);
-
-/*----------------------------------------------------------------------------
- * Initializes the APP_DATA structure that the program uses to manage keys
- * and function pointers. If an error occurs, the function returns FALSE and
- * 'error' is set to indicate the problem.
- *
- *  Arguments:          data            Pointer to the structure
- *                      error           Error message
- *
- *  Returns TRUE if successfully initialized, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL InitAppData(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*----------------------------------------------------------------------------
- * Loads the dta* functions found inside of the DLL file. If any error occur,
- * the 'error' string is set, and FALSE is returned.
- *
- *  Arguments:          data            Pointer to the structure
- *                      error           Error message
- *
- *  Returns TRUE if successfully loaded, FALSE otherwise.
- *--------------------------------------------------------------------------*/
-BOOL LoadFunctions(APP_DATA *data, char error[ERROR_LENGTH]);
-
-/*----------------------------------------------------------------------------
- * Cleans up the APP_DATA structure, closing the DLL handle and deleting the
- * list of keys.
- *
- *  Arguments:          data            Pointer to the structure
- *--------------------------------------------------------------------------*/
-void CleanupAppData(APP_DATA *data);
-
-#endif
+/*  Description:
+ *      Declarations of functions that are used in conjugation with the APP_DATA
+ *      struct. The struct is used to avoid too many global variables, and
+ *      contains function pointers to the DLL functions, amongs other things.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef MAIN_H_
+#define MAIN_H_
+
+#include "DTAFunctions.h"
+
+/* Number of required arguments */
+#define ARG_LENGTH      4
+
+/*
+ * tmp.dll only exists as 32-bit code, so 64-bit builds are always native. The
+ * native reader decodes every kind of block tmp.dll does (see Decode.h), and
+ * a file it can't decode is reported and fails the run instead of being
+ * written as it is stored.
+ */
+#ifdef _WIN64
+#define DEFAULT_NATIVE  TRUE
+#else
+#define DEFAULT_NATIVE  FALSE
+#endif
+
+/*----------------------------------------------------------------------------
+ * Opens the archive named in 'job->dtaFile' with the keys in 'job', and
+ * either lists or extracts its files. If any errors occur, 'error' string
+ * is set and the function returns FALSE.
+ *
+ *  Arguments:          job             Archive to process
+ *                      error           Error message
+ *
+ *  Returns TRUE on success, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessArchive(ARCHIVE_JOB *job, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Processes every archive of the key table that exists in 'data->batchDir',
+ * with the DLL, the buffers and the directory cache set up once for all of
+ * them. An archive that fails is reported and the rest are still
+ * processed. If any errors occur, 'error' string is set and the function
+ * returns FALSE.
+ *
+ * With --native and -j the archives are extracted side by side: the -j
+ * workers take the files of all of them from one queue, and --budget
+ * limits the memory of all workers together. The archives of a game hold
+ * different files; should two share an output name while both are being
+ * written, the second can't be created and is reported. tmp.dll keeps the
+ * state of a single archive, so without --native, and for --list and
+ * --compare, the archives are processed one after the other.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if every archive was processed, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL ProcessBatch(APP_DATA *data, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Prints program usage to stderr.
+ *
+ *  Arguments:          name            Program name
+ *--------------------------------------------------------------------------*/
+void PrintUsage(char *name);
+
+/*----------------------------------------------------------------------------
+ * Reads the options that precede the required arguments and stores them in
+ * 'data'. Returns the index of the first required argument, or -1 if an
+ * unknown option was given.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      argc            Argument count
+ *                      argv            Arguments
+ *--------------------------------------------------------------------------*/
+int ParseOptions(APP_DATA *data, int argc, char *argv[]);
+
+/*----------------------------------------------------------------------------
+ * Initializes the APP_DATA structure that the program uses to manage keys
+ * and function pointers. If an error occurs, the function returns FALSE and
+ * 'error' is set to indicate the problem.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if successfully initialized, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL InitAppData(APP_DATA *data, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Loads the dta* functions found inside of the DLL file. If any error occur,
+ * the 'error' string is set, and FALSE is returned.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *                      error           Error message
+ *
+ *  Returns TRUE if successfully loaded, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL LoadFunctions(APP_DATA *data, char error[ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Cleans up the APP_DATA structure, closing the DLL handle and deleting the
+ * list of keys.
+ *
+ *  Arguments:          data            Pointer to the structure
+ *--------------------------------------------------------------------------*/
+void CleanupAppData(APP_DATA *data);
+
+#endif
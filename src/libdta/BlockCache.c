@@ -0,0 +1,290 @@
+/*  Description:
+ *      Implementation of the block cache. Blocks live in one allocation and
+ *      are found through a hash table keyed by the entry and the block
+ *      number. A list ordered by last use, newest first, picks the block to
+ *      replace.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "BlockCache.h"
+
+/* Marks the end of a list, and a bucket without blocks */
+#define CACHE_NONE  0xFFFFFFFF
+
+/*
+ * A cached block. Entries are told apart by the offset of their data, which
+ * is unique inside an archive.
+ */
+typedef struct t_cacheblock {
+    DWORD   dataOffset;
+    DWORD   index;              /* Block number inside the entry */
+    DWORD   length;             /* Shorter than a block at the end of an entry */
+    DWORD   nextInBucket;
+    DWORD   newer;
+    DWORD   older;
+} CACHE_BLOCK;
+
+struct t_dtablockcache {
+    const DTA_ARCHIVE   *archive;
+    CRITICAL_SECTION    lock;
+
+    char                *data;
+    CACHE_BLOCK         *blocks;
+    DWORD               *buckets;
+    DWORD               numOfBuckets;       /* Power of two */
+    DWORD               blockSize;
+    DWORD               numOfBlocks;
+    DWORD               usedBlocks;
+
+    DWORD               newest;
+    DWORD               oldest;
+
+    unsigned __int64    hits;
+    unsigned __int64    misses;
+};
+
+/*----------------------------------------------------------------------------
+ * Returns the bucket of the block 'index' of the entry at 'dataOffset'.
+ *--------------------------------------------------------------------------*/
+static DWORD GetBucket(const DTA_BLOCK_CACHE *cache, DWORD dataOffset, DWORD index) {
+    DWORD hash = (dataOffset ^ (index * 0x9E3779B9)) * 0x85EBCA6B;
+
+    return (hash ^ (hash >> 16)) & (cache->numOfBuckets - 1);
+}
+
+/*----------------------------------------------------------------------------
+ * Removes block 'slot' from the list ordered by use.
+ *--------------------------------------------------------------------------*/
+static void Unlink(DTA_BLOCK_CACHE *cache, DWORD slot) {
+    CACHE_BLOCK *block = &cache->blocks[slot];
+
+    if(block->newer != CACHE_NONE)
+        cache->blocks[block->newer].older = block->older;
+    else
+        cache->newest = block->older;
+
+    if(block->older != CACHE_NONE)
+        cache->blocks[block->older].newer = block->newer;
+    else
+        cache->oldest = block->newer;
+}
+
+/*----------------------------------------------------------------------------
+ * Puts block 'slot' at the front of the list ordered by use.
+ *--------------------------------------------------------------------------*/
+static void MakeNewest(DTA_BLOCK_CACHE *cache, DWORD slot) {
+    CACHE_BLOCK *block = &cache->blocks[slot];
+
+    block->newer = CACHE_NONE;
+    block->older = cache->newest;
+
+    if(cache->newest != CACHE_NONE)
+        cache->blocks[cache->newest].newer = slot;
+    else
+        cache->oldest = slot;
+
+    cache->newest = slot;
+}
+
+/*----------------------------------------------------------------------------
+ * Removes block 'slot' from its bucket.
+ *--------------------------------------------------------------------------*/
+static void RemoveFromBucket(DTA_BLOCK_CACHE *cache, DWORD slot) {
+    CACHE_BLOCK *block  = &cache->blocks[slot];
+    DWORD       *link   = &cache->buckets[GetBucket(cache, block->dataOffset, block->index)];
+
+    while(*link != slot)
+        link = &cache->blocks[*link].nextInBucket;
+
+    *link = block->nextInBucket;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the slot holding the block 'index' of 'info', reading and
+ * decoding it into the least recently used slot if it isn't cached.
+ * Has to be called with the lock held.
+ *--------------------------------------------------------------------------*/
+static DWORD FetchBlock(DTA_BLOCK_CACHE *cache, const DTA_ENTRY_INFO *info, DWORD index) {
+    DWORD       bucket  = GetBucket(cache, info->dataOffset, index);
+    DWORD       slot;
+    CACHE_BLOCK *block;
+
+    for(slot = cache->buckets[bucket]; slot != CACHE_NONE; slot = cache->blocks[slot].nextInBucket) {
+        if(cache->blocks[slot].dataOffset == info->dataOffset && cache->blocks[slot].index == index) {
+            ++cache->hits;
+
+            Unlink(cache, slot);
+            MakeNewest(cache, slot);
+
+            return slot;
+        }
+    }
+
+    ++cache->misses;
+
+    /* Take a free slot while there are any, then the oldest block */
+    if(cache->usedBlocks < cache->numOfBlocks) {
+        slot = cache->usedBlocks++;
+    } else {
+        slot = cache->oldest;
+
+        Unlink(cache, slot);
+        RemoveFromBucket(cache, slot);
+    }
+
+    block = &cache->blocks[slot];
+
+    block->dataOffset   = info->dataOffset;
+    block->index        = index;
+    block->length       = DtaReadEntry(cache->archive, info, index * cache->blockSize,
+                                       cache->data + (size_t)slot * cache->blockSize, cache->blockSize);
+    block->nextInBucket = cache->buckets[bucket];
+
+    cache->buckets[bucket] = slot;
+    MakeNewest(cache, slot);
+
+    return slot;
+}
+
+/*----------------------------------------------------------------------------
+ * Creates a cache of at most 'numOfBlocks' decoded blocks of 'archive'.
+ * The memory for all of them is allocated up front. If any errors occur,
+ * 'error' string is set and the function returns NULL.
+ *
+ *  Arguments:      archive         Open archive, has to outlive the cache
+ *                  blockSize       Size of a block, 0 for the default
+ *                  numOfBlocks     Number of blocks to keep
+ *                  error           Error string
+ *
+ *  Returns the cache, which has to be released with DtaReleaseBlockCache.
+ *--------------------------------------------------------------------------*/
+DTA_BLOCK_CACHE *DtaCreateBlockCache(const DTA_ARCHIVE *archive, DWORD blockSize, DWORD numOfBlocks, char error[DTA_ERROR_LENGTH]) {
+    DTA_BLOCK_CACHE *cache;
+    DWORD           i;
+
+    if(blockSize == 0)
+        blockSize = DTA_DEFAULT_BLOCK_SIZE;
+
+    if(numOfBlocks == 0 || numOfBlocks >= 0x80000000 || (unsigned __int64)blockSize * numOfBlocks > (SIZE_T)-1) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The cache can't hold that many blocks", DTA_ERROR_LENGTH);
+        return NULL;
+    }
+
+    if((cache = (DTA_BLOCK_CACHE *)calloc(1, sizeof(DTA_BLOCK_CACHE))) == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the block cache", DTA_ERROR_LENGTH);
+        return NULL;
+    }
+
+    /* Keep the buckets at most half full */
+    for(cache->numOfBuckets = 1; cache->numOfBuckets < numOfBlocks * 2; cache->numOfBuckets *= 2)
+        ;
+
+    cache->archive      = archive;
+    cache->blockSize    = blockSize;
+    cache->numOfBlocks  = numOfBlocks;
+    cache->newest       = CACHE_NONE;
+    cache->oldest       = CACHE_NONE;
+    cache->data         = (char *)malloc((size_t)blockSize * numOfBlocks);
+    cache->blocks       = (CACHE_BLOCK *)malloc(sizeof(CACHE_BLOCK) * numOfBlocks);
+    cache->buckets      = (DWORD *)malloc(sizeof(DWORD) * cache->numOfBuckets);
+
+    if(cache->data == NULL || cache->blocks == NULL || cache->buckets == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the block cache", DTA_ERROR_LENGTH);
+        free(cache->data);
+        free(cache->blocks);
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+
+    for(i = 0; i < cache->numOfBuckets; ++i)
+        cache->buckets[i] = CACHE_NONE;
+
+    InitializeCriticalSection(&cache->lock);
+
+    return cache;
+}
+
+/*----------------------------------------------------------------------------
+ * Releases the cache and every block inside of it.
+ *
+ *  Arguments:      cache           Cache to release
+ *--------------------------------------------------------------------------*/
+void DtaReleaseBlockCache(DTA_BLOCK_CACHE *cache) {
+    if(cache == NULL)
+        return;
+
+    DeleteCriticalSection(&cache->lock);
+
+    free(cache->data);
+    free(cache->blocks);
+    free(cache->buckets);
+    free(cache);
+}
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' decoded bytes of an entry, starting at 'offset'
+ * inside of it, into 'buffer'. Blocks that are not cached yet are read and
+ * decoded first.
+ *
+ *  Arguments:      cache           Cache of the entry's archive
+ *                  info            Entry to read
+ *                  offset          Position inside the entry
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for if the entry is
+ *  cut short by the end of the archive.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadRange(DTA_BLOCK_CACHE *cache, const DTA_ENTRY_INFO *info, DWORD offset, void *buffer, DWORD size) {
+    DWORD copied = 0;
+
+    if(offset >= info->fileSize)
+        return 0;
+
+    size = min(size, info->fileSize - offset);
+
+    EnterCriticalSection(&cache->lock);
+
+    /* The block is copied out before the lock is released, since another
+       thread could replace it right after */
+    while(copied < size) {
+        DWORD pos       = offset + copied;
+        DWORD slot      = FetchBlock(cache, info, pos / cache->blockSize);
+        DWORD inBlock   = pos % cache->blockSize;
+        DWORD n;
+
+        /* The archive ended inside of the entry, nothing more can be read */
+        if(cache->blocks[slot].length <= inBlock)
+            break;
+
+        n = min(size - copied, cache->blocks[slot].length - inBlock);
+
+        memcpy((char *)buffer + copied, cache->data + (size_t)slot * cache->blockSize + inBlock, n);
+        copied += n;
+    }
+
+    LeaveCriticalSection(&cache->lock);
+
+    return copied;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the cache.
+ *
+ *  Arguments:      cache           Cache to inspect
+ *                  stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void DtaGetCacheStats(DTA_BLOCK_CACHE *cache, DTA_CACHE_STATS *stats) {
+    EnterCriticalSection(&cache->lock);
+
+    stats->hits         = cache->hits;
+    stats->misses       = cache->misses;
+    stats->numOfBlocks  = cache->numOfBlocks;
+    stats->usedBlocks   = cache->usedBlocks;
+
+    LeaveCriticalSection(&cache->lock);
+}
@@ -0,0 +1,87 @@
+/*  Description:
+ *      Random access reads of any byte range of any entry, through a bounded
+ *      cache of decoded blocks. Tools that only look at the first few KB of
+ *      many entries (model headers, WAV headers) read the same blocks over
+ *      and over; with the cache only the first read of a block copies it out
+ *      of the archive and decodes it.
+ *
+ *      An entry is split into blocks of 'blockSize' bytes, counted from the
+ *      first byte of its data. The archive decodes a whole DTA_BLOCK_SIZE at
+ *      a time, so that is the default. When the cache is full, the block that
+ *      was used longest ago is replaced. A cache may be shared by several
+ *      threads, it is guarded by a lock of its own.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef BLOCK_CACHE_H_
+#define BLOCK_CACHE_H_
+
+#include <windows.h>
+#include "Dta.h"
+
+/* Block size used when 0 is passed to DtaCreateBlockCache */
+#define DTA_DEFAULT_BLOCK_SIZE  DTA_BLOCK_SIZE
+
+/*
+ * A cache of decoded blocks of one archive. The members are private to
+ * the library.
+ */
+typedef struct t_dtablockcache DTA_BLOCK_CACHE;
+
+/*
+ * Counters of a cache. A read spanning several blocks counts once for each
+ * of them.
+ */
+typedef struct t_dtacachestats {
+    unsigned __int64    hits;
+    unsigned __int64    misses;
+    DWORD               numOfBlocks;        /* Blocks the cache can hold */
+    DWORD               usedBlocks;         /* Blocks holding data */
+} DTA_CACHE_STATS;
+
+/*----------------------------------------------------------------------------
+ * Creates a cache of at most 'numOfBlocks' decoded blocks of 'archive'.
+ * The memory for all of them is allocated up front. If any errors occur,
+ * 'error' string is set and the function returns NULL.
+ *
+ *  Arguments:      archive         Open archive, has to outlive the cache
+ *                  blockSize       Size of a block, 0 for the default
+ *                  numOfBlocks     Number of blocks to keep
+ *                  error           Error string
+ *
+ *  Returns the cache, which has to be released with DtaReleaseBlockCache.
+ *--------------------------------------------------------------------------*/
+DTA_BLOCK_CACHE *DtaCreateBlockCache(const DTA_ARCHIVE *archive, DWORD blockSize, DWORD numOfBlocks, char error[DTA_ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Releases the cache and every block inside of it.
+ *
+ *  Arguments:      cache           Cache to release
+ *--------------------------------------------------------------------------*/
+void DtaReleaseBlockCache(DTA_BLOCK_CACHE *cache);
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' decoded bytes of an entry, starting at 'offset'
+ * inside of it, into 'buffer'. Blocks that are not cached yet are read and
+ * decoded first.
+ *
+ *  Arguments:      cache           Cache of the entry's archive
+ *                  info            Entry to read
+ *                  offset          Position inside the entry
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for if the entry is
+ *  cut short by the end of the archive.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadRange(DTA_BLOCK_CACHE *cache, const DTA_ENTRY_INFO *info, DWORD offset, void *buffer, DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Fills 'stats' with the counters of the cache.
+ *
+ *  Arguments:      cache           Cache to inspect
+ *                  stats           Receives the counters
+ *--------------------------------------------------------------------------*/
+void DtaGetCacheStats(DTA_BLOCK_CACHE *cache, DTA_CACHE_STATS *stats);
+
+#endif
@@ -0,0 +1,101 @@
+/*  Description:
+ *      Contains the DTA file format structures used by the dtaRead function,
+ *      along with utility functions to simplify processing
+ *
+ *      The magic identifier of a DTA file is the first four bytes, which must be ISD0.
+ *      The rest of the content varies from file to file, and is encrypted.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DTA_FILE_FORMAT_H_
+#define DTA_FILE_FORMAT_H_
+
+/* The 4-byte sequence that a DTA file begins with */
+#define TRUE_DTA_IDENTIFIER (('I') + ('S' << 8) + ('D' << 16) + ('0' << 24))
+
+/*
+ * This is the initial header, it contains 4 fields:
+ *
+ *  4 bytes     - Number of files in this archive
+ *  4 bytes     - Beginning offset of the content table
+ *  4 bytes     - Size of the content table
+ *  4 bytes     - [Unknown]
+ */
+typedef struct t_dtaheader {
+    DWORD   numOfFiles;
+    DWORD   contentOffset;
+    DWORD   contentSize;
+    DWORD   extra;
+} DTA_HEADER;
+
+/*
+ * This is the contents header, it contains 4 fields as well:
+ *
+ *  4 bytes     - [Unknown]
+ *  4 bytes     - Beginning offset of the file data
+ *  4 bytes     - [Unknown]
+ *  16 bytes    - Filename hint
+ */
+typedef struct t_dtacontentheader {
+    DWORD   extra1;
+    DWORD   fileOffset;
+    DWORD   extra2;
+    char    filename[16];
+} DTA_CONTENT_HEADER;
+
+/*
+ * This is the file header, followed by the filename and the file data:
+ *
+ *  16 bytes    - [Unknown]
+ *  4 bytes     - Size of the file once it is decoded
+ *  4 bytes     - Number of blocks the file data is stored in
+ *  2 bytes     - Length of the filename, the top bit is DTA_FILE_ENCRYPTED
+ *  6 bytes     - [Unknown]
+ *
+ * The header and the filename are always encrypted, each on its own.
+ */
+typedef struct t_dtafileheader {
+    DWORD           extra1;
+    DWORD           extra2;
+    DWORD           extra3;
+    DWORD           extra4;
+    DWORD           fileSize;
+    DWORD           numOfBlocks;
+    WORD            filenameLength;
+    char            extra6[6];
+  /*char            *filename; Processed seperately */
+} DTA_FILE_HEADER;
+
+/* Set in 'filenameLength' if the blocks of the file are encrypted */
+#define DTA_FILE_ENCRYPTED      0x8000
+
+/* Length of the filename that follows 'header' */
+#define DTA_FILENAME_LENGTH(header)     ((header)->filenameLength & ~DTA_FILE_ENCRYPTED)
+
+/*
+ * The file data is a sequence of blocks, each starting with this header,
+ * which is never encrypted:
+ *
+ *  2 bytes     - Number of bytes stored after this header
+ *  2 bytes     - The same number of the previous block, 0 for the first
+ *
+ * The first stored byte is the type of the block, the rest is its data. If
+ * the file is encrypted, the stored bytes are, starting over at the type.
+ * Every block but the last one decodes to DTA_BLOCK_SIZE bytes.
+ */
+typedef struct t_dtablockheader {
+    WORD            storedSize;
+    WORD            previousSize;
+} DTA_BLOCK_HEADER;
+
+/* Decoded size of every block but the last one of a file */
+#define DTA_BLOCK_SIZE          32768
+
+/* Block types, all others below DTA_BLOCK_AUDIO are stored as they are */
+#define DTA_BLOCK_LZ            1       /* LZ77 with run lengths */
+#define DTA_BLOCK_AUDIO         8       /* And up, sound data in a WAV file */
+
+/* The WAV header at the start of the first block of a sound */
+#define DTA_WAV_HEADER_SIZE     44
+
+#endif
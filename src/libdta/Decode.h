@@ -0,0 +1,54 @@
+/*  Description:
+ *      The decoder of the file data. Every block of a file is decoded on its
+ *      own (see DTA_BLOCK_HEADER), depending on its type:
+ *
+ *          DTA_BLOCK_LZ        LZ77 with 12-bit distances and run lengths
+ *          DTA_BLOCK_AUDIO+    Sound data, 16-bit samples are stored as 8-bit
+ *                              steps into a table of deltas, 8-bit samples
+ *                              either as they are or with LZ77
+ *          anything else       Stored as it is
+ *
+ *      Blocks of a sound need the WAV header of the first block of the same
+ *      file for the format of the samples. That header is encrypted even in
+ *      a file whose blocks are not, see UnmaskWavHeader.
+ *
+ *      The decoder only works on blocks that are already decrypted, and never
+ *      reads or writes outside of the buffers it is given.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DECODE_H_
+#define DECODE_H_
+
+#include <windows.h>
+#include "DTAFormat.h"
+
+/*----------------------------------------------------------------------------
+ * Decodes a single block into 'out'. Output past 'capacity' is dropped, so
+ * the last block of a file can be cut to the file size.
+ *
+ *  Arguments:      block           Decrypted block, starting with its type
+ *                  size            Stored size of the block
+ *                  wavHeader       WAV header of the file, NULL if none was
+ *                                  read
+ *                  out             Receives the decoded data
+ *                  capacity        Size of 'out'
+ *                  decoded         Receives the number of bytes decoded
+ *
+ *  Returns FALSE if the block is corrupt.
+ *--------------------------------------------------------------------------*/
+BOOL DecodeBlock(const unsigned char *block, DWORD size, const unsigned char *wavHeader, unsigned char *out, DWORD capacity,
+                 DWORD *decoded);
+
+/*----------------------------------------------------------------------------
+ * Decrypts the WAV header of the first block of a file whose blocks are not
+ * encrypted. Does nothing unless the block is a sound.
+ *
+ *  Arguments:      block           First block, starting with its type
+ *                  size            Stored size of the block
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *--------------------------------------------------------------------------*/
+void UnmaskWavHeader(unsigned char *block, DWORD size, unsigned int key1, unsigned int key2);
+
+#endif
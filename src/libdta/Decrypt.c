@@ -0,0 +1,699 @@
+/*  Description:
+ *      Implementation of the decryption kernels, along with the CPU detection
+ *      used to choose between them.
+ *
+ *      The vector kernels decrypt byte-by-byte until the buffer is aligned to
+ *      the vector width, then use aligned loads and stores with the key pattern
+ *      rotated to match, and finish the remainder byte-by-byte again.
+ *
+ *      The copying kernels align on the destination instead, since that is
+ *      where the non-temporal stores go, and load the source unaligned.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <string.h>
+#include "Decrypt.h"
+
+#ifdef DECRYPT_HAVE_SSE2
+#include <intrin.h>
+#include <emmintrin.h>
+#endif
+
+#if defined(DECRYPT_HAVE_AVX2) || defined(DECRYPT_HAVE_AVX512)
+#include <immintrin.h>
+#endif
+
+/*----------------------------------------------------------------------------
+ * Picks a kernel, then forwards the call to it.
+ *--------------------------------------------------------------------------*/
+static void DecryptFirstCall(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*----------------------------------------------------------------------------
+ * Picks the kernels, then forwards the call to the copying one.
+ *--------------------------------------------------------------------------*/
+static void DecryptCopyFirstCall(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                                 unsigned int offset, int streaming);
+
+static void DecryptCopyScalar(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                              unsigned int offset, int streaming);
+
+#ifdef DECRYPT_HAVE_SSE2
+static void DecryptCopySSE2(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                            unsigned int offset, int streaming);
+#endif
+
+#ifdef DECRYPT_HAVE_AVX2
+static void DecryptCopyAVX2(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                            unsigned int offset, int streaming);
+#endif
+
+#ifdef DECRYPT_HAVE_AVX512
+static void DecryptCopyAVX512(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                              unsigned int offset, int streaming);
+#endif
+
+/* Kernels used by Decrypt() and DecryptCopy() */
+static FPDecrypt        decryptKernel       = DecryptFirstCall;
+static FPDecryptCopy    decryptCopyKernel   = DecryptCopyFirstCall;
+static const char       *decryptKernelName  = "scalar";
+
+/*----------------------------------------------------------------------------
+ * Stores the 8-byte key pattern in the order it is applied to the data.
+ *
+ *  Arguments:      pattern         Receives the pattern
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *--------------------------------------------------------------------------*/
+static void GetKeyPattern(unsigned char pattern[8], unsigned int key1, unsigned int key2) {
+    unsigned int keys[2] = { key2, key1 };
+
+    memcpy(pattern, keys, 8);
+}
+
+/*----------------------------------------------------------------------------
+ * Decrypts 'byteCount' bytes one at a time. 'offset' is the position of the
+ * first byte relative to the start of the key pattern.
+ *
+ *  Arguments:      buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *                  pattern         Key pattern from GetKeyPattern()
+ *                  offset          Position of the first byte
+ *--------------------------------------------------------------------------*/
+static void DecryptBytes(unsigned char *buffer, unsigned int byteCount, const unsigned char pattern[8], unsigned int offset) {
+    for(; byteCount; --byteCount, ++buffer, ++offset)
+        *buffer = (unsigned char)(*buffer ^ pattern[offset % 8]);
+}
+
+/*----------------------------------------------------------------------------
+ * Decrypts 'byteCount' bytes from 'source' into 'dest' one at a time.
+ *
+ *  Arguments:      dest            Receives the decrypted data
+ *                  source          Data to decrypt
+ *                  byteCount       Size of data
+ *                  pattern         Key pattern from GetKeyPattern()
+ *                  offset          Position of the first byte
+ *--------------------------------------------------------------------------*/
+static void DecryptCopyBytes(unsigned char *dest, const unsigned char *source, unsigned int byteCount,
+                             const unsigned char pattern[8], unsigned int offset) {
+    for(; byteCount; --byteCount, ++dest, ++source, ++offset)
+        *dest = (unsigned char)(*source ^ pattern[offset % 8]);
+}
+
+#ifdef DECRYPT_HAVE_SSE2
+/*----------------------------------------------------------------------------
+ * Returns the key pattern as it lines up with data that starts 'offset'
+ * bytes into the pattern, split into its low and high 32-bit halves.
+ *
+ *  Arguments:      pattern         Key pattern from GetKeyPattern()
+ *                  offset          Position of the data
+ *                  low             Receives bytes 0-3
+ *                  high            Receives bytes 4-7
+ *--------------------------------------------------------------------------*/
+static void RotatePattern(const unsigned char pattern[8], unsigned int offset, unsigned int *low, unsigned int *high) {
+    unsigned char   rotated[8];
+    unsigned int    i;
+
+    for(i = 0; i < 8; ++i)
+        rotated[i] = pattern[(offset + i) % 8];
+
+    memcpy(low, rotated, 4);
+    memcpy(high, rotated + 4, 4);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns how many bytes have to be skipped for 'buffer' to be aligned to
+ * 'alignment', limited to 'byteCount'.
+ *--------------------------------------------------------------------------*/
+static unsigned int HeadLength(const void *buffer, unsigned int byteCount, unsigned int alignment) {
+    unsigned int head = (unsigned int)((alignment - ((size_t)buffer & (alignment - 1))) & (alignment - 1));
+
+    return head < byteCount ? head : byteCount;
+}
+#endif
+
+/*--------------------------------------------------------------------------
+ * Decrypts 'buffer' of size 'byteCount' using 'key1' and 'key2' as
+ * decryption keys.
+ *
+ * These keys are more or less specific to the file.
+ *
+ * Arguments:       buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *-------------------------------------------------------------------------*/
+void Decrypt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2) {
+    decryptKernel(buffer, byteCount, key1, key2, 0);
+}
+
+/*--------------------------------------------------------------------------
+ * Decrypts 'buffer', which starts 'offset' bytes into an encrypted block.
+ * Decrypting a block in several pieces this way gives the same result as
+ * decrypting it at once.
+ *
+ * Arguments:       buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'buffer' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptAt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    decryptKernel(buffer, byteCount, key1, key2, offset);
+}
+
+/*--------------------------------------------------------------------------
+ * Copies 'byteCount' bytes from 'source' to 'dest' and decrypts them on the
+ * way, as if they started 'offset' bytes into an encrypted block. The two
+ * buffers must not overlap, unless they are the same. Copies of at least
+ * DECRYPT_STREAM_THRESHOLD bytes use non-temporal stores.
+ *
+ * Arguments:       dest            Receives the decrypted data
+ *                  source          Encrypted data
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'source' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptCopy(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    decryptCopyKernel(dest, source, byteCount, key1, key2, offset, byteCount >= DECRYPT_STREAM_THRESHOLD);
+}
+
+/*--------------------------------------------------------------------------
+ * Same as DecryptCopy(), but always uses non-temporal stores, for a 'dest'
+ * that won't be read again soon, like a mapped output file.
+ *
+ * Arguments:       dest            Receives the decrypted data
+ *                  source          Encrypted data
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'source' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptCopyStreaming(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    decryptCopyKernel(dest, source, byteCount, key1, key2, offset, 1);
+}
+
+/*--------------------------------------------------------------------------
+ * Prepares 'context' for a block whose next byte is at 'offset'.
+ *
+ * Arguments:       context         Context to initialize
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position inside the block, usually 0
+ *-------------------------------------------------------------------------*/
+void InitCipher(CIPHER_CONTEXT *context, unsigned int key1, unsigned int key2, unsigned int offset) {
+    context->key1   = key1;
+    context->key2   = key2;
+    context->offset = offset;
+}
+
+/*--------------------------------------------------------------------------
+ * Decrypts the next 'byteCount' bytes of the block and moves the position
+ * of 'context' past them.
+ *
+ * Arguments:       context         Context from InitCipher()
+ *                  buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *-------------------------------------------------------------------------*/
+void DecryptStream(CIPHER_CONTEXT *context, void *buffer, unsigned int byteCount) {
+    decryptKernel(buffer, byteCount, context->key1, context->key2, context->offset);
+
+    /* Only the position within the pattern matters, so wrapping around is fine */
+    context->offset += byteCount;
+}
+
+/*----------------------------------------------------------------------------
+ * Appends a kernel and its copying variant to 'kernels'.
+ *--------------------------------------------------------------------------*/
+static void AddKernel(DECRYPT_KERNEL *kernels, unsigned int *count, const char *name, FPDecrypt decrypt, FPDecryptCopy decryptCopy) {
+    kernels[*count].name        = name;
+    kernels[*count].decrypt     = decrypt;
+    kernels[*count].decryptCopy = decryptCopy;
+    ++*count;
+}
+
+/*--------------------------------------------------------------------------
+ * Fills 'kernels' with every kernel the CPU supports, the scalar reference
+ * first and the fastest last, and returns how many there are.
+ *
+ * Arguments:       kernels         Receives the kernels
+ *-------------------------------------------------------------------------*/
+unsigned int GetDecryptKernels(DECRYPT_KERNEL kernels[DECRYPT_MAX_KERNELS]) {
+    unsigned int count = 0;
+
+    AddKernel(kernels, &count, "scalar", DecryptScalar, DecryptCopyScalar);
+
+#ifdef DECRYPT_HAVE_SSE2
+    {
+        int info[4];
+
+        __cpuid(info, 0);
+
+        if(info[0] >= 1) {
+            int maxLeaf = info[0];
+
+            __cpuid(info, 1);
+
+            /* EDX bit 26 */
+            if(info[3] & (1 << 26))
+                AddKernel(kernels, &count, "sse2", DecryptSSE2, DecryptCopySSE2);
+
+#if defined(DECRYPT_HAVE_AVX2) || defined(DECRYPT_HAVE_AVX512)
+            /* ECX bit 27 (OSXSAVE), then check that the OS saves the YMM state */
+            if(maxLeaf >= 7 && (info[2] & (1 << 27))) {
+                unsigned __int64 xcr0 = _xgetbv(0);
+
+                __cpuidex(info, 7, 0);
+
+#ifdef DECRYPT_HAVE_AVX2
+                /* EBX bit 5 */
+                if((xcr0 & 0x06) == 0x06 && (info[1] & (1 << 5)))
+                    AddKernel(kernels, &count, "avx2", DecryptAVX2, DecryptCopyAVX2);
+#endif
+
+#ifdef DECRYPT_HAVE_AVX512
+                /* EBX bit 16, the OS has to save the ZMM state as well */
+                if((xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)))
+                    AddKernel(kernels, &count, "avx512", DecryptAVX512, DecryptCopyAVX512);
+#endif
+            }
+#endif
+        }
+    }
+#endif
+
+    return count;
+}
+
+/*--------------------------------------------------------------------------
+ * Selects the kernels used by Decrypt() and DecryptCopy() based on what the
+ * CPU supports. It is called automatically the first time one of them runs,
+ * calling it again is harmless.
+ *-------------------------------------------------------------------------*/
+void InitDecrypt(void) {
+    DECRYPT_KERNEL  kernels[DECRYPT_MAX_KERNELS];
+    unsigned int    count = GetDecryptKernels(kernels);
+
+    decryptKernelName   = kernels[count - 1].name;
+    decryptCopyKernel   = kernels[count - 1].decryptCopy;
+    decryptKernel       = kernels[count - 1].decrypt;
+}
+
+/*--------------------------------------------------------------------------
+ * Returns the name of the kernel used by Decrypt() ("scalar", "sse2",
+ * "avx2" or "avx512").
+ *-------------------------------------------------------------------------*/
+const char *GetDecryptKernelName(void) {
+    if(decryptKernel == DecryptFirstCall)
+        InitDecrypt();
+
+    return decryptKernelName;
+}
+
+/*----------------------------------------------------------------------------
+ * Picks a kernel, then forwards the call to it.
+ *--------------------------------------------------------------------------*/
+static void DecryptFirstCall(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    InitDecrypt();
+    decryptKernel(buffer, byteCount, key1, key2, offset);
+}
+
+/*----------------------------------------------------------------------------
+ * Picks the kernels, then forwards the call to the copying one.
+ *--------------------------------------------------------------------------*/
+static void DecryptCopyFirstCall(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                                 unsigned int offset, int streaming) {
+    InitDecrypt();
+    decryptCopyKernel(dest, source, byteCount, key1, key2, offset, streaming);
+}
+
+/*--------------------------------------------------------------------------
+ * Reference implementation, processes 8 bytes at a time once the stream is
+ * on a key boundary.
+ *-------------------------------------------------------------------------*/
+void DecryptScalar(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    unsigned char   *pKey;
+    unsigned int    byteCount64;
+    __int64         *buffer64;
+    unsigned char   *pByte;
+    unsigned int    cBytes;
+    unsigned int    keys[2] = { key2, key1 };
+    unsigned int    head    = (8 - offset % 8) % 8;
+
+    /* Bring the stream back onto a key boundary one byte at a time */
+    if(head > byteCount)
+        head = byteCount;
+
+    DecryptBytes((unsigned char *)buffer, head, (const unsigned char *)keys, offset);
+    buffer      = (unsigned char *)buffer + head;
+    byteCount   -= head;
+
+    /* Process 64-bit chunks first, then process remaining bytes */
+    buffer64 = (__int64 *)buffer;
+    byteCount64 = byteCount / 8;
+
+    for (; byteCount64; --byteCount64, ++buffer64) {
+        unsigned int    ulong;
+        unsigned int    *pLong = ((unsigned int *)buffer64);
+
+        ulong = *pLong;
+        *pLong = ~((~ulong) ^ key2);
+        ++pLong;
+        ulong = *pLong;
+        *pLong = ~((~ulong) ^ key1);
+    }
+
+    pByte = ((unsigned char *)buffer64);
+    cBytes = byteCount % 8;
+    pKey = ((unsigned char *)keys);
+
+    for (; cBytes; --cBytes, ++pByte, ++pKey) {
+        unsigned char byte  = *pByte;
+        unsigned char key   = *pKey;
+
+        *pByte = (unsigned char)(~((~byte) ^ key));
+    }
+}
+
+/*--------------------------------------------------------------------------
+ * Copying counterpart of DecryptScalar. Plain C has no way to bypass the
+ * cache, so 'streaming' is ignored.
+ *-------------------------------------------------------------------------*/
+static void DecryptCopyScalar(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                              unsigned int offset, int streaming) {
+    unsigned char       pattern[8];
+    unsigned char       *pDest      = (unsigned char *)dest;
+    const unsigned char *pSource    = (const unsigned char *)source;
+    unsigned int        head        = (8 - offset % 8) % 8;
+
+    (void)streaming;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    if(head > byteCount)
+        head = byteCount;
+
+    DecryptCopyBytes(pDest, pSource, head, pattern, offset);
+    pDest       += head;
+    pSource     += head;
+    byteCount   -= head;
+
+    /* Neither side has to be aligned, so go through a local copy */
+    for(; byteCount >= 8; byteCount -= 8, pDest += 8, pSource += 8) {
+        unsigned int words[2];
+
+        memcpy(words, pSource, 8);
+        words[0] ^= key2;
+        words[1] ^= key1;
+        memcpy(pDest, words, 8);
+    }
+
+    DecryptCopyBytes(pDest, pSource, byteCount, pattern, 0);
+}
+
+#ifdef DECRYPT_HAVE_SSE2
+/*--------------------------------------------------------------------------
+ * SSE2 kernel, processes 64 bytes per iteration.
+ *-------------------------------------------------------------------------*/
+void DecryptSSE2(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    unsigned char   pattern[8];
+    unsigned char   *pByte = (unsigned char *)buffer;
+    unsigned int    head;
+    unsigned int    low;
+    unsigned int    high;
+    __m128i         key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pByte, byteCount, 16);
+    DecryptBytes(pByte, head, pattern, offset);
+    pByte       += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm_set_epi32((int)high, (int)low, (int)high, (int)low);
+
+    for(; byteCount >= 64; byteCount -= 64, pByte += 64) {
+        __m128i *p = (__m128i *)pByte;
+
+        _mm_store_si128(p + 0, _mm_xor_si128(_mm_load_si128(p + 0), key));
+        _mm_store_si128(p + 1, _mm_xor_si128(_mm_load_si128(p + 1), key));
+        _mm_store_si128(p + 2, _mm_xor_si128(_mm_load_si128(p + 2), key));
+        _mm_store_si128(p + 3, _mm_xor_si128(_mm_load_si128(p + 3), key));
+    }
+
+    for(; byteCount >= 16; byteCount -= 16, pByte += 16)
+        _mm_store_si128((__m128i *)pByte, _mm_xor_si128(_mm_load_si128((__m128i *)pByte), key));
+
+    /* Every vector step was a multiple of 8, so the tail lines up with the head */
+    DecryptBytes(pByte, byteCount, pattern, offset + head);
+}
+
+/*--------------------------------------------------------------------------
+ * Copying counterpart of DecryptSSE2.
+ *-------------------------------------------------------------------------*/
+static void DecryptCopySSE2(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                            unsigned int offset, int streaming) {
+    unsigned char       pattern[8];
+    unsigned char       *pDest      = (unsigned char *)dest;
+    const unsigned char *pSource    = (const unsigned char *)source;
+    unsigned int        head;
+    unsigned int        low;
+    unsigned int        high;
+    __m128i             key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pDest, byteCount, 16);
+    DecryptCopyBytes(pDest, pSource, head, pattern, offset);
+    pDest       += head;
+    pSource     += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm_set_epi32((int)high, (int)low, (int)high, (int)low);
+
+    if(streaming) {
+        for(; byteCount >= 64; byteCount -= 64, pDest += 64, pSource += 64) {
+            const __m128i   *s = (const __m128i *)pSource;
+            __m128i         *d = (__m128i *)pDest;
+
+            _mm_stream_si128(d + 0, _mm_xor_si128(_mm_loadu_si128(s + 0), key));
+            _mm_stream_si128(d + 1, _mm_xor_si128(_mm_loadu_si128(s + 1), key));
+            _mm_stream_si128(d + 2, _mm_xor_si128(_mm_loadu_si128(s + 2), key));
+            _mm_stream_si128(d + 3, _mm_xor_si128(_mm_loadu_si128(s + 3), key));
+        }
+
+        /* Non-temporal stores are weakly ordered, make them visible before returning */
+        _mm_sfence();
+    } else {
+        for(; byteCount >= 64; byteCount -= 64, pDest += 64, pSource += 64) {
+            const __m128i   *s = (const __m128i *)pSource;
+            __m128i         *d = (__m128i *)pDest;
+
+            _mm_store_si128(d + 0, _mm_xor_si128(_mm_loadu_si128(s + 0), key));
+            _mm_store_si128(d + 1, _mm_xor_si128(_mm_loadu_si128(s + 1), key));
+            _mm_store_si128(d + 2, _mm_xor_si128(_mm_loadu_si128(s + 2), key));
+            _mm_store_si128(d + 3, _mm_xor_si128(_mm_loadu_si128(s + 3), key));
+        }
+    }
+
+    for(; byteCount >= 16; byteCount -= 16, pDest += 16, pSource += 16)
+        _mm_store_si128((__m128i *)pDest, _mm_xor_si128(_mm_loadu_si128((const __m128i *)pSource), key));
+
+    DecryptCopyBytes(pDest, pSource, byteCount, pattern, offset + head);
+}
+#endif
+
+#ifdef DECRYPT_HAVE_AVX2
+/*--------------------------------------------------------------------------
+ * AVX2 kernel, processes 128 bytes per iteration.
+ *-------------------------------------------------------------------------*/
+void DecryptAVX2(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    unsigned char   pattern[8];
+    unsigned char   *pByte = (unsigned char *)buffer;
+    unsigned int    head;
+    unsigned int    low;
+    unsigned int    high;
+    __m256i         key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pByte, byteCount, 32);
+    DecryptBytes(pByte, head, pattern, offset);
+    pByte       += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm256_set_epi32((int)high, (int)low, (int)high, (int)low, (int)high, (int)low, (int)high, (int)low);
+
+    for(; byteCount >= 128; byteCount -= 128, pByte += 128) {
+        __m256i *p = (__m256i *)pByte;
+
+        _mm256_store_si256(p + 0, _mm256_xor_si256(_mm256_load_si256(p + 0), key));
+        _mm256_store_si256(p + 1, _mm256_xor_si256(_mm256_load_si256(p + 1), key));
+        _mm256_store_si256(p + 2, _mm256_xor_si256(_mm256_load_si256(p + 2), key));
+        _mm256_store_si256(p + 3, _mm256_xor_si256(_mm256_load_si256(p + 3), key));
+    }
+
+    for(; byteCount >= 32; byteCount -= 32, pByte += 32)
+        _mm256_store_si256((__m256i *)pByte, _mm256_xor_si256(_mm256_load_si256((__m256i *)pByte), key));
+
+    _mm256_zeroupper();
+
+    DecryptBytes(pByte, byteCount, pattern, offset + head);
+}
+
+/*--------------------------------------------------------------------------
+ * Copying counterpart of DecryptAVX2.
+ *-------------------------------------------------------------------------*/
+static void DecryptCopyAVX2(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                            unsigned int offset, int streaming) {
+    unsigned char       pattern[8];
+    unsigned char       *pDest      = (unsigned char *)dest;
+    const unsigned char *pSource    = (const unsigned char *)source;
+    unsigned int        head;
+    unsigned int        low;
+    unsigned int        high;
+    __m256i             key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pDest, byteCount, 32);
+    DecryptCopyBytes(pDest, pSource, head, pattern, offset);
+    pDest       += head;
+    pSource     += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm256_set_epi32((int)high, (int)low, (int)high, (int)low, (int)high, (int)low, (int)high, (int)low);
+
+    if(streaming) {
+        for(; byteCount >= 128; byteCount -= 128, pDest += 128, pSource += 128) {
+            const __m256i   *s = (const __m256i *)pSource;
+            __m256i         *d = (__m256i *)pDest;
+
+            _mm256_stream_si256(d + 0, _mm256_xor_si256(_mm256_loadu_si256(s + 0), key));
+            _mm256_stream_si256(d + 1, _mm256_xor_si256(_mm256_loadu_si256(s + 1), key));
+            _mm256_stream_si256(d + 2, _mm256_xor_si256(_mm256_loadu_si256(s + 2), key));
+            _mm256_stream_si256(d + 3, _mm256_xor_si256(_mm256_loadu_si256(s + 3), key));
+        }
+
+        _mm_sfence();
+    } else {
+        for(; byteCount >= 128; byteCount -= 128, pDest += 128, pSource += 128) {
+            const __m256i   *s = (const __m256i *)pSource;
+            __m256i         *d = (__m256i *)pDest;
+
+            _mm256_store_si256(d + 0, _mm256_xor_si256(_mm256_loadu_si256(s + 0), key));
+            _mm256_store_si256(d + 1, _mm256_xor_si256(_mm256_loadu_si256(s + 1), key));
+            _mm256_store_si256(d + 2, _mm256_xor_si256(_mm256_loadu_si256(s + 2), key));
+            _mm256_store_si256(d + 3, _mm256_xor_si256(_mm256_loadu_si256(s + 3), key));
+        }
+    }
+
+    for(; byteCount >= 32; byteCount -= 32, pDest += 32, pSource += 32)
+        _mm256_store_si256((__m256i *)pDest, _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)pSource), key));
+
+    _mm256_zeroupper();
+
+    DecryptCopyBytes(pDest, pSource, byteCount, pattern, offset + head);
+}
+#endif
+
+#ifdef DECRYPT_HAVE_AVX512
+/*--------------------------------------------------------------------------
+ * AVX-512 kernel, processes 256 bytes per iteration.
+ *-------------------------------------------------------------------------*/
+void DecryptAVX512(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset) {
+    unsigned char   pattern[8];
+    unsigned char   *pByte = (unsigned char *)buffer;
+    unsigned int    head;
+    unsigned int    low;
+    unsigned int    high;
+    __m512i         key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pByte, byteCount, 64);
+    DecryptBytes(pByte, head, pattern, offset);
+    pByte       += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm512_set4_epi32((int)high, (int)low, (int)high, (int)low);
+
+    for(; byteCount >= 256; byteCount -= 256, pByte += 256) {
+        __m512i *p = (__m512i *)pByte;
+
+        _mm512_store_si512(p + 0, _mm512_xor_si512(_mm512_load_si512(p + 0), key));
+        _mm512_store_si512(p + 1, _mm512_xor_si512(_mm512_load_si512(p + 1), key));
+        _mm512_store_si512(p + 2, _mm512_xor_si512(_mm512_load_si512(p + 2), key));
+        _mm512_store_si512(p + 3, _mm512_xor_si512(_mm512_load_si512(p + 3), key));
+    }
+
+    for(; byteCount >= 64; byteCount -= 64, pByte += 64)
+        _mm512_store_si512((__m512i *)pByte, _mm512_xor_si512(_mm512_load_si512((__m512i *)pByte), key));
+
+    _mm256_zeroupper();
+
+    DecryptBytes(pByte, byteCount, pattern, offset + head);
+}
+
+/*--------------------------------------------------------------------------
+ * Copying counterpart of DecryptAVX512.
+ *-------------------------------------------------------------------------*/
+static void DecryptCopyAVX512(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                              unsigned int offset, int streaming) {
+    unsigned char       pattern[8];
+    unsigned char       *pDest      = (unsigned char *)dest;
+    const unsigned char *pSource    = (const unsigned char *)source;
+    unsigned int        head;
+    unsigned int        low;
+    unsigned int        high;
+    __m512i             key;
+
+    GetKeyPattern(pattern, key1, key2);
+
+    head = HeadLength(pDest, byteCount, 64);
+    DecryptCopyBytes(pDest, pSource, head, pattern, offset);
+    pDest       += head;
+    pSource     += head;
+    byteCount   -= head;
+
+    RotatePattern(pattern, offset + head, &low, &high);
+    key = _mm512_set4_epi32((int)high, (int)low, (int)high, (int)low);
+
+    if(streaming) {
+        for(; byteCount >= 256; byteCount -= 256, pDest += 256, pSource += 256) {
+            const __m512i   *s = (const __m512i *)pSource;
+            __m512i         *d = (__m512i *)pDest;
+
+            _mm512_stream_si512(d + 0, _mm512_xor_si512(_mm512_loadu_si512(s + 0), key));
+            _mm512_stream_si512(d + 1, _mm512_xor_si512(_mm512_loadu_si512(s + 1), key));
+            _mm512_stream_si512(d + 2, _mm512_xor_si512(_mm512_loadu_si512(s + 2), key));
+            _mm512_stream_si512(d + 3, _mm512_xor_si512(_mm512_loadu_si512(s + 3), key));
+        }
+
+        _mm_sfence();
+    } else {
+        for(; byteCount >= 256; byteCount -= 256, pDest += 256, pSource += 256) {
+            const __m512i   *s = (const __m512i *)pSource;
+            __m512i         *d = (__m512i *)pDest;
+
+            _mm512_store_si512(d + 0, _mm512_xor_si512(_mm512_loadu_si512(s + 0), key));
+            _mm512_store_si512(d + 1, _mm512_xor_si512(_mm512_loadu_si512(s + 1), key));
+            _mm512_store_si512(d + 2, _mm512_xor_si512(_mm512_loadu_si512(s + 2), key));
+            _mm512_store_si512(d + 3, _mm512_xor_si512(_mm512_loadu_si512(s + 3), key));
+        }
+    }
+
+    for(; byteCount >= 64; byteCount -= 64, pDest += 64, pSource += 64)
+        _mm512_store_si512((__m512i *)pDest, _mm512_xor_si512(_mm512_loadu_si512((const __m512i *)pSource), key));
+
+    _mm256_zeroupper();
+
+    DecryptCopyBytes(pDest, pSource, byteCount, pattern, offset + head);
+}
+#endif
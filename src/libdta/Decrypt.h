@@ -0,0 +1,187 @@
+/*  Description:
+ *      The DTA cipher. Every encrypted block is XOR'ed with a repeating 8-byte
+ *      pattern made of the two keys (key2 first, then key1), starting over at
+ *      the beginning of the block.
+ *
+ *      Since the pattern only depends on the position inside the block, any
+ *      part of a block can be decrypted on its own if its offset is known.
+ *      DecryptAt() takes that offset, and a CIPHER_CONTEXT keeps track of it
+ *      for a block that is decrypted piece by piece.
+ *
+ *      Besides the scalar reference implementation there are SSE2, AVX2 and
+ *      AVX-512 versions. Decrypt() picks the fastest one the CPU supports.
+ *
+ *      DecryptCopy() decrypts while copying, for data that is read out of a
+ *      mapped archive: every byte is loaded once and stored once, instead of
+ *      being copied first and then decrypted in place. Large copies use
+ *      non-temporal stores, which bypass the cache.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DECRYPT_H_
+#define DECRYPT_H_
+
+/* Vector kernels only exist for x86, and need a compiler that knows the intrinsics */
+#if defined(_M_IX86) || defined(_M_X64)
+#define DECRYPT_HAVE_SSE2
+#if _MSC_VER >= 1700
+#define DECRYPT_HAVE_AVX2
+#endif
+#if _MSC_VER >= 1911
+#define DECRYPT_HAVE_AVX512
+#endif
+#endif
+
+/*
+ * Signature shared by every decryption kernel. 'offset' is the position of
+ * the first byte of 'buffer' inside the encrypted block.
+ */
+typedef void (*FPDecrypt)(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*
+ * Signature shared by every copying kernel. 'streaming' selects
+ * non-temporal stores.
+ */
+typedef void (*FPDecryptCopy)(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2,
+                              unsigned int offset, int streaming);
+
+/*
+ * A kernel the CPU supports, with its copying variant.
+ */
+typedef struct t_decryptkernel {
+    const char      *name;
+    FPDecrypt       decrypt;
+    FPDecryptCopy   decryptCopy;
+} DECRYPT_KERNEL;
+
+/* Scalar, SSE2, AVX2 and AVX-512 */
+#define DECRYPT_MAX_KERNELS         4
+
+/* Copies this large are written past the cache, they would not fit into it anyway */
+#define DECRYPT_STREAM_THRESHOLD    (4 * 1024 * 1024)
+
+/*
+ * Keys and stream position of a block that is decrypted in pieces.
+ */
+typedef struct t_ciphercontext {
+    unsigned int    key1;
+    unsigned int    key2;
+    unsigned int    offset;         /* Position of the next byte in the block */
+} CIPHER_CONTEXT;
+
+/*--------------------------------------------------------------------------
+ * Decrypts 'buffer' of size 'byteCount' using 'key1' and 'key2' as
+ * decryption keys.
+ *
+ * These keys are more or less specific to the file.
+ *
+ * Arguments:       buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *-------------------------------------------------------------------------*/
+void Decrypt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2);
+
+/*--------------------------------------------------------------------------
+ * Decrypts 'buffer', which starts 'offset' bytes into an encrypted block.
+ * Decrypting a block in several pieces this way gives the same result as
+ * decrypting it at once.
+ *
+ * Arguments:       buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'buffer' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptAt(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*--------------------------------------------------------------------------
+ * Copies 'byteCount' bytes from 'source' to 'dest' and decrypts them on the
+ * way, as if they started 'offset' bytes into an encrypted block. The two
+ * buffers must not overlap, unless they are the same. Copies of at least
+ * DECRYPT_STREAM_THRESHOLD bytes use non-temporal stores.
+ *
+ * Arguments:       dest            Receives the decrypted data
+ *                  source          Encrypted data
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'source' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptCopy(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*--------------------------------------------------------------------------
+ * Same as DecryptCopy(), but always uses non-temporal stores, for a 'dest'
+ * that won't be read again soon, like a mapped output file.
+ *
+ * Arguments:       dest            Receives the decrypted data
+ *                  source          Encrypted data
+ *                  byteCount       Size of data
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position of 'source' inside the block
+ *-------------------------------------------------------------------------*/
+void DecryptCopyStreaming(void *dest, const void *source, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*--------------------------------------------------------------------------
+ * Prepares 'context' for a block whose next byte is at 'offset'.
+ *
+ * Arguments:       context         Context to initialize
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  offset          Position inside the block, usually 0
+ *-------------------------------------------------------------------------*/
+void InitCipher(CIPHER_CONTEXT *context, unsigned int key1, unsigned int key2, unsigned int offset);
+
+/*--------------------------------------------------------------------------
+ * Decrypts the next 'byteCount' bytes of the block and moves the position
+ * of 'context' past them.
+ *
+ * Arguments:       context         Context from InitCipher()
+ *                  buffer          Data to decrypt
+ *                  byteCount       Size of data
+ *-------------------------------------------------------------------------*/
+void DecryptStream(CIPHER_CONTEXT *context, void *buffer, unsigned int byteCount);
+
+/*--------------------------------------------------------------------------
+ * Selects the kernels used by Decrypt() and DecryptCopy() based on what the
+ * CPU supports. It is called automatically the first time one of them runs,
+ * calling it again is harmless.
+ *-------------------------------------------------------------------------*/
+void InitDecrypt(void);
+
+/*--------------------------------------------------------------------------
+ * Fills 'kernels' with every kernel the CPU supports, the scalar reference
+ * first and the fastest last, and returns how many there are. Used to check
+ * the kernels against each other.
+ *
+ * Arguments:       kernels         Receives the kernels
+ *-------------------------------------------------------------------------*/
+unsigned int GetDecryptKernels(DECRYPT_KERNEL kernels[DECRYPT_MAX_KERNELS]);
+
+/*--------------------------------------------------------------------------
+ * Returns the name of the kernel used by Decrypt() ("scalar", "sse2",
+ * "avx2" or "avx512").
+ *-------------------------------------------------------------------------*/
+const char *GetDecryptKernelName(void);
+
+/*--------------------------------------------------------------------------
+ * The individual kernels. They take the same arguments as DecryptAt() and
+ * give the same results; DecryptScalar is the reference. A vector kernel may only
+ * be called if the CPU supports it.
+ *-------------------------------------------------------------------------*/
+void DecryptScalar(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+
+#ifdef DECRYPT_HAVE_SSE2
+void DecryptSSE2(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+#endif
+
+#ifdef DECRYPT_HAVE_AVX2
+void DecryptAVX2(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+#endif
+
+#ifdef DECRYPT_HAVE_AVX512
+void DecryptAVX512(void *buffer, unsigned int byteCount, unsigned int key1, unsigned int key2, unsigned int offset);
+#endif
+
+#endif
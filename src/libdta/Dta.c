@@ -0,0 +1,1003 @@
+/*  Description:
+ *      Implementation of libdta. The archive is mapped read-only, file data
+ *      is decrypted by DecryptCopy() on its way out of the mapped view and
+ *      decoded by DecodeBlock(), and the content table is parsed once when
+ *      the archive is opened.
+ *
+ *      The whole archive is mapped at once if the address space allows it.
+ *      A 32-bit process often can't find a few GB in one piece, so then every
+ *      read maps a window of at most 'viewSize' bytes around the bytes it
+ *      needs, and unmaps it again before returning.
+ *
+ *      Reading the file headers and names touches the whole archive, so they
+ *      can be kept in a sidecar (see IndexFile.h) and read from there on the
+ *      next open.
+ *
+ *      File data is stored directly after the file header and its filename,
+ *      as a chain of blocks (see DTA_BLOCK_HEADER). The position of a block
+ *      is only known from the sizes of the blocks before it, so a reader
+ *      remembers where the next one starts, and skipping ahead only reads
+ *      the headers. Blocks of an unencrypted entry are decoded straight out
+ *      of the mapped archive when it is mapped as a whole.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Dta.h"
+#include "Decode.h"
+#include "IndexFile.h"
+
+/* Largest stored size of a block, its header keeps it in a WORD */
+#define DTA_MAX_STORED_SIZE     0x10000
+
+/*
+ * PrefetchVirtualMemory and its range structure, which only exist in the
+ * Windows 8 SDK. The function is looked up when an archive is opened.
+ */
+typedef struct t_prefetchrange {
+    PVOID   virtualAddress;
+    SIZE_T  numberOfBytes;
+} PREFETCH_RANGE;
+
+typedef BOOL (WINAPI *FPPrefetchVirtualMemory)(HANDLE process, ULONG_PTR numberOfEntries, PREFETCH_RANGE *entries, ULONG flags);
+
+/*
+ * An entry of the lookup table, sorted by name.
+ */
+typedef struct t_dtanameref {
+    const char  *name;
+    DWORD       record;
+} DTA_NAME_REF;
+
+/*
+ * Bytes of the archive mapped for a single read.
+ */
+typedef struct t_dtaview {
+    const unsigned char     *window;        /* Start of the window, NULL if the whole archive is mapped */
+    const unsigned char     *data;          /* First byte asked for */
+} DTA_VIEW;
+
+struct t_dtaarchive {
+    HANDLE                  hFile;
+    HANDLE                  hMapping;
+    const unsigned char     *base;          /* Whole archive, NULL if it is mapped in windows */
+    DWORD                   size;
+    DWORD                   viewSize;       /* Largest window, if 'base' is NULL */
+    DWORD                   granularity;    /* Windows have to start at a multiple of it */
+    unsigned int            key1;
+    unsigned int            key2;
+
+    DTA_RECORD              *records;       /* Sorted by file offset */
+    DWORD                   numOfRecords;
+    char                    *names;
+    DWORD                   namesSize;
+    DTA_NAME_REF            *byName;
+
+    FPPrefetchVirtualMemory prefetchVirtualMemory;
+};
+
+/*----------------------------------------------------------------------------
+ * qsort callback, orders content headers by the offset of the entry.
+ *--------------------------------------------------------------------------*/
+static int CompareContentOffsets(const void *a, const void *b) {
+    DWORD left  = ((const DTA_CONTENT_HEADER *)a)->fileOffset;
+    DWORD right = ((const DTA_CONTENT_HEADER *)b)->fileOffset;
+
+    return left < right ? -1 : left > right;
+}
+
+/*----------------------------------------------------------------------------
+ * qsort/bsearch callback ordering the lookup table by name. Paths inside
+ * the archive are case insensitive.
+ *--------------------------------------------------------------------------*/
+static int CompareNames(const void *a, const void *b) {
+    return _stricmp(((const DTA_NAME_REF *)a)->name, ((const DTA_NAME_REF *)b)->name);
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the record 'index' of 'archive'.
+ *--------------------------------------------------------------------------*/
+static void FillEntryInfo(const DTA_ARCHIVE *archive, DWORD index, DTA_ENTRY_INFO *info) {
+    const DTA_RECORD *record = &archive->records[index];
+
+    info->name          = archive->names + record->nameOffset;
+    info->fileSize      = record->fileSize;
+    info->fileOffset    = record->fileOffset;
+    info->dataOffset    = record->dataOffset;
+    info->storedSize    = record->storedSize;
+    info->numOfBlocks   = record->numOfBlocks;
+    info->encrypted     = (record->flags & DTA_FILE_ENCRYPTED) != 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Maps the file of 'archive' into memory, as a whole if 'viewSize' is 0 and
+ * the address space has room for it, in windows of 'viewSize' bytes
+ * otherwise. Returns FALSE and sets 'error' if it can't be.
+ *--------------------------------------------------------------------------*/
+static BOOL MapArchive(DTA_ARCHIVE *archive, const char *filename, DWORD viewSize, char error[DTA_ERROR_LENGTH]) {
+    LARGE_INTEGER   fileSize;
+    SYSTEM_INFO     systemInfo;
+
+    /* Most reads go front to back, so let the cache manager read ahead */
+    archive->hFile = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if(archive->hFile == INVALID_HANDLE_VALUE) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Failed to open the requested .dta file", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* Offsets inside of an archive are 32-bit, so larger files can't be valid */
+    if(!GetFileSizeEx(archive->hFile, &fileSize) || fileSize.QuadPart < sizeof(int) + sizeof(DTA_HEADER) ||
+       fileSize.QuadPart > 0xFFFFFFFF) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The file is too small or too large to be an archive", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    archive->size       = (DWORD)fileSize.QuadPart;
+    archive->hMapping   = CreateFileMapping(archive->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if(archive->hMapping == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The archive could not be mapped into memory", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    if(viewSize == 0 && (archive->base = (const unsigned char *)MapViewOfFile(archive->hMapping, FILE_MAP_READ, 0, 0, 0)) != NULL)
+        return TRUE;
+
+    GetSystemInfo(&systemInfo);
+
+    /* Round the window up to whole allocation units */
+    archive->granularity    = systemInfo.dwAllocationGranularity;
+    viewSize                = viewSize != 0 ? viewSize : DTA_DEFAULT_VIEW_SIZE;
+    archive->viewSize       = (viewSize + archive->granularity - 1) / archive->granularity * archive->granularity;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Points 'view' at 'size' bytes of 'archive' starting at 'offset'. The range
+ * has to lie inside of the archive, and be no larger than 'viewSize' if the
+ * archive is mapped in windows. Returns FALSE if the window can't be mapped.
+ *--------------------------------------------------------------------------*/
+static BOOL MapRange(const DTA_ARCHIVE *archive, DWORD offset, DWORD size, DTA_VIEW *view) {
+    DWORD start;
+
+    view->window = NULL;
+
+    if(archive->base != NULL) {
+        view->data = archive->base + offset;
+        return TRUE;
+    }
+
+    start           = offset - offset % archive->granularity;
+    view->window    = (const unsigned char *)MapViewOfFile(archive->hMapping, FILE_MAP_READ, 0, start, offset - start + size);
+
+    if(view->window == NULL)
+        return FALSE;
+
+    view->data = view->window + (offset - start);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Unmaps the window of a view set up by MapRange.
+ *--------------------------------------------------------------------------*/
+static void UnmapRange(DTA_VIEW *view) {
+    if(view->window != NULL)
+        UnmapViewOfFile(view->window);
+}
+
+/*----------------------------------------------------------------------------
+ * Copies 'size' bytes of 'archive' starting at 'offset' into 'buffer', a
+ * window at a time. The bytes are decrypted as if the key sequence started
+ * 'keyOffset' bytes before 'offset', unless 'decrypt' is FALSE. The range
+ * has to lie inside of the archive. Returns the number of bytes copied,
+ * fewer than asked for only if a window couldn't be mapped.
+ *--------------------------------------------------------------------------*/
+static DWORD CopyRange(const DTA_ARCHIVE *archive, DWORD offset, void *buffer, DWORD size, BOOL decrypt, DWORD keyOffset) {
+    DWORD copied = 0;
+
+    while(copied < size) {
+        DWORD       n = archive->base != NULL ? size - copied : min(size - copied, archive->viewSize);
+        DTA_VIEW    view;
+
+        if(!MapRange(archive, offset + copied, n, &view))
+            break;
+
+        if(decrypt)
+            DecryptCopy((char *)buffer + copied, view.data, n, archive->key1, archive->key2, keyOffset + copied);
+        else
+            memcpy((char *)buffer + copied, view.data, n);
+
+        UnmapRange(&view);
+        copied += n;
+    }
+
+    return copied;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads and decrypts the header and the content table of 'archive'. The
+ * table is allocated and has to be released with free(). Returns FALSE and
+ * sets 'error' if they can't be read.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadContentTable(DTA_ARCHIVE *archive, DTA_HEADER *header, DTA_CONTENT_HEADER **contentHeaders, char error[DTA_ERROR_LENGTH]) {
+    int identifier;
+
+    if(CopyRange(archive, 0, &identifier, sizeof(int), FALSE, 0) != sizeof(int) ||
+       CopyRange(archive, sizeof(int), header, sizeof(DTA_HEADER), TRUE, 0) != sizeof(DTA_HEADER)) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The archive could not be mapped into memory", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    if(identifier != TRUE_DTA_IDENTIFIER) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "File did not begin with \"ISD0\"", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    /* Wrong keys give a garbage header, don't allocate anything for it */
+    if(!DtaIsHeaderPlausible(header, archive->size)) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The header doesn't fit the archive, the keys are probably wrong", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    *contentHeaders = (DTA_CONTENT_HEADER *)malloc(sizeof(DTA_CONTENT_HEADER) * header->numOfFiles + 1);
+
+    if(*contentHeaders == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the entries", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    if(CopyRange(archive, header->contentOffset, *contentHeaders, sizeof(DTA_CONTENT_HEADER) * header->numOfFiles, TRUE, 0) !=
+       sizeof(DTA_CONTENT_HEADER) * header->numOfFiles) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "The archive could not be mapped into memory", DTA_ERROR_LENGTH);
+        free(*contentHeaders);
+        *contentHeaders = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Sets the stored size of every record of 'archive', which are sorted by
+ * file offset, to the bytes up to the next entry. The content table follows
+ * the last entry, or the end of the archive if it doesn't.
+ *--------------------------------------------------------------------------*/
+static void SetStoredSizes(DTA_ARCHIVE *archive, DWORD contentOffset) {
+    DWORD end = archive->size;
+    DWORD i;
+
+    for(i = archive->numOfRecords; i-- > 0; ) {
+        DTA_RECORD *record = &archive->records[i];
+
+        /* Entries listed twice share their blocks, and so their end */
+        if(i + 1 == archive->numOfRecords && contentOffset >= record->dataOffset)
+            end = contentOffset;
+        else if(i + 1 < archive->numOfRecords && archive->records[i + 1].fileOffset > record->fileOffset)
+            end = archive->records[i + 1].fileOffset;
+
+        record->storedSize = end >= record->dataOffset ? end - record->dataOffset : 0;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Walks the content table of 'archive' in file order and fills its records
+ * and names from the file headers. Sorts 'contentHeaders' on the way.
+ * 'contentOffset' bounds the blocks of the last entry. Returns FALSE and
+ * sets 'error' if there is no memory for the entries.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadRecords(DTA_ARCHIVE *archive, DTA_CONTENT_HEADER *contentHeaders, DWORD numOfFiles, DWORD contentOffset,
+                        char error[DTA_ERROR_LENGTH]) {
+    DWORD poolSize = max(numOfFiles * 32, 1024);
+    DWORD i;
+
+    archive->records    = (DTA_RECORD *)malloc(sizeof(DTA_RECORD) * numOfFiles + 1);
+    archive->names      = (char *)malloc(poolSize);
+
+    if(archive->records == NULL || archive->names == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the entries", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    qsort(contentHeaders, numOfFiles, sizeof(DTA_CONTENT_HEADER), CompareContentOffsets);
+
+    for(i = 0; i < numOfFiles; ++i) {
+        DTA_FILE_HEADER fileHeader;
+        DTA_RECORD      *record = &archive->records[archive->numOfRecords];
+        DWORD           pos     = contentHeaders[i].fileOffset;
+        DWORD           length;
+
+        /* An entry that points outside of the archive is left out */
+        if(pos > archive->size || archive->size - pos < sizeof(DTA_FILE_HEADER))
+            continue;
+
+        if(CopyRange(archive, pos, &fileHeader, sizeof(DTA_FILE_HEADER), TRUE, 0) != sizeof(DTA_FILE_HEADER))
+            continue;
+
+        /* The blocks are only checked when they are read */
+        length = DTA_FILENAME_LENGTH(&fileHeader);
+
+        if(archive->size - pos - sizeof(DTA_FILE_HEADER) < length)
+            continue;
+
+        while(poolSize - archive->namesSize < length + 1) {
+            char *names = (char *)realloc(archive->names, poolSize * 2);
+
+            if(names == NULL) {
+                strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the entries", DTA_ERROR_LENGTH);
+                return FALSE;
+            }
+
+            archive->names = names;
+            poolSize *= 2;
+        }
+
+        if(CopyRange(archive, pos + sizeof(DTA_FILE_HEADER), archive->names + archive->namesSize, length, TRUE, 0) != length)
+            continue;
+
+        archive->names[archive->namesSize + length] = '\0';
+
+        record->fileOffset  = pos;
+        record->dataOffset  = pos + sizeof(DTA_FILE_HEADER) + length;
+        record->fileSize    = fileHeader.fileSize;
+        record->nameOffset  = archive->namesSize;
+        record->numOfBlocks = fileHeader.numOfBlocks;
+        record->flags       = fileHeader.filenameLength & DTA_FILE_ENCRYPTED;
+
+        archive->namesSize += length + 1;
+        ++archive->numOfRecords;
+    }
+
+    SetStoredSizes(archive, contentOffset);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills the records and names of 'archive', from the sidecar 'indexFile' if
+ * it is given and still belongs to the archive, and from the archive itself
+ * otherwise. In the latter case the sidecar is written for the next open.
+ * Returns FALSE and sets 'error' if the entries can't be read.
+ *--------------------------------------------------------------------------*/
+static BOOL LoadRecords(DTA_ARCHIVE *archive, const char *indexFile, char error[DTA_ERROR_LENGTH]) {
+    DTA_HEADER          header;
+    DTA_CONTENT_HEADER  *contentHeaders;
+    DTA_INDEX_HEADER    key;
+    BOOL                useIndex;
+
+    if(!ReadContentTable(archive, &header, &contentHeaders, error))
+        return FALSE;
+
+    /* The key hashes the table as it is stored, so take it before sorting */
+    useIndex = indexFile != NULL && InitIndexKey(&key, archive->hFile, contentHeaders, header.numOfFiles);
+
+    if(useIndex && LoadIndexFile(indexFile, &key, &archive->records, &archive->numOfRecords, &archive->names, &archive->namesSize)) {
+        free(contentHeaders);
+        return TRUE;
+    }
+
+    if(!ReadRecords(archive, contentHeaders, header.numOfFiles, header.contentOffset, error)) {
+        free(contentHeaders);
+        return FALSE;
+    }
+
+    free(contentHeaders);
+
+    if(useIndex)
+        SaveIndexFile(indexFile, &key, archive->records, archive->numOfRecords, archive->names, archive->namesSize);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Builds the lookup table of 'archive'. The names pool doesn't move any
+ * more, so the table can point into it. Returns FALSE and sets 'error' if
+ * there is no memory for it.
+ *--------------------------------------------------------------------------*/
+static BOOL BuildLookup(DTA_ARCHIVE *archive, char error[DTA_ERROR_LENGTH]) {
+    DWORD i;
+
+    archive->byName = (DTA_NAME_REF *)malloc(sizeof(DTA_NAME_REF) * archive->numOfRecords + 1);
+
+    if(archive->byName == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the entries", DTA_ERROR_LENGTH);
+        return FALSE;
+    }
+
+    for(i = 0; i < archive->numOfRecords; ++i) {
+        archive->byName[i].name     = archive->names + archive->records[i].nameOffset;
+        archive->byName[i].record   = i;
+    }
+
+    qsort(archive->byName, archive->numOfRecords, sizeof(DTA_NAME_REF), CompareNames);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Allocates the block buffers of 'reader' if it has none yet. Returns FALSE
+ * if there is no memory for them.
+ *--------------------------------------------------------------------------*/
+static BOOL AllocateBlockBuffers(DTA_READER *reader) {
+    if(reader->stored == NULL && (reader->stored = (unsigned char *)malloc(DTA_MAX_STORED_SIZE + DTA_BLOCK_SIZE)) == NULL)
+        return FALSE;
+
+    reader->decoded = reader->stored + DTA_MAX_STORED_SIZE;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the header of the block at 'offset' of the archive of 'reader' and
+ * checks that its stored bytes lie inside of the entry. Returns FALSE if
+ * they don't.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadBlockHeader(const DTA_READER *reader, DWORD offset, DTA_BLOCK_HEADER *header) {
+    DWORD end = reader->entry.dataOffset + reader->entry.storedSize;
+
+    if(offset > end || end - offset < sizeof(DTA_BLOCK_HEADER) ||
+       CopyRange(reader->archive, offset, header, sizeof(DTA_BLOCK_HEADER), FALSE, 0) != sizeof(DTA_BLOCK_HEADER))
+        return FALSE;
+
+    return end - offset - sizeof(DTA_BLOCK_HEADER) >= header->storedSize;
+}
+
+/*----------------------------------------------------------------------------
+ * Moves 'reader' to the header of the block 'block', starting over at the
+ * first block if it is behind. Only the headers in between are read.
+ * Returns FALSE if the chain of blocks is broken before it.
+ *--------------------------------------------------------------------------*/
+static BOOL FindBlock(DTA_READER *reader, DWORD block) {
+    if(block >= reader->entry.numOfBlocks)
+        return FALSE;
+
+    if(block < reader->block) {
+        reader->block       = 0;
+        reader->blockOffset = reader->entry.dataOffset;
+    }
+
+    while(reader->block < block) {
+        DTA_BLOCK_HEADER header;
+
+        if(!ReadBlockHeader(reader, reader->blockOffset, &header))
+            return FALSE;
+
+        reader->blockOffset += sizeof(DTA_BLOCK_HEADER) + header.storedSize;
+        ++reader->block;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies the stored bytes of a block into the buffer of 'reader',
+ * decrypted, and returns them. The WAV header of a first block is always
+ * decrypted. Returns NULL if they can't be read.
+ *--------------------------------------------------------------------------*/
+static const unsigned char *CopyBlock(DTA_READER *reader, DWORD block, DWORD offset, DWORD size) {
+    const DTA_ARCHIVE *archive = reader->archive;
+
+    if(!AllocateBlockBuffers(reader) || CopyRange(archive, offset, reader->stored, size, reader->entry.encrypted, 0) != size)
+        return NULL;
+
+    if(block == 0 && !reader->entry.encrypted)
+        UnmaskWavHeader(reader->stored, size, archive->key1, archive->key2);
+
+    return reader->stored;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the WAV header from the first block of the entry of 'reader', for a
+ * sound block further on. Returns FALSE if the first block isn't a sound.
+ *--------------------------------------------------------------------------*/
+static BOOL ReadWavHeader(DTA_READER *reader) {
+    DTA_BLOCK_HEADER    header;
+    unsigned char       start[1 + DTA_WAV_HEADER_SIZE];
+
+    if(!ReadBlockHeader(reader, reader->entry.dataOffset, &header) || header.storedSize < sizeof(start) ||
+       CopyRange(reader->archive, reader->entry.dataOffset + sizeof(DTA_BLOCK_HEADER), start, sizeof(start),
+                 reader->entry.encrypted, 0) != sizeof(start))
+        return FALSE;
+
+    if(!reader->entry.encrypted)
+        UnmaskWavHeader(start, sizeof(start), reader->archive->key1, reader->archive->key2);
+
+    if(start[0] < DTA_BLOCK_AUDIO)
+        return FALSE;
+
+    memcpy(reader->wavHeader, start + 1, DTA_WAV_HEADER_SIZE);
+    reader->haveWavHeader = TRUE;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Decodes the block 'block' of the entry of 'reader' into 'out', which
+ * holds 'size' bytes, the decoded size of the block. Returns FALSE if the
+ * block can't be read or doesn't decode to exactly that size.
+ *--------------------------------------------------------------------------*/
+static BOOL DecodeEntryBlock(DTA_READER *reader, DWORD block, unsigned char *out, DWORD size) {
+    const DTA_ARCHIVE       *archive = reader->archive;
+    const unsigned char     *stored;
+    DTA_BLOCK_HEADER        header;
+    DWORD                   offset;
+    DWORD                   decoded;
+
+    if(!FindBlock(reader, block) || !ReadBlockHeader(reader, reader->blockOffset, &header) || header.storedSize == 0)
+        return FALSE;
+
+    offset = reader->blockOffset + sizeof(DTA_BLOCK_HEADER);
+
+    /* Plain blocks of a mapped archive don't need a copy, unless they hold the masked WAV header */
+    if(archive->base != NULL && !reader->entry.encrypted && (block != 0 || archive->base[offset] < DTA_BLOCK_AUDIO))
+        stored = archive->base + offset;
+    else if((stored = CopyBlock(reader, block, offset, header.storedSize)) == NULL)
+        return FALSE;
+
+    if(stored[0] >= DTA_BLOCK_AUDIO && !reader->haveWavHeader) {
+        if(block == 0 && header.storedSize >= 1 + DTA_WAV_HEADER_SIZE) {
+            memcpy(reader->wavHeader, stored + 1, DTA_WAV_HEADER_SIZE);
+            reader->haveWavHeader = TRUE;
+        } else if(block != 0) {
+            ReadWavHeader(reader);
+        }
+    }
+
+    if(!DecodeBlock(stored, header.storedSize, reader->haveWavHeader ? reader->wavHeader : NULL, out, size, &decoded) ||
+       decoded != size)
+        return FALSE;
+
+    reader->blockOffset = offset + header.storedSize;
+    ++reader->block;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Maps an archive into memory and reads its content table with the given
+ * keys. Entries that point outside of the archive are left out. If any
+ * errors occur, 'error' string is set and the function returns NULL.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  error           Error string
+ *
+ *  Returns the archive, which has to be closed with DtaCloseArchive.
+ *--------------------------------------------------------------------------*/
+DTA_ARCHIVE *DtaOpenArchive(const char *filename, unsigned int key1, unsigned int key2, char error[DTA_ERROR_LENGTH]) {
+    return DtaOpenArchiveEx(filename, key1, key2, NULL, error);
+}
+
+/*----------------------------------------------------------------------------
+ * Like DtaOpenArchive, with the options in 'options'. NULL options behave
+ * like DtaOpenArchive.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  options         Options of the open, or NULL
+ *                  error           Error string
+ *
+ *  Returns the archive, which has to be closed with DtaCloseArchive.
+ *--------------------------------------------------------------------------*/
+DTA_ARCHIVE *DtaOpenArchiveEx(const char *filename, unsigned int key1, unsigned int key2, const DTA_OPEN_OPTIONS *options,
+                              char error[DTA_ERROR_LENGTH]) {
+    DTA_ARCHIVE *archive = (DTA_ARCHIVE *)calloc(1, sizeof(DTA_ARCHIVE));
+    DWORD       viewSize    = options != NULL ? options->viewSize : 0;
+    const char  *indexFile  = options != NULL ? options->indexFile : NULL;
+
+    if(archive == NULL) {
+        strncpy_s(error, DTA_ERROR_LENGTH, "Could not allocate memory for the archive", DTA_ERROR_LENGTH);
+        return NULL;
+    }
+
+    archive->hFile  = INVALID_HANDLE_VALUE;
+    archive->key1   = key1;
+    archive->key2   = key2;
+
+    if(!MapArchive(archive, filename, viewSize, error) || !LoadRecords(archive, indexFile, error) || !BuildLookup(archive, error)) {
+        DtaCloseArchive(archive);
+        return NULL;
+    }
+
+    archive->prefetchVirtualMemory = (FPPrefetchVirtualMemory)GetProcAddress(GetModuleHandle("kernel32.dll"), "PrefetchVirtualMemory");
+
+    return archive;
+}
+
+/*----------------------------------------------------------------------------
+ * Unmaps the archive and releases everything that belongs to it. Readers
+ * and entry names of the archive can't be used afterwards.
+ *
+ *  Arguments:      archive         Archive to close
+ *--------------------------------------------------------------------------*/
+void DtaCloseArchive(DTA_ARCHIVE *archive) {
+    if(archive == NULL)
+        return;
+
+    free(archive->records);
+    free(archive->names);
+    free(archive->byName);
+
+    if(archive->base != NULL)
+        UnmapViewOfFile(archive->base);
+
+    if(archive->hMapping != NULL)
+        CloseHandle(archive->hMapping);
+
+    if(archive->hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(archive->hFile);
+
+    free(archive);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'header' describes a content table that fits inside an
+ * archive of 'archiveSize' bytes. A header decrypted with the wrong keys
+ * practically never does.
+ *
+ *  Arguments:      header          Decrypted header
+ *                  archiveSize     Size of the archive
+ *--------------------------------------------------------------------------*/
+BOOL DtaIsHeaderPlausible(const DTA_HEADER *header, DWORD archiveSize) {
+    if(header->contentOffset < sizeof(int) + sizeof(DTA_HEADER) || header->contentOffset > archiveSize)
+        return FALSE;
+
+    return header->numOfFiles <= (archiveSize - header->contentOffset) / sizeof(DTA_CONTENT_HEADER);
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the size of the archive file.
+ *
+ *  Arguments:      archive         Open archive
+ *--------------------------------------------------------------------------*/
+DWORD DtaGetArchiveSize(const DTA_ARCHIVE *archive) {
+    return archive->size;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns the number of entries in the archive.
+ *
+ *  Arguments:      archive         Open archive
+ *--------------------------------------------------------------------------*/
+DWORD DtaGetEntryCount(const DTA_ARCHIVE *archive) {
+    return archive->numOfRecords;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the entry 'index', counted in archive order. Returns
+ * FALSE if there is no such entry.
+ *
+ *  Arguments:      archive         Open archive
+ *                  index           Entry to return
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaGetEntry(const DTA_ARCHIVE *archive, DWORD index, DTA_ENTRY_INFO *info) {
+    if(index >= archive->numOfRecords)
+        return FALSE;
+
+    FillEntryInfo(archive, index, info);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Starts a walk over every entry of the archive, in archive order.
+ *
+ *  Arguments:      archive         Open archive
+ *                  iterator        Iterator to set up
+ *--------------------------------------------------------------------------*/
+void DtaBeginEntries(const DTA_ARCHIVE *archive, DTA_ITERATOR *iterator) {
+    iterator->archive   = archive;
+    iterator->next      = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the next entry of the walk. Returns FALSE once every
+ * entry has been returned.
+ *
+ *  Arguments:      iterator        Iterator set up by DtaBeginEntries
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaNextEntry(DTA_ITERATOR *iterator, DTA_ENTRY_INFO *info) {
+    if(!DtaGetEntry(iterator->archive, iterator->next, info))
+        return FALSE;
+
+    ++iterator->next;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Looks up an entry by name, without regard to case. Returns FALSE if the
+ * archive has no such entry.
+ *
+ *  Arguments:      archive         Open archive
+ *                  name            Path inside the archive
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaFindEntry(const DTA_ARCHIVE *archive, const char *name, DTA_ENTRY_INFO *info) {
+    DTA_NAME_REF key;
+    DTA_NAME_REF *found;
+
+    key.name    = name;
+    found       = (DTA_NAME_REF *)bsearch(&key, archive->byName, archive->numOfRecords, sizeof(DTA_NAME_REF), CompareNames);
+
+    if(found == NULL)
+        return FALSE;
+
+    FillEntryInfo(archive, found->record, info);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads and decrypts the file header of an entry, for the fields that
+ * DTA_ENTRY_INFO leaves out. Returns FALSE if it can't be read.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry whose header to read
+ *                  header          Receives the header
+ *--------------------------------------------------------------------------*/
+BOOL DtaGetFileHeader(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DTA_FILE_HEADER *header) {
+    return CopyRange(archive, info->fileOffset, header, sizeof(DTA_FILE_HEADER), TRUE, 0) == sizeof(DTA_FILE_HEADER);
+}
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' decoded bytes of an entry, starting at 'offset'
+ * inside of it, into 'buffer'. Doesn't keep any position, so it may be
+ * called from any thread. The blocks before 'offset' aren't decoded, but
+ * the one 'offset' falls into is decoded whole.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to read
+ *                  offset          Position inside the entry
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for if a block
+ *  runs past the end of the archive or is corrupt.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadEntry(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DWORD offset, void *buffer, DWORD size) {
+    DTA_READER  reader;
+    DWORD       read;
+
+    DtaOpenReader(archive, info, &reader);
+    DtaSeek(&reader, offset, SEEK_SET);
+
+    read = DtaRead(&reader, buffer, size);
+
+    DtaCloseReader(&reader);
+
+    return read;
+}
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes of the archive as they are on the disk,
+ * starting at 'offset', into 'buffer'. May be called from any thread.
+ *
+ *  Arguments:      archive         Open archive
+ *                  offset          Position inside the archive
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadRaw(const DTA_ARCHIVE *archive, DWORD offset, void *buffer, DWORD size) {
+    if(offset >= archive->size)
+        return 0;
+
+    return CopyRange(archive, offset, buffer, min(size, archive->size - offset), FALSE, 0);
+}
+
+/*----------------------------------------------------------------------------
+ * Decodes a whole entry out of its stored bytes, which the caller copied
+ * with DtaReadRaw from 'info->dataOffset', at most 'info->storedSize' of
+ * them. This way the archive can be read by one thread and decoded by
+ * another. The stored bytes are decrypted in place. May be called from any
+ * thread.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to decode
+ *                  stored          Stored bytes of the entry
+ *                  storedSize      Number of stored bytes
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes decoded, fewer than the entry holds if a
+ *  block runs past 'storedSize' or is corrupt.
+ *--------------------------------------------------------------------------*/
+DWORD DtaDecodeEntry(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, void *stored, DWORD storedSize, void *buffer,
+                     DWORD size) {
+    unsigned char       *pos        = (unsigned char *)stored;
+    DWORD               left        = storedSize;
+    const unsigned char *wavHeader  = NULL;
+    DWORD               copied      = 0;
+    DWORD               block;
+
+    size = min(size, info->fileSize);
+
+    for(block = 0; block < info->numOfBlocks && copied < size; ++block) {
+        DTA_BLOCK_HEADER    header;
+        unsigned char       *data;
+        DWORD               blockSize   = min(DTA_BLOCK_SIZE, info->fileSize - block * DTA_BLOCK_SIZE);
+        DWORD               capacity    = min(blockSize, size - copied);
+        DWORD               decoded;
+
+        if(left < sizeof(DTA_BLOCK_HEADER))
+            break;
+
+        memcpy(&header, pos, sizeof(DTA_BLOCK_HEADER));
+        data = pos + sizeof(DTA_BLOCK_HEADER);
+        left -= sizeof(DTA_BLOCK_HEADER);
+
+        if(header.storedSize == 0 || header.storedSize > left)
+            break;
+
+        if(info->encrypted)
+            Decrypt(data, header.storedSize, archive->key1, archive->key2);
+        else if(block == 0)
+            UnmaskWavHeader(data, header.storedSize, archive->key1, archive->key2);
+
+        /* Later sound blocks take their format from the first one, which isn't changed by decoding */
+        if(block == 0 && data[0] >= DTA_BLOCK_AUDIO && header.storedSize >= 1 + DTA_WAV_HEADER_SIZE)
+            wavHeader = data + 1;
+
+        if(!DecodeBlock(data, header.storedSize, wavHeader, (unsigned char *)buffer + copied, capacity, &decoded) ||
+           decoded != capacity)
+            break;
+
+        copied  += capacity;
+        pos     = data + header.storedSize;
+        left    -= header.storedSize;
+    }
+
+    return copied;
+}
+
+/*----------------------------------------------------------------------------
+ * Sets 'reader' up to read an entry from its first byte, decoded, or the
+ * whole raw archive if 'info' is NULL.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to read, or NULL
+ *                  reader          Reader to set up
+ *--------------------------------------------------------------------------*/
+void DtaOpenReader(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DTA_READER *reader) {
+    memset(reader, 0, sizeof(DTA_READER));
+
+    reader->archive         = archive;
+    reader->size            = info != NULL ? info->fileSize : archive->size;
+    reader->raw             = info == NULL;
+    reader->decodedBlock    = DTA_NO_BLOCK;
+
+    if(info != NULL) {
+        reader->entry       = *info;
+        reader->blockOffset = info->dataOffset;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes from the position of 'reader' into 'buffer'
+ * and advances the position.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for at the end of
+ *  the entry or if a block can't be decoded.
+ *--------------------------------------------------------------------------*/
+DWORD DtaRead(DTA_READER *reader, void *buffer, DWORD size) {
+    DWORD copied = 0;
+
+    size = min(size, reader->size - reader->pos);
+
+    if(reader->raw) {
+        size = CopyRange(reader->archive, reader->pos, buffer, size, FALSE, 0);
+        reader->pos += size;
+
+        return size;
+    }
+
+    while(copied < size) {
+        DWORD block     = reader->pos / DTA_BLOCK_SIZE;
+        DWORD skip      = reader->pos % DTA_BLOCK_SIZE;
+        DWORD blockSize = min(DTA_BLOCK_SIZE, reader->size - block * DTA_BLOCK_SIZE);
+        DWORD n;
+
+        if(block != reader->decodedBlock) {
+            /* A whole block the caller asked for is decoded straight into its buffer */
+            if(skip == 0 && size - copied >= blockSize) {
+                if(!DecodeEntryBlock(reader, block, (unsigned char *)buffer + copied, blockSize))
+                    break;
+
+                reader->pos += blockSize;
+                copied      += blockSize;
+                continue;
+            }
+
+            reader->decodedBlock = DTA_NO_BLOCK;
+
+            if(!AllocateBlockBuffers(reader) || !DecodeEntryBlock(reader, block, reader->decoded, blockSize))
+                break;
+
+            reader->decodedBlock = block;
+        }
+
+        n = min(blockSize - skip, size - copied);
+        memcpy((unsigned char *)buffer + copied, reader->decoded + skip, n);
+
+        reader->pos += n;
+        copied      += n;
+    }
+
+    return copied;
+}
+
+/*----------------------------------------------------------------------------
+ * Moves the position of 'reader'. Behaves like fseek, positions past the
+ * end are clamped to the end.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *                  offset          Relative offset from 'origin', negative
+ *                                  offsets are passed as a cast LONG
+ *                  origin          SEEK_SET, SEEK_CUR or SEEK_END
+ *--------------------------------------------------------------------------*/
+void DtaSeek(DTA_READER *reader, DWORD offset, DWORD origin) {
+    __int64 pos;
+
+    switch(origin) {
+    case SEEK_CUR:  pos = (__int64)reader->pos + (LONG)offset;  break;
+    case SEEK_END:  pos = (__int64)reader->size + (LONG)offset; break;
+    default:        pos = offset;                               break;
+    }
+
+    if(pos < 0)
+        pos = 0;
+    else if(pos > reader->size)
+        pos = reader->size;
+
+    reader->pos = (DWORD)pos;
+}
+
+/*----------------------------------------------------------------------------
+ * Releases the buffers of 'reader'. It can be set up again afterwards.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *--------------------------------------------------------------------------*/
+void DtaCloseReader(DTA_READER *reader) {
+    free(reader->stored);
+
+    reader->stored          = NULL;
+    reader->decoded         = NULL;
+    reader->decodedBlock    = DTA_NO_BLOCK;
+}
+
+/*----------------------------------------------------------------------------
+ * Asks the system to read a region of the archive into memory ahead of
+ * time. Does nothing before Windows 8, which lacks PrefetchVirtualMemory,
+ * or if the archive is mapped in windows.
+ *
+ *  Arguments:      archive         Open archive
+ *                  offset          Offset of the region
+ *                  size            Size of the region
+ *--------------------------------------------------------------------------*/
+void DtaPrefetch(const DTA_ARCHIVE *archive, DWORD offset, DWORD size) {
+    PREFETCH_RANGE range;
+
+    /* Windows are only mapped while they are read */
+    if(archive->prefetchVirtualMemory == NULL || archive->base == NULL || offset >= archive->size)
+        return;
+
+    range.virtualAddress    = (PVOID)(archive->base + offset);
+    range.numberOfBytes     = min(size, archive->size - offset);
+
+    archive->prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
@@ -0,0 +1,312 @@
+/*  Description:
+ *      libdta, the archive code of DTAUnpacker as a library that can be
+ *      linked into other tools. An archive is opened once, its entries can
+ *      then be walked or looked up by name, and their contents read straight
+ *      into memory owned by the caller.
+ *
+ *      The library keeps no state of its own: everything lives in the
+ *      DTA_ARCHIVE returned by DtaOpenArchive. An open archive is never
+ *      modified, so any number of threads may look entries up and read
+ *      them at the same time. A DTA_READER keeps a stream position, and
+ *      belongs to the thread that uses it.
+ *
+ *      Functions that can fail return FALSE (or NULL) and set 'error', the
+ *      way the rest of the code does.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef DTA_H_
+#define DTA_H_
+
+#include <windows.h>
+#include "DTAFormat.h"
+#include "Decrypt.h"
+
+/* Length of an error string */
+#define DTA_ERROR_LENGTH    128
+
+/* Window mapped by a read if the whole archive doesn't fit the address space */
+#define DTA_DEFAULT_VIEW_SIZE   (64 * 1024 * 1024)
+
+/* Appended to the archive path to name its sidecar of entries */
+#define DTA_INDEX_EXTENSION     ".dtaidx"
+
+/*
+ * An open archive. The members are private to the library.
+ */
+typedef struct t_dtaarchive DTA_ARCHIVE;
+
+/*
+ * Options of DtaOpenArchiveEx. Zeroed options behave like DtaOpenArchive.
+ */
+typedef struct t_dtaopenoptions {
+    DWORD       viewSize;           /* Largest mapped window, 0 maps the whole archive if possible */
+    const char  *indexFile;         /* Sidecar of the entries, NULL to always read them from the archive */
+} DTA_OPEN_OPTIONS;
+
+/*
+ * A single file inside the archive. 'name' points into the archive and is
+ * valid until the archive is closed.
+ */
+typedef struct t_dtaentryinfo {
+    const char  *name;
+    DWORD       fileSize;           /* Size once decoded */
+    DWORD       fileOffset;         /* Offset of the file header */
+    DWORD       dataOffset;         /* Offset of the first block */
+    DWORD       storedSize;         /* Bytes from 'dataOffset' up to the next entry, the blocks lie within */
+    DWORD       numOfBlocks;
+    BOOL        encrypted;          /* The blocks are encrypted */
+} DTA_ENTRY_INFO;
+
+/*
+ * Position of a walk over the entries, in archive order.
+ */
+typedef struct t_dtaiterator {
+    const DTA_ARCHIVE   *archive;
+    DWORD               next;
+} DTA_ITERATOR;
+
+/*
+ * Sequential reader of a single entry, or of the raw archive. An entry is
+ * decoded a block at a time, so a reader holds on to buffers once it had
+ * to decode a block that wasn't asked for whole, and has to be closed with
+ * DtaCloseReader.
+ */
+typedef struct t_dtareader {
+    const DTA_ARCHIVE   *archive;
+    DTA_ENTRY_INFO      entry;
+    DWORD               size;
+    DWORD               pos;
+    BOOL                raw;                /* Reads the archive as it is stored */
+
+    DWORD               block;              /* Next block to read */
+    DWORD               blockOffset;        /* Offset of its header */
+    DWORD               decodedBlock;       /* Block held in 'decoded', DTA_NO_BLOCK if none */
+    unsigned char       *stored;            /* Stored bytes of a block, NULL until needed */
+    unsigned char       *decoded;           /* Decoded bytes of 'decodedBlock' */
+    BOOL                haveWavHeader;
+    unsigned char       wavHeader[DTA_WAV_HEADER_SIZE];
+} DTA_READER;
+
+/* No block decoded yet */
+#define DTA_NO_BLOCK        0xFFFFFFFF
+
+/*----------------------------------------------------------------------------
+ * Maps an archive into memory and reads its content table with the given
+ * keys. Entries that point outside of the archive are left out. If any
+ * errors occur, 'error' string is set and the function returns NULL.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  error           Error string
+ *
+ *  Returns the archive, which has to be closed with DtaCloseArchive.
+ *--------------------------------------------------------------------------*/
+DTA_ARCHIVE *DtaOpenArchive(const char *filename, unsigned int key1, unsigned int key2, char error[DTA_ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Like DtaOpenArchive, with the options in 'options'. NULL options behave
+ * like DtaOpenArchive.
+ *
+ * A 'viewSize' other than 0 maps the archive in windows of that many bytes
+ * instead of as a whole. With 0 the whole archive is mapped if there is
+ * room for it, and windows of DTA_DEFAULT_VIEW_SIZE are used otherwise.
+ *
+ * An 'indexFile' names a sidecar (see DTA_INDEX_EXTENSION). The entries are
+ * read from it if it still belongs to the archive, and it is written after
+ * they have been read from the archive otherwise.
+ *
+ *  Arguments:      filename        Path of the archive
+ *                  key1            First decryption key
+ *                  key2            Second decryption key
+ *                  options         Options of the open, or NULL
+ *                  error           Error string
+ *
+ *  Returns the archive, which has to be closed with DtaCloseArchive.
+ *--------------------------------------------------------------------------*/
+DTA_ARCHIVE *DtaOpenArchiveEx(const char *filename, unsigned int key1, unsigned int key2, const DTA_OPEN_OPTIONS *options,
+                              char error[DTA_ERROR_LENGTH]);
+
+/*----------------------------------------------------------------------------
+ * Unmaps the archive and releases everything that belongs to it. Readers
+ * and entry names of the archive can't be used afterwards.
+ *
+ *  Arguments:      archive         Archive to close
+ *--------------------------------------------------------------------------*/
+void DtaCloseArchive(DTA_ARCHIVE *archive);
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if 'header' describes a content table that fits inside an
+ * archive of 'archiveSize' bytes. A header decrypted with the wrong keys
+ * practically never does.
+ *
+ *  Arguments:      header          Decrypted header
+ *                  archiveSize     Size of the archive
+ *--------------------------------------------------------------------------*/
+BOOL DtaIsHeaderPlausible(const DTA_HEADER *header, DWORD archiveSize);
+
+/*----------------------------------------------------------------------------
+ * Returns the size of the archive file.
+ *
+ *  Arguments:      archive         Open archive
+ *--------------------------------------------------------------------------*/
+DWORD DtaGetArchiveSize(const DTA_ARCHIVE *archive);
+
+/*----------------------------------------------------------------------------
+ * Returns the number of entries in the archive.
+ *
+ *  Arguments:      archive         Open archive
+ *--------------------------------------------------------------------------*/
+DWORD DtaGetEntryCount(const DTA_ARCHIVE *archive);
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the entry 'index', counted in archive order. Returns
+ * FALSE if there is no such entry.
+ *
+ *  Arguments:      archive         Open archive
+ *                  index           Entry to return
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaGetEntry(const DTA_ARCHIVE *archive, DWORD index, DTA_ENTRY_INFO *info);
+
+/*----------------------------------------------------------------------------
+ * Starts a walk over every entry of the archive, in archive order.
+ *
+ *  Arguments:      archive         Open archive
+ *                  iterator        Iterator to set up
+ *--------------------------------------------------------------------------*/
+void DtaBeginEntries(const DTA_ARCHIVE *archive, DTA_ITERATOR *iterator);
+
+/*----------------------------------------------------------------------------
+ * Fills 'info' with the next entry of the walk. Returns FALSE once every
+ * entry has been returned.
+ *
+ *  Arguments:      iterator        Iterator set up by DtaBeginEntries
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaNextEntry(DTA_ITERATOR *iterator, DTA_ENTRY_INFO *info);
+
+/*----------------------------------------------------------------------------
+ * Looks up an entry by name, without regard to case. Returns FALSE if the
+ * archive has no such entry.
+ *
+ *  Arguments:      archive         Open archive
+ *                  name            Path inside the archive
+ *                  info            Receives the entry
+ *--------------------------------------------------------------------------*/
+BOOL DtaFindEntry(const DTA_ARCHIVE *archive, const char *name, DTA_ENTRY_INFO *info);
+
+/*----------------------------------------------------------------------------
+ * Reads and decrypts the file header of an entry, for the fields that
+ * DTA_ENTRY_INFO leaves out. Returns FALSE if it can't be read.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry whose header to read
+ *                  header          Receives the header
+ *--------------------------------------------------------------------------*/
+BOOL DtaGetFileHeader(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DTA_FILE_HEADER *header);
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' decoded bytes of an entry, starting at 'offset'
+ * inside of it, into 'buffer'. Doesn't keep any position, so it may be
+ * called from any thread. The blocks before 'offset' aren't decoded, but
+ * the one 'offset' falls into is decoded whole.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to read
+ *                  offset          Position inside the entry
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for if a block
+ *  runs past the end of the archive or is corrupt.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadEntry(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DWORD offset, void *buffer, DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes of the archive as they are on the disk,
+ * starting at 'offset', into 'buffer'. May be called from any thread.
+ *
+ *  Arguments:      archive         Open archive
+ *                  offset          Position inside the archive
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied.
+ *--------------------------------------------------------------------------*/
+DWORD DtaReadRaw(const DTA_ARCHIVE *archive, DWORD offset, void *buffer, DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Decodes a whole entry out of its stored bytes, which the caller copied
+ * with DtaReadRaw from 'info->dataOffset', at most 'info->storedSize' of
+ * them. This way the archive can be read by one thread and decoded by
+ * another. The stored bytes are decrypted in place. May be called from any
+ * thread.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to decode
+ *                  stored          Stored bytes of the entry
+ *                  storedSize      Number of stored bytes
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes decoded, fewer than the entry holds if a
+ *  block runs past 'storedSize' or is corrupt.
+ *--------------------------------------------------------------------------*/
+DWORD DtaDecodeEntry(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, void *stored, DWORD storedSize, void *buffer,
+                     DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Sets 'reader' up to read an entry from its first byte, decoded, or the
+ * whole raw archive if 'info' is NULL.
+ *
+ *  Arguments:      archive         Open archive
+ *                  info            Entry to read, or NULL
+ *                  reader          Reader to set up
+ *--------------------------------------------------------------------------*/
+void DtaOpenReader(const DTA_ARCHIVE *archive, const DTA_ENTRY_INFO *info, DTA_READER *reader);
+
+/*----------------------------------------------------------------------------
+ * Copies up to 'size' bytes from the position of 'reader' into 'buffer'
+ * and advances the position.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *                  buffer          Buffer owned by the caller
+ *                  size            Size of the buffer
+ *
+ *  Returns the number of bytes copied, fewer than asked for at the end of
+ *  the entry or if a block can't be decoded.
+ *--------------------------------------------------------------------------*/
+DWORD DtaRead(DTA_READER *reader, void *buffer, DWORD size);
+
+/*----------------------------------------------------------------------------
+ * Moves the position of 'reader'. Behaves like fseek, positions past the
+ * end are clamped to the end.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *                  offset          Relative offset from 'origin', negative
+ *                                  offsets are passed as a cast LONG
+ *                  origin          SEEK_SET, SEEK_CUR or SEEK_END
+ *--------------------------------------------------------------------------*/
+void DtaSeek(DTA_READER *reader, DWORD offset, DWORD origin);
+
+/*----------------------------------------------------------------------------
+ * Releases the buffers of 'reader'. It can be set up again afterwards.
+ *
+ *  Arguments:      reader          Reader set up by DtaOpenReader
+ *--------------------------------------------------------------------------*/
+void DtaCloseReader(DTA_READER *reader);
+
+/*----------------------------------------------------------------------------
+ * Asks the system to read a region of the archive into memory ahead of
+ * time. Does nothing before Windows 8, which lacks PrefetchVirtualMemory,
+ * or if the archive is mapped in windows.
+ *
+ *  Arguments:      archive         Open archive
+ *                  offset          Offset of the region
+ *                  size            Size of the region
+ *--------------------------------------------------------------------------*/
+void DtaPrefetch(const DTA_ARCHIVE *archive, DWORD offset, DWORD size);
+
+#endif
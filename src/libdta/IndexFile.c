@@ -0,0 +1,212 @@
+/*  Description:
+ *      Implementation of the sidecar of the entries. The sidecar is read into
+ *      memory as a whole; a new one is written to a temporary file first and
+ *      renamed over the old one, so an open that is interrupted never leaves
+ *      half a sidecar behind.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "IndexFile.h"
+
+/* Seed of the FNV-1a hashes */
+#define INDEX_HASH_SEED     2166136261u
+
+/*----------------------------------------------------------------------------
+ * Continues the FNV-1a hash 'hash' over 'n' bytes of 'data'.
+ *--------------------------------------------------------------------------*/
+static DWORD HashBytes(DWORD hash, const void *data, size_t n) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t              i;
+
+    for(i = 0; i < n; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * Fills the part of 'key' that identifies the archive open at 'hFile' with
+ * the decrypted content table 'contentHeaders'. The table has to be in the
+ * order it is stored in. Returns FALSE if the archive can't be queried.
+ *
+ *  Arguments:      key             Header to fill
+ *                  hFile           Open archive
+ *                  contentHeaders  Decrypted content table
+ *                  numOfFiles      Entries in the table
+ *--------------------------------------------------------------------------*/
+BOOL InitIndexKey(DTA_INDEX_HEADER *key, HANDLE hFile, const DTA_CONTENT_HEADER *contentHeaders, DWORD numOfFiles) {
+    LARGE_INTEGER   size;
+    FILETIME        lastWrite;
+
+    if(!GetFileSizeEx(hFile, &size) || !GetFileTime(hFile, NULL, NULL, &lastWrite))
+        return FALSE;
+
+    memset(key, 0, sizeof(DTA_INDEX_HEADER));
+
+    key->identifier         = DTA_INDEX_IDENTIFIER;
+    key->version            = DTA_INDEX_VERSION;
+    key->archiveSizeLow     = size.LowPart;
+    key->archiveSizeHigh    = size.HighPart;
+    key->archiveTime        = lastWrite;
+    key->numOfFiles         = numOfFiles;
+
+    /* The table is decrypted, so other keys give another hash as well */
+    key->tableHash = HashBytes(INDEX_HASH_SEED, contentHeaders, sizeof(DTA_CONTENT_HEADER) * numOfFiles);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Returns TRUE if the sidecar 'file' of 'size' bytes belongs to the archive
+ * described by 'key' and is intact.
+ *--------------------------------------------------------------------------*/
+static BOOL ValidateIndexFile(const char *file, unsigned __int64 size, const DTA_INDEX_HEADER *key) {
+    const DTA_INDEX_HEADER  *header = (const DTA_INDEX_HEADER *)file;
+    const DTA_RECORD        *records;
+    DWORD                   i;
+
+    /* Everything up to 'count' has to be the same */
+    if(memcmp(header, key, offsetof(DTA_INDEX_HEADER, count)) != 0)
+        return FALSE;
+
+    if(header->count > header->numOfFiles ||
+       size != sizeof(DTA_INDEX_HEADER) + (unsigned __int64)header->count * sizeof(DTA_RECORD) + header->namesSize)
+        return FALSE;
+
+    if(HashBytes(INDEX_HASH_SEED, file + sizeof(DTA_INDEX_HEADER), (size_t)(size - sizeof(DTA_INDEX_HEADER))) != header->checksum)
+        return FALSE;
+
+    /* Never hand out a name that runs past the end of the pool */
+    if(header->namesSize > 0 && file[size - 1] != '\0')
+        return FALSE;
+
+    records = (const DTA_RECORD *)(file + sizeof(DTA_INDEX_HEADER));
+
+    for(i = 0; i < header->count; ++i) {
+        if(records[i].nameOffset >= header->namesSize)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Reads the sidecar at 'path' into newly allocated records and names, if it
+ * belongs to the archive described by 'key' and is intact. Returns FALSE
+ * otherwise, in which case nothing is allocated.
+ *
+ *  Arguments:      path            Path of the sidecar
+ *                  key             Header filled by InitIndexKey
+ *                  records         Receives the records, released with free()
+ *                  count           Receives the number of records
+ *                  names           Receives the names, released with free()
+ *                  namesSize       Receives the size of the names
+ *--------------------------------------------------------------------------*/
+BOOL LoadIndexFile(const char *path, const DTA_INDEX_HEADER *key, DTA_RECORD **records, DWORD *count, char **names, DWORD *namesSize) {
+    const DTA_INDEX_HEADER  *header;
+    char                    *file;
+    HANDLE                  hFile;
+    LARGE_INTEGER           size;
+    DWORD                   read;
+
+    hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if(!GetFileSizeEx(hFile, &size) || size.QuadPart < sizeof(DTA_INDEX_HEADER) || size.QuadPart > 0x7FFFFFFF ||
+       (file = (char *)malloc((size_t)size.QuadPart)) == NULL) {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    if(!ReadFile(hFile, file, (DWORD)size.QuadPart, &read, NULL) || read != (DWORD)size.QuadPart ||
+       !ValidateIndexFile(file, size.QuadPart, key)) {
+        CloseHandle(hFile);
+        free(file);
+        return FALSE;
+    }
+
+    CloseHandle(hFile);
+    header = (const DTA_INDEX_HEADER *)file;
+
+    /* The archive frees both on its own, so they get allocations of their own */
+    *records    = (DTA_RECORD *)malloc(sizeof(DTA_RECORD) * header->count + 1);
+    *names      = (char *)malloc(header->namesSize + 1);
+
+    if(*records == NULL || *names == NULL) {
+        free(*records);
+        free(*names);
+        free(file);
+        return FALSE;
+    }
+
+    memcpy(*records, file + sizeof(DTA_INDEX_HEADER), sizeof(DTA_RECORD) * header->count);
+    memcpy(*names, file + sizeof(DTA_INDEX_HEADER) + sizeof(DTA_RECORD) * header->count, header->namesSize);
+
+    *count      = header->count;
+    *namesSize  = header->namesSize;
+
+    free(file);
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * Writes the records and names to the sidecar at 'path'. Failing to write
+ * it is not an error, the next open simply reads the entries again.
+ *
+ *  Arguments:      path            Path of the sidecar
+ *                  key             Header filled by InitIndexKey
+ *                  records         Records sorted by file offset
+ *                  count           Number of records
+ *                  names           Names the records point into
+ *                  namesSize       Size of the names
+ *
+ *  Returns TRUE if the sidecar was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SaveIndexFile(const char *path, const DTA_INDEX_HEADER *key, const DTA_RECORD *records, DWORD count, const char *names, DWORD namesSize) {
+    DTA_INDEX_HEADER    header      = *key;
+    char                tempPath[MAX_PATH];
+    HANDLE              hFile;
+    DWORD               written;
+    DWORD               recordsSize = sizeof(DTA_RECORD) * count;
+    int                 length;
+    BOOL                result;
+
+    length = _snprintf(tempPath, sizeof(tempPath) - 1, "%s.tmp", path);
+    tempPath[sizeof(tempPath) - 1] = '\0';
+
+    if(length < 0 || (size_t)length >= sizeof(tempPath) - 1)
+        return FALSE;
+
+    header.count        = count;
+    header.namesSize    = namesSize;
+    header.checksum     = HashBytes(INDEX_HASH_SEED, records, recordsSize);
+    header.checksum     = HashBytes(header.checksum, names, namesSize);
+
+    hFile = CreateFile(tempPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    result = WriteFile(hFile, &header, sizeof(header), &written, NULL) && written == sizeof(header) &&
+             WriteFile(hFile, records, recordsSize, &written, NULL) && written == recordsSize &&
+             WriteFile(hFile, names, namesSize, &written, NULL) && written == namesSize;
+
+    CloseHandle(hFile);
+
+    if(!result || !MoveFileEx(tempPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFile(tempPath);
+        return FALSE;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,107 @@
+/*  Description:
+ *      Sidecar of the entries of an archive. Opening an archive reads the
+ *      header and filename of every entry, and those are spread over the
+ *      whole file. The sidecar keeps what was read, usually next to the
+ *      archive as "<archive>.dtaidx", so that a later open only reads the
+ *      content table and the sidecar.
+ *
+ *      The sidecar is only used if the size and modification time of the
+ *      archive and a hash of its decrypted content table still match, and if
+ *      its own checksum is right. Otherwise the entries are read from the
+ *      archive and the sidecar is written again.
+ *
+ *      Layout of a sidecar:
+ *
+ *          DTA_INDEX_HEADER
+ *          DTA_RECORD[count]   Sorted by file offset
+ *          char[namesSize]     Zero-terminated names
+ *
+ *      This header is private to libdta.
+ *
+ *  Author: Jovan Stanojlovic
+ */
+#ifndef INDEX_FILE_H_
+#define INDEX_FILE_H_
+
+#include <windows.h>
+#include "DTAFormat.h"
+
+/* The 4-byte sequence that a sidecar begins with */
+#define DTA_INDEX_IDENTIFIER    (('D') + ('I' << 8) + ('D' << 16) + ('X' << 24))
+
+/* Bumped whenever DTA_RECORD or the header changes */
+#define DTA_INDEX_VERSION       4
+
+/*
+ * A single entry. The name is stored in the names pool.
+ */
+typedef struct t_dtarecord {
+    DWORD   fileOffset;
+    DWORD   dataOffset;
+    DWORD   fileSize;
+    DWORD   nameOffset;
+    DWORD   storedSize;         /* Bytes from 'dataOffset' up to the next entry */
+    DWORD   numOfBlocks;
+    DWORD   flags;              /* DTA_FILE_ENCRYPTED */
+} DTA_RECORD;
+
+/*
+ * Header of a sidecar. Everything up to 'count' identifies the archive the
+ * entries belong to.
+ */
+typedef struct t_dtaindexheader {
+    DWORD       identifier;
+    DWORD       version;
+    DWORD       archiveSizeLow;
+    DWORD       archiveSizeHigh;
+    FILETIME    archiveTime;
+    DWORD       tableHash;          /* Hash of the decrypted content table */
+    DWORD       numOfFiles;         /* Entries in the content table */
+    DWORD       count;              /* Entries in the sidecar */
+    DWORD       namesSize;
+    DWORD       checksum;           /* Hash of everything after the header */
+    DWORD       reserved;
+} DTA_INDEX_HEADER;
+
+/*----------------------------------------------------------------------------
+ * Fills the part of 'key' that identifies the archive open at 'hFile' with
+ * the decrypted content table 'contentHeaders'. The table has to be in the
+ * order it is stored in. Returns FALSE if the archive can't be queried.
+ *
+ *  Arguments:      key             Header to fill
+ *                  hFile           Open archive
+ *                  contentHeaders  Decrypted content table
+ *                  numOfFiles      Entries in the table
+ *--------------------------------------------------------------------------*/
+BOOL InitIndexKey(DTA_INDEX_HEADER *key, HANDLE hFile, const DTA_CONTENT_HEADER *contentHeaders, DWORD numOfFiles);
+
+/*----------------------------------------------------------------------------
+ * Reads the sidecar at 'path' into newly allocated records and names, if it
+ * belongs to the archive described by 'key' and is intact. Returns FALSE
+ * otherwise, in which case nothing is allocated.
+ *
+ *  Arguments:      path            Path of the sidecar
+ *                  key             Header filled by InitIndexKey
+ *                  records         Receives the records, released with free()
+ *                  count           Receives the number of records
+ *                  names           Receives the names, released with free()
+ *                  namesSize       Receives the size of the names
+ *--------------------------------------------------------------------------*/
+BOOL LoadIndexFile(const char *path, const DTA_INDEX_HEADER *key, DTA_RECORD **records, DWORD *count, char **names, DWORD *namesSize);
+
+/*----------------------------------------------------------------------------
+ * Writes the records and names to the sidecar at 'path'. Failing to write
+ * it is not an error, the next open simply reads the entries again.
+ *
+ *  Arguments:      path            Path of the sidecar
+ *                  key             Header filled by InitIndexKey
+ *                  records         Records sorted by file offset
+ *                  count           Number of records
+ *                  names           Names the records point into
+ *                  namesSize       Size of the names
+ *
+ *  Returns TRUE if the sidecar was written, FALSE otherwise.
+ *--------------------------------------------------------------------------*/
+BOOL SaveIndexFile(const char *path, const DTA_INDEX_HEADER *key, const DTA_RECORD *records, DWORD count, const char *names, DWORD namesSize);
+
+#endif